@@ -32,11 +32,21 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 #include "G4Types.hh"
 
+#include "G4Version.hh"
+
 #ifdef G4MULTITHREADED
 #include "G4MTRunManager.hh"
+#if G4VERSION_NUMBER >= 1070
+#include "G4TaskRunManager.hh"
+#endif
+#include "RunManager.hh"
+#include "ThreadPolicy.hh"
 #else
 #include "G4RunManager.hh"
+#include "CampaignRunManager.hh"
 #endif
+#include "Campaign.hh"
+#include "CampaignMerger.hh"
 
 #include "G4UImanager.hh"
 #include "Randomize.hh"
@@ -45,31 +55,139 @@
 #include "PhysicsList.hh"
 #include "ActionInitialization.hh"
 #include "SteppingVerbose.hh"
+#include "RandomStreams.hh"
+#include "Checkpoint.hh"
+#include "Convergence.hh"
+#include "SlowEvents.hh"
+#include "Watchdog.hh"
+#include "Telemetry.hh"
+#include "Records.hh"
+#include "StreamSink.hh"
+#include "SparseScoring.hh"
+#include "FluenceTally.hh"
+#include "MeshTally.hh"
+#include "PointDetector.hh"
 
 #include "G4UIExecutive.hh"
 #include "G4VisExecutive.hh"
 
+#include <cstdlib>
+#include <vector>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 int main(int argc,char** argv) {
 
-  //detect interactive mode (if no arguments) and define UI session
+  //command line: Hadr04 [-t nThreads] [-r tasks|mt] [-j nProcesses] 
+  //                      [-o campaignDir] [macro]
+  //               Hadr04 -m campaignDir [-hadd] (merge a campaign)
+  //  (-k index/nProcesses is given by the campaign to its processes)
+  G4String macro;
+  G4int nThreads = 0;
+  G4String runType = "tasks";
+  G4int nProcesses = 0, processIndex = -1;
+  G4String campaignDir = "campaign", mergeDir;
+  G4bool useHadd = false;
+  std::vector<G4String> arguments(1, argv[0]);
+  for (G4int i=1; i<argc; ++i) {
+    G4String arg = argv[i];
+    if      (arg == "-j" && i+1 < argc) nProcesses = atoi(argv[++i]);
+    else if (arg == "-o" && i+1 < argc) campaignDir = argv[++i];
+    else if (arg == "-m" && i+1 < argc) mergeDir = argv[++i];
+    else if (arg == "-hadd") useHadd = true;
+    else if (arg == "-k" && i+1 < argc) {
+      G4String process = argv[++i];
+      processIndex = atoi(process.c_str());
+      nProcesses = atoi(process.substr(process.find('/')+1).c_str());
+    }
+    else {
+      arguments.push_back(arg);
+      if      (arg == "-t" && i+1 < argc) nThreads = atoi(argv[i+1]);
+      else if (arg == "-r" && i+1 < argc) runType = argv[i+1];
+      else { macro = arg; continue; }
+      arguments.push_back(argv[++i]);
+    }
+  }
+  
+  //merge the outputs of a campaign
+  if (!mergeDir.empty()) {
+    CampaignMerger merger(mergeDir);
+    merger.SetUseHadd(useHadd);
+    return merger.Merge(nThreads > 0 ? nThreads : 4) ? 0 : 1;
+  }
+  
+  //launch a campaign of local processes, each running this application
+  Campaign* campaign = Campaign::Instance();
+  if (nProcesses > 0 && processIndex < 0) {
+    if (macro.empty()) {
+      G4cerr << "### a campaign (-j) needs a macro" << G4endl;
+      return 1;
+    }
+    return campaign->Launch(nProcesses, campaignDir, arguments);
+  }
+  if (processIndex >= 0) {
+    campaign->SetProcess(processIndex, nProcesses, campaignDir);
+  }
+
+  //detect interactive mode (if no macro) and define UI session
   G4UIExecutive* ui = nullptr;
-  if (argc == 1) ui = new G4UIExecutive(argc,argv);
+  if (macro.empty()) ui = new G4UIExecutive(argc,argv);
 
   //choose the Random engine
+  //(replaced in each event by a counter-based stream with
+  // /testhadr/random/engine philox)
   G4Random::setTheEngine(new CLHEP::RanecuEngine);
 
   //construct the default run manager
 #ifdef G4MULTITHREADED
-  G4MTRunManager* runManager = new G4MTRunManager;
-  runManager->SetNumberOfThreads(G4Threading::G4GetNumberOfCores());
+  G4MTRunManager* runManager = nullptr;
+#if G4VERSION_NUMBER >= 1070
+  if (runType == "tasks") runManager = new RunManager<G4TaskRunManager>;
+#endif
+  if (!runManager) runManager = new RunManager<G4MTRunManager>;
+  runManager->SetNumberOfThreads(ThreadPolicy::GetNumberOfThreads(nThreads));
 #else
   //my Verbose output class
   G4VSteppingVerbose::SetInstance(new SteppingVerbose);
-  G4RunManager* runManager = new G4RunManager;
+  G4RunManager* runManager = new CampaignRunManager<G4RunManager>;
 #endif
 
+  //per-event random streams, and their commands
+  RandomStreams::Instance();
+  
+  //checkpoints of long runs, and their commands
+  Checkpoint::Instance();
+  
+  //tally statistics and adaptive runs, and their commands
+  Convergence::Instance();
+  
+  //slowest events and their replay
+  SlowEvents::Instance();
+  
+  //step and time budgets of the tracks and events
+  Watchdog::Instance();
+  
+  //live telemetry files
+  Telemetry::Instance();
+  
+  //columnar files of crossing and capture records
+  Records::Instance();
+  
+  //live stream of records and histograms to a local consumer
+  StreamSink::Instance();
+  
+  //sparse high resolution maps of the test planes
+  SparseScoring::Instance();
+  
+  //track length fluence in cells
+  FluenceTally::Instance();
+  
+  //sparse mesh tallies of the fluence and captures
+  MeshTally::Instance();
+  
+  //next event estimator of the flux at points
+  PointDetector::Instance();
+
   //set mandatory initialization classes
   DetectorConstruction* det= new DetectorConstruction;
   runManager->SetUserInitialization(det);
@@ -94,8 +212,7 @@ int main(int argc,char** argv) {
   else  {
    //batch mode
    G4String command = "/control/execute ";
-   G4String fileName = argv[1];
-   UImanager->ApplyCommand(command+fileName);
+   UImanager->ApplyCommand(command+macro);
   }
 
   //job terminations
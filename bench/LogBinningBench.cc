@@ -0,0 +1,121 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file LogBinningBench.cc
+/// \brief Timing of LogBinning against the search of the bin edges
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//
+// Built with -DHADR04_BENCHMARKS=ON:
+//   LogBinningBench [nbBins] [nbValues]
+// Bins of equal width in log(E) from 1e-11 to 10 MeV; energies drawn 
+// uniformly in log(E) over a wider range. Compares, per value:
+//   - LogBinning::Index and the binary search of the edges,
+//   - LogHisto::Fill and the fill of a tools h1d of the same edges.
+
+#include "LogBinning.hh"
+#include "LogHisto.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  template <class F> G4double NanosecondsPerValue(F function, size_t nbValues)
+  {
+    std::chrono::steady_clock::time_point start 
+      = std::chrono::steady_clock::now();
+    function();
+    std::chrono::duration<G4double, std::nano> elapsed 
+      = std::chrono::steady_clock::now() - start;
+    return elapsed.count()/nbValues;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  G4int  nbBins   = (argc > 1) ? atoi(argv[1]) : 600;
+  size_t nbValues = (argc > 2) ? atol(argv[2]) : 20000000;
+  
+  const G4double emin = 1.e-11, emax = 10.;
+  std::vector<G4double> edges;
+  for (G4int i=0; i<=nbBins; ++i) {
+    edges.push_back(std::pow(10., std::log10(emin) 
+                      + i*(std::log10(emax) - std::log10(emin))/nbBins));
+  }
+  LogBinning binning;
+  if (!binning.Set(edges)) {
+    printf("%d bins: too narrow for LogBinning\n", nbBins);
+    return 1;
+  }
+  
+  std::mt19937_64 engine(12345);
+  std::uniform_real_distribution<G4double> flat(-12., 2.);
+  std::vector<G4double> values(nbValues);
+  for (size_t i=0; i<nbValues; ++i) values[i] = std::pow(10., flat(engine));
+  
+  // bin index alone; both must agree
+  size_t mismatches = 0;
+  for (size_t i=0; i<nbValues; ++i) {
+    mismatches += (binning.Index(values[i]) != binning.SearchIndex(values[i]));
+  }
+  long long sum = 0;
+  G4double search = NanosecondsPerValue([&]() {
+      for (size_t i=0; i<nbValues; ++i) sum += binning.SearchIndex(values[i]);
+    }, nbValues);
+  G4double bits = NanosecondsPerValue([&]() {
+      for (size_t i=0; i<nbValues; ++i) sum += binning.Index(values[i]);
+    }, nbValues);
+  
+  // full fills
+  tools::histo::h1d h1("bench", edges);
+  LogHisto logHisto;
+  logHisto.Set(h1, 1., false);
+  G4double h1Fill = NanosecondsPerValue([&]() {
+      for (size_t i=0; i<nbValues; ++i) h1.fill(values[i], 1.);
+    }, nbValues);
+  G4double logFill = NanosecondsPerValue([&]() {
+      for (size_t i=0; i<nbValues; ++i) logHisto.Fill(values[i], 1.);
+    }, nbValues);
+  
+  printf("%d bins, %zu values, %zu mismatches (checksum %lld)\n", 
+         nbBins, nbValues, mismatches, sum);
+  printf("  index: search %6.2f ns   bits %6.2f ns   x%.1f\n", 
+         search, bits, search/bits);
+  printf("  fill:  h1d    %6.2f ns   LogHisto %6.2f ns   x%.1f\n", 
+         h1Fill, logFill, h1Fill/logFill);
+  return mismatches ? 1 : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,85 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ArgonCaptureCascade.hh
+/// \brief Definition of the ArgonCaptureCascade class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ArgonCaptureCascade_h
+#define ArgonCaptureCascade_h 1
+
+#include "globals.hh"
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Library of the complete gamma cascades of Ar-41 after neutron capture.
+/// The level scheme is read from a text file (see argon41.cascade); every
+/// path from the capture state to the ground state is enumerated once,
+/// with its probability, and an alias table over the paths gives the
+/// sampling of a full, energy-conserving cascade in O(1).
+
+class ArgonCaptureCascade
+{
+  public:
+    static ArgonCaptureCascade* Instance();
+   ~ArgonCaptureCascade();
+
+  public:
+    G4bool Load(const G4String& fileName);
+    G4bool IsLoaded() const { return !fPaths.empty(); };
+
+    G4double GetSeparationEnergy() const { return fSeparationEnergy; };
+    G4int    GetNbPaths() const { return (G4int)fPaths.size(); };
+
+    // gamma energies of a sampled cascade, primary transition first;
+    // the two random numbers are uniform in [0,1)
+    const std::vector<G4double>& Sample(G4double r1, G4double r2) const;
+
+  private:
+    ArgonCaptureCascade();
+    void Enumerate(G4int level, G4double probability,
+                   std::vector<G4double>& gammas);
+    void BuildAliasTable(const std::vector<G4double>& probabilities);
+
+  private:
+    struct Branch { G4int fTo; G4double fIntensity; };
+
+    G4double                           fSeparationEnergy;
+    std::vector<G4double>              fLevelEnergy;    // [level]
+    std::vector< std::vector<Branch> > fBranches;       // [level+1], 0=capture
+
+    std::vector< std::vector<G4double> > fPaths;        // gamma energies
+    std::vector<G4double>                fPathProbability;
+    std::vector<G4double>                fAliasProbability;
+    std::vector<G4int>                   fAlias;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,69 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ArgonCaptureModel.hh
+/// \brief Definition of the ArgonCaptureModel class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ArgonCaptureModel_h
+#define ArgonCaptureModel_h 1
+
+#include "globals.hh"
+#include "G4HadronicInteraction.hh"
+
+class G4ParticleHPCapture;
+class ArgonCaptureCascade;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Neutron capture final state: on Ar-40, a complete gamma cascade of Ar-41
+/// is drawn from ArgonCaptureCascade (the kinetic energy of the neutron in
+/// the centre of mass goes to the primary gamma, the Ar-41 recoil takes
+/// the momentum balance); on any other target, G4ParticleHPCapture is used.
+
+class ArgonCaptureModel : public G4HadronicInteraction
+{
+  public:
+    ArgonCaptureModel(const G4String& cascadeFile);
+   ~ArgonCaptureModel();
+
+  public:
+    virtual G4HadFinalState* ApplyYourself(const G4HadProjectile&, G4Nucleus&);
+    virtual void BuildPhysicsTable(const G4ParticleDefinition&);
+    virtual const std::pair<G4double, G4double> GetFatalEnergyCheckLevels() const;
+    virtual void ModelDescription(std::ostream&) const;
+
+  private:
+    G4ParticleHPCapture* fHPCapture;
+    ArgonCaptureCascade* fCascade;
+    G4String             fFileName;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
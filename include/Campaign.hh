@@ -0,0 +1,89 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Campaign.hh
+/// \brief Definition of the Campaign class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef Campaign_h
+#define Campaign_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Campaign of N local processes, without batch scheduler:
+///   Hadr04 -j N [-o dir] [-t nThreads] macro
+/// forks N copies of the application, each with its own log file, waits
+/// for them and merges their outputs with CampaignMerger.
+///
+/// Each /run/beamOn of the macro is split between the processes: process
+/// k runs events [k*n/N, (k+1)*n/N) on the counter-based random streams,
+/// so that the campaign reproduces a single process of n events. Its 
+/// analysis file and its run summary are written in the campaign 
+/// directory, with the suffix _p<k>.
+
+class Campaign
+{
+  public:
+    static Campaign* Instance();
+   ~Campaign();
+
+  public:
+    // parent: run the campaign, return the exit code of the application
+    G4int Launch(G4int nbProcesses, const G4String& directory,
+                 const std::vector<G4String>& arguments);
+
+    // process of a campaign, from the command line -k index/nbProcesses
+    void   SetProcess(G4int index, G4int nbProcesses, const G4String& dir);
+    G4bool IsProcess() const   { return fNbProcesses > 0; };
+    G4int  GetIndex() const    { return fIndex; };
+
+    // share of a beamOn of nbEvents for this process
+    G4int BeginOfRun(G4int nbEvents);
+    void  EndOfRun(G4int nbEvents);
+
+    // dir/stem_p<k>.ext for the file name stem.ext (ext by default if none)
+    G4String OutputName(const G4String& name, const G4String& ext) const;
+
+  private:
+    Campaign();
+
+  private:
+    G4int    fIndex;
+    G4int    fNbProcesses;      // 0 outside a campaign
+    G4String fDirectory;
+    uint64_t fFirstEvent;       // stream index of the first event of the run
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,103 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file CampaignMerger.hh
+/// \brief Definition of the CampaignMerger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef CampaignMerger_h
+#define CampaignMerger_h 1
+
+#include "globals.hh"
+
+#include <map>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Merges the outputs of the processes of a campaign directory:
+///   - the run summaries stem_p<k>.summary into stem.summary, read and
+///     summed by several threads, then printed as at the end of a run;
+///   - the histograms (h1, h2) of the analysis files stem_p<k>[_t<i>].root
+///     into stem.root, read and summed with the tools of Geant4 analysis;
+///     ntuples stay in the process files, to be chained, unless ROOT's 
+///     parallel hadd is selected (Hadr04 -m dir -hadd), which merges all;
+///   - the meshes stem_p<k>.h04v into stem.h04v, block by block (see 
+///     SparseMesh);
+///   - the raw sums of the sparse maps stem_p<k>.h04h into stem.h04h, bin
+///     by bin (see SparseH2), written again as stem.coo and/or .dense;
+///   - the raw sums of the spectra of the cells and of the point 
+///     detectors stem_p<k>.h04s into stem.h04s, entry by entry (see 
+///     TallySums), written again as stem.txt;
+///   - the record files listed in the manifests stem_p<k>.h04m into 
+///     stem_<table>.h04c (see RecordMerger).
+/// Also available alone, as Hadr04 -m dir.
+
+class CampaignMerger
+{
+  public:
+    CampaignMerger(const G4String& directory);
+   ~CampaignMerger();
+
+  public:
+    G4bool Merge(G4int nbThreads);
+    
+    void SetUseHadd(G4bool flag) { fUseHadd = flag; };
+
+  private:
+    void   Scan();
+    G4bool MergeSummaries(const G4String& output, 
+                          const std::vector<G4String>& files,
+                          G4int nbThreads);
+    G4bool MergeRootFiles(const G4String& output, 
+                          const std::vector<G4String>& files,
+                          G4int nbThreads);
+    G4bool MergeWithHadd(const G4String& output, 
+                         const std::vector<G4String>& files,
+                         G4int nbThreads);
+    G4bool MergeMeshes(const G4String& output, 
+                       const std::vector<G4String>& files);
+    G4bool MergeSparseMaps(const G4String& output, 
+                           const std::vector<G4String>& files);
+    G4bool MergeTallies(const G4String& output, 
+                        const std::vector<G4String>& files);
+
+  private:
+    G4String                                  fDirectory;
+    G4bool                                    fUseHadd;
+    std::map<G4String,std::vector<G4String> > fSummaries;  // per stem
+    std::map<G4String,std::vector<G4String> > fRootFiles;  // per stem
+    std::map<G4String,std::vector<G4String> > fManifests;  // per stem
+    std::map<G4String,std::vector<G4String> > fMeshes;     // per stem
+    std::map<G4String,std::vector<G4String> > fTallies;    // per stem
+    std::map<G4String,std::vector<G4String> > fSparseMaps; // per stem
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,67 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file CampaignRunManager.hh
+/// \brief Definition of the CampaignRunManager class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef CampaignRunManager_h
+#define CampaignRunManager_h 1
+
+#include "globals.hh"
+#include "Campaign.hh"
+#include "Checkpoint.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Run manager TBase whose BeamOn, in a process of a campaign, runs only
+/// the share of the events of this process (see Campaign), or, when a
+/// run is resumed, the events missing from its checkpoint (see Checkpoint).
+
+template <class TBase>
+class CampaignRunManager : public TBase
+{
+  public:
+    CampaignRunManager() : TBase() {};
+   ~CampaignRunManager() {};
+
+  public:
+    virtual void BeamOn(G4int nEvents, const char* macroFile = 0, 
+                        G4int nSelect = -1)
+    {
+      Campaign* campaign = Campaign::Instance();
+      G4int share = campaign->BeginOfRun(nEvents);
+      share = Checkpoint::Instance()->BeginOfRun(share);
+      TBase::BeamOn(share, macroFile, nSelect);
+      campaign->EndOfRun(nEvents);
+    };
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,139 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Checkpoint.hh
+/// \brief Definition of the Checkpoint class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef Checkpoint_h
+#define Checkpoint_h 1
+
+#include "globals.hh"
+#include "RunSummary.hh"
+#include "g4root.hh"
+
+#include <cstdint>
+#include <vector>
+
+class CheckpointMessenger;
+class Run;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Periodic checkpoints of a run, and resumption of the run after the 
+/// job was stopped.
+///
+/// Every N events or T minutes, each thread saves atomically in the 
+/// checkpoint directory the state of its own events: the random streams
+/// of the events it completed (counter-based streams are required: an 
+/// event's random state is its stream index), its Run counters, its 
+/// histograms and the number of rows it added to each ntuple. The union
+/// of the latest files of all threads is a consistent state of the run,
+/// whatever the moment each one was written.
+///
+/// /testhadr/checkpoint/resume makes the next /run/beamOn (the same one
+/// as the interrupted run) process only the events missing from the 
+/// checkpoint. The restored counters and histograms are added to those 
+/// of the new events at the end of the run. Ntuple rows cannot be added
+/// to a ROOT file after the fact: the resumed session writes its analysis
+/// files with the suffix _resume<n>, and the summary lists, for each file
+/// of the earlier sessions, the number of leading rows of each ntuple 
+/// that belong to checkpointed events.
+///
+/// Files of a checkpoint carry a generation: at each resumption the state
+/// is consolidated in ckpt_base.dat, which supersedes the thread files of
+/// the earlier generations.
+
+class Checkpoint
+{
+  public:
+    static Checkpoint* Instance();
+   ~Checkpoint();
+
+  public:
+    void SetDirectory(const G4String& dir)  { fDirectory = dir; };
+    void SetEveryEvents(G4int n)            { fEveryEvents = n; };
+    void SetEveryMinutes(G4double minutes)  { fEveryMinutes = minutes; };
+    void RequestResume()                    { fResumeRequested = true; };
+    
+    // master: number of events to process for a beamOn of nbEvents
+    G4int BeginOfRun(G4int nbEvents);
+    // master: add the restored state to the run, remove the checkpoint
+    void  EndOfRun(Run*);
+    // analysis file name of a resumed session
+    G4String OutputName(const G4String& name) const;
+    
+    // event loop threads
+    void BeginOfThreadRun();
+    void EndOfEvent(G4int eventID);
+
+  private:
+    Checkpoint();
+    
+    // state of the files of a checkpoint
+    struct NtupleLog {
+      G4String           fFile;
+      G4int              fThread;
+      std::vector<G4int> fRows;
+    };
+    struct State {
+      uint64_t               fSeed, fFirst, fNbEvents, fGeneration;
+      std::vector<uint64_t>  fDone;
+      RunSummary             fSummary;
+      std::vector<NtupleLog> fNtuples;
+      std::vector<tools::histo::h1d*> fH1;
+      std::vector<tools::histo::h2d*> fH2;
+    };
+    
+    G4bool   SaveThread(Run*);
+    G4bool   Write(const G4String& fileName, const State&, G4int thread) const;
+    G4bool   Read(const G4String& fileName, State&, G4int& thread) const;
+    G4bool   Load(State&);
+    void     NewHistograms(State&) const;
+    void     ClearState(State&) const;
+    void     RemoveFiles() const;
+    G4String FileName(G4int thread) const;
+
+  private:
+    G4String fDirectory;
+    G4int    fEveryEvents;
+    G4double fEveryMinutes;
+    G4bool   fResumeRequested;
+    
+    // current run
+    G4bool   fActive;
+    G4String fRunDirectory;
+    G4int    fSession;
+    State    fRestored;
+    
+    CheckpointMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,99 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ColumnarReader.hh
+/// \brief Definition of the ColumnarReader class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ColumnarReader_h
+#define ColumnarReader_h 1
+
+#include "globals.hh"
+#include "ColumnarWriter.hh"
+
+#include <cstdint>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Memory-mapped reader of a file of ColumnarWriter. The index is read 
+/// from the footer; a stored block is read in place, without copy, and
+/// only the blocks of the columns asked for are touched.
+///
+/// Zero-copy applies to the stored blocks only (/testhadr/records/
+/// compression none, the default): ReadBlock returns them in place, block
+/// by block. ReadColumn returns a whole column in place only when it is a
+/// single stored block (chunkRows at least the number of rows, no shards 
+/// merged); otherwise its blocks are copied or decoded into the buffer.
+
+class ColumnarReader
+{
+  public:
+    typedef ColumnarWriter::Block Block;
+    
+    ColumnarReader();
+   ~ColumnarReader();
+
+  public:
+    G4bool Open(const G4String& fileName);
+    void   Close();
+    
+    const G4String& GetTableName() const    { return fTableName; };
+    G4int    GetNbColumns() const           { return fColumnNames.size(); };
+    const G4String& GetColumnName(G4int i) const { return fColumnNames[i]; };
+    G4int    GetColumnType(G4int i) const   { return fColumnTypes[i]; };
+    G4int    FindColumn(const G4String& name) const;
+    uint64_t GetNbRows() const              { return fNbRows; };
+    
+    // blocks in file order; the data of a stored block are its values
+    const std::vector<Block>& GetBlocks() const { return fBlocks; };
+    const char* GetBlockData(const Block& block) const 
+                                    { return fData + block.fOffset; };
+    
+    // the values of a block: in place if stored, else decoded into 
+    // buffer; 0 on error
+    const char* ReadBlock(const Block&, std::vector<char>& buffer) const;
+    // all the values of a column: in place if it has a single stored 
+    // block, else decoded into buffer; 0 on error
+    const char* ReadColumn(G4int column, std::vector<char>& buffer) const;
+    G4bool      DecodeBlock(const Block&, char* values) const;
+
+  private:
+    G4String              fFileName;
+    const char*           fData;
+    size_t                fSize;
+    G4String              fTableName;
+    std::vector<G4String> fColumnNames;
+    std::vector<G4int>    fColumnTypes;
+    uint64_t              fNbRows;
+    std::vector<Block>    fBlocks;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,125 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ColumnarWriter.hh
+/// \brief Definition of the ColumnarWriter class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ColumnarWriter_h
+#define ColumnarWriter_h 1
+
+#include "globals.hh"
+#include "RecordChunk.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Columnar binary file of one record table (little endian):
+///
+///   header  "H04COL01", u32 header size, u32 table name length, name,
+///           u32 number of columns, then per column: u8 type, u8 name 
+///           length, name; padded to 64 bytes
+///   blocks  one block per column and per chunk of rows, each starting on
+///           a 64-byte boundary
+///   footer  u64 number of blocks, then per block: u32 column, u32 codec,
+///           u64 first row, u64 rows, u64 offset, u64 stored size, 
+///           u64 raw size; then u64 total rows, u64 footer offset, 
+///           "H04COLIX"
+///
+/// A block of codec kStored holds the values as such: the file can be
+/// memory-mapped and a column read in place (see ColumnarReader). A block
+/// of codec kZlib holds the bytes of the values shuffled (all first bytes,
+/// then all second bytes, ...) and deflated; it is stored as such when 
+/// deflating does not make it smaller. zlib is used when the application 
+/// was built with it (HADR04_USE_ZLIB).
+
+class ColumnarWriter
+{
+  public:
+    enum ECodec { kStored = 0, kZlib = 1 };
+    
+    struct Block {
+      uint32_t fColumn;
+      uint32_t fCodec;
+      uint64_t fFirstRow;
+      uint64_t fNbRows;
+      uint64_t fOffset;
+      uint64_t fStoredSize;
+      uint64_t fRawSize;
+    };
+    
+    static const char kMagic[9];
+    static const char kIndexMagic[9];
+    static const uint64_t kAlignment = 64;
+    
+    static G4bool HasZlib();
+
+  public:
+    ColumnarWriter();
+   ~ColumnarWriter();
+
+  public:
+    G4bool Open(const G4String& fileName, G4int table, G4int codec);
+    G4bool Write(const RecordChunk&);
+    // a block already encoded, e.g. copied from another file
+    G4bool WriteBlock(const Block&, const char* data);
+    // room for such a block, its data to be written at offset by the 
+    // caller (pwrite on GetDescriptor, after Flush), e.g. in parallel
+    G4bool Reserve(const Block&, uint64_t& offset);
+    // blocks written so far handed to the system (the footer is not)
+    G4bool Flush();
+    G4bool Close();
+    
+    G4bool   IsOpen() const        { return fFile != 0; };
+    uint64_t GetNbRows() const     { return fNbRows; };
+    uint64_t GetFileSize() const   { return fOffset; };
+    const G4String& GetFileName() const { return fFileName; };
+    G4int    GetDescriptor() const;
+
+  private:
+    G4bool WriteBytes(const void* data, size_t size);
+    G4bool Pad();
+    size_t Encode(const std::vector<char>& raw, size_t typeSize);
+
+  private:
+    G4String           fFileName;
+    std::FILE*         fFile;
+    G4int              fTable;
+    G4int              fCodec;
+    uint64_t           fOffset;
+    uint64_t           fNbRows;
+    std::vector<Block> fBlocks;
+    std::vector<char>  fShuffled, fEncoded;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
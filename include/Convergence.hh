@@ -0,0 +1,126 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Convergence.hh
+/// \brief Definition of the Convergence class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef Convergence_h
+#define Convergence_h 1
+
+#include "globals.hh"
+#include "G4Threading.hh"
+
+#include <atomic>
+
+class ConvergenceMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Statistics of the key tallies of the setup, scored once per event:
+/// sum and sum of squares of the event scores, and batch means over 
+/// batches of consecutive events of a thread. The relative error R of a
+/// tally is estimated from the spread of its batch means, and its figure
+/// of merit is 1/(R^2 T), T the wall time of the run.
+///
+/// With a target relative error on at least one tally, or a time budget,
+/// /run/beamOn n becomes a run of at most n events: the run manager stops 
+/// dispatching events as soon as every selected tally has reached its 
+/// target (with at least kMinBatches batches), or the time is over.
+
+class Convergence
+{
+  public:
+    enum Tally { kCollimatorExit, kShieldExit, kArgonEntry, kCryostatExit,
+                 kArgonCapture, kNbTallies };
+    
+    static const G4int kMinBatches = 10;
+
+  public:
+    static Convergence* Instance();
+   ~Convergence();
+
+  public:
+    static const char* GetTallyName(G4int tally);
+    static G4int       FindTally(const G4String& name);
+    
+    void SetTarget(G4int tally, G4double relError) 
+                                      { fTarget[tally] = relError; };
+    void ClearTargets();
+    void SetTimeBudget(G4double minutes)    { fTimeBudget = minutes; };
+    void SetBatchSize(G4int n)              { fBatchSize = n; };
+    
+    // master
+    void BeginOfRun();
+    void EndOfRun();
+    
+    // event loop threads
+    void EndOfEvent(const G4double scores[kNbTallies]);
+    void EndOfThreadRun();
+    
+    // relative error of a tally from the batch means so far, -1 if none
+    G4double GetRelError(G4int tally);
+    
+    // no more events to dispatch
+    G4bool IsDone() const { return fDone.load(std::memory_order_relaxed); };
+    
+  private:
+    Convergence();
+    
+    // accumulators of a tally
+    struct Sums {
+      Sums() : fSum(0.), fSum2(0.), fBatchSum(0.), fBatchSum2(0.) {}
+      G4double fSum, fSum2;             // event scores
+      G4double fBatchSum, fBatchSum2;   // batch means
+    };
+    
+    void     Flush(G4bool batchDone);
+    G4bool   CheckDone() const;
+    G4double EventRelError(const Sums&) const;
+    G4double BatchRelError(const Sums&) const;
+    
+  private:
+    G4double fTarget[kNbTallies];       // 0: not selected
+    G4double fTimeBudget;               // minutes, 0: none
+    G4int    fBatchSize;
+    
+    // whole run, under fMutex
+    Sums     fSums[kNbTallies];
+    G4long   fNbEvents;
+    G4long   fNbBatches;
+    G4double fStart;
+    G4bool   fOverTime;
+    G4Mutex  fMutex;
+    std::atomic<G4bool> fDone;
+    
+    ConvergenceMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
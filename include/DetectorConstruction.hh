@@ -40,6 +40,7 @@
 
 class G4LogicalVolume;
 class G4Material;
+class G4Region;
 class DetectorMessenger;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -59,6 +60,8 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     MaterialWithSingleIsotope(G4String, G4String, G4double, G4int, G4int);
          
     void SetWorldSize     (G4double);                        
+    void SetNeutronShieldMaterial(G4String value);
+    void SetFoamMaterial(G4String value);
 
   public:
      
@@ -74,11 +77,15 @@ class DetectorConstruction : public G4VUserDetectorConstruction
      G4Material* fConcrete;
      G4Material* fPolyethylene;
      G4Material* fBPolyethylene;
+     G4Material* fTSPolyethylene;
+     G4Material* fTSBPolyethylene;
      G4Material* fNeutronShield_mat;
      G4Material* fGammaShield_mat;
      G4Material* fPolyurethane;
      G4Material* fPolyurethane_light;
      G4Material* fProtoduneFoam;
+     G4Material* fTSProtoduneFoam;
+     G4Material* fFoam_mat;
      G4Material* fLiquidArgon;
      G4Material* fStainlessSteel;
      G4Material* fLead;
@@ -112,6 +119,9 @@ class DetectorConstruction : public G4VUserDetectorConstruction
      G4VPhysicalVolume* fDDelectronics_p;
      G4VPhysicalVolume* fNeutronShield_p;
      
+     // Region of the neutron shield, "ShieldRegion"
+     G4Region*          fShieldRegion;
+     
      // World
      G4double fWorldSize_x, fWorldSize_y, fWorldSize_z; 
      
@@ -163,7 +173,6 @@ class DetectorConstruction : public G4VUserDetectorConstruction
      void ConstructNeutronShield();
      void ConstructGammaShield();
      void ConstructTestPlanes();
-     void SetNeutronShieldMaterial(G4String value);
      
      // color
      G4VisAttributes* blue_;		
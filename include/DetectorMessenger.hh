@@ -61,6 +61,8 @@ class DetectorMessenger: public G4UImessenger
     G4UIdirectory*             fTestemDir;
     G4UIdirectory*             fDetDir;
     G4UIcmdWithADoubleAndUnit* fWorldSizeCmd; 
+    G4UIcmdWithAString*        fShieldMatCmd;
+    G4UIcmdWithAString*        fFoamMatCmd;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -37,6 +37,12 @@
 #include "G4UserEventAction.hh"
 #include "globals.hh"
 #include "RunAction.hh"
+#include <map>
+#include <vector>
+
+class G4Step;
+class G4LogicalVolume;
+class G4ParticleDefinition;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -50,15 +56,30 @@ class EventAction : public G4UserEventAction
     virtual void BeginOfEventAction(const G4Event*);
     virtual void EndOfEventAction(const G4Event*);  
     
+    // cost of the event: steps and secondaries; by volume and by particle
+    // only when the slowest events are kept (/testhadr/event/slowest)
+    void CountStep(const G4Step*);
+    void AddTrackTime(const G4ParticleDefinition*, G4double time);
+    
     // boundary crossing counters
     G4int fCount_neutron_source2nitrogenBW;
     G4int fCount_neutron_shield2world;    
     G4int fCount_neutron_all2argon;
     G4int fCount_neutron_cryostat2world;
     G4int fCount_neutron_all2world;
+    G4int fCount_neutron_argonCapture;
                 
   private:                  
   	RunAction* fRun;
+  	G4double   fEventStart;
+  	
+  	G4String Where() const;
+  	
+  	G4long fNbSteps;
+  	G4long fNbSecondaries;
+  	G4bool fDetailed;
+  	std::vector<G4long>                            fVolumeSteps;  // by instance ID
+  	std::map<const G4ParticleDefinition*,G4double> fParticleTime;
   	
   	// event variables:
     G4double neutronEnergy_gen;  // DD neutron energy
@@ -0,0 +1,72 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EventChunkPolicy.hh
+/// \brief Definition of the EventChunkPolicy class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef EventChunkPolicy_h
+#define EventChunkPolicy_h 1
+
+#include "globals.hh"
+
+class EventChunkMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Size of the event chunks handed to the workers (the event modulo of
+/// the MT run manager). Instead of the default sqrt(N/nThreads), each
+/// thread receives about fChunksPerThread chunks per run, so that the
+/// heavy-tailed event cost is spread by the dynamic distribution.
+/// In adaptive mode the chunks shrink towards the end of the run, so that
+/// no thread picks up a large chunk while the others are running dry.
+
+class EventChunkPolicy
+{
+  public:
+    EventChunkPolicy();
+   ~EventChunkPolicy();
+
+  public:
+    void  SetChunksPerThread(G4int n) { fChunksPerThread = n; };
+    G4int GetChunksPerThread() const  { return fChunksPerThread; };
+    void   SetAdaptive(G4bool flag)   { fAdaptive = flag; };
+    G4bool IsAdaptive() const         { return fAdaptive; };
+
+    G4int ComputeModulo(G4int nEvents, G4int nThreads) const;
+    G4int NextChunk(G4int nRemaining, G4int nThreads, G4int modulo) const;
+
+  private:
+    G4int                fChunksPerThread;
+    G4bool               fAdaptive;
+    EventChunkMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
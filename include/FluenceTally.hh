@@ -0,0 +1,118 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file FluenceTally.hh
+/// \brief Definition of the FluenceTally class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef FluenceTally_h
+#define FluenceTally_h 1
+
+#include "globals.hh"
+#include "G4Threading.hh"
+#include "LogBinning.hh"
+
+#include <vector>
+
+class FluenceTallyMessenger;
+class G4LogicalVolume;
+class G4Step;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Neutron fluence in cells (logical volumes, by name), by the track 
+/// length estimator: the sum of w*l over the steps in the cell, divided 
+/// by its volume, per source neutron. Every step in the cell scores, not
+/// only the first crossing of the event.
+///
+/// The scores are binned in kinetic energy (log binning, see LogBinning),
+/// and given per unit lethargy. Each event loop thread accumulates in flat
+/// arrays, cell after cell and bin after bin: the score of the current
+/// event, then at its end the sums of the event scores and of their 
+/// squares, from which comes the relative error per bin. The sums of the
+/// threads are added at the end of their run. The spectra are written in
+/// <file>_fluence.txt, with their raw sums in <file>_fluence.h04s (see 
+/// TallySums).
+
+class FluenceTally
+{
+  public:
+    static FluenceTally* Instance();
+   ~FluenceTally();
+
+  public:
+    void SetEnabled(G4bool flag)           { fEnabled = flag; };
+    void SetFileName(const G4String& name) { fFileName = name; };
+    void AddCell(const G4String& volume);
+    void ClearCells()                      { fCellNames.clear(); };
+    void SetBinning(G4int nbins, G4double emin, G4double emax);
+    
+    // master
+    void BeginOfRun();
+    void EndOfRun();
+    
+    // event loop threads
+    void AddStep(const G4Step* step)       { if (fActive) Score(step); };
+    void EndOfEvent();
+    void EndOfThreadRun();
+
+  private:
+    FluenceTally();
+    
+    void Score(const G4Step*);
+    void PrepareThread();
+    void WriteSpectra(G4long nbEvents) const;
+
+  private:
+    G4bool                fEnabled;
+    G4String              fFileName;
+    std::vector<G4String> fCellNames;
+    G4int                 fNbBins;
+    G4double              fEmin, fEmax;
+    
+    // current run: cells found, their volumes; bins of each cell are
+    // underflow, nbins, overflow, and the total
+    G4bool                               fActive;
+    G4int                                fRunCount;
+    std::vector<const G4LogicalVolume*>  fCells;
+    std::vector<G4double>                fVolumes;
+    LogBinning                           fBinning;
+    size_t                               fStride;
+    G4double                             fStart;
+    
+    // sums of the threads, under fMutex
+    std::vector<G4double> fSum, fSum2;
+    G4long                fNbEvents;
+    G4Mutex               fMutex;
+    
+    FluenceTallyMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -38,6 +38,14 @@
 #include "g4root.hh"
 //#include "g4xml.hh"
 
+#include "LogHisto.hh"
+#include "SparseScoring.hh"
+
+#include <stdint.h>
+#include <vector>
+
+class HistoManagerMessenger;
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class HistoManager
@@ -46,9 +54,56 @@ class HistoManager
    HistoManager();
   ~HistoManager();
 
+    // activation of the histograms and ntuples of this thread, taken from
+    // the analysis manager at the start of each run, with the H2s which
+    // have a sparse map; H1s of log binning are then filled through a LogHisto
+    static void UpdateActivation();
+    
+    // sums of the LogHistos of this thread into their H1s
+    static void FlushThread();
+    
+    // H1s in lethargy form, E dN/dE (needs log binning)
+    void SetLethargy(G4int id);
+    void ClearLethargy()                { fLethargyMask = 0; };
+    void SetFastLogBinning(G4bool flag) { fFastLogBinning = flag; };
+    
+    // fills which cost a single branch when the object is inactive
+    static void FillH1(G4int id, G4double value, G4double weight = 1.)
+    {
+      if (!IsActive(fH1Mask, id)) return;
+      if (IsActive(fLogMask, id)) (*fLogH1s)[id]->Fill(value, weight);
+      else G4AnalysisManager::Instance()->FillH1(id, value, weight);
+    };
+    // and the sparse map of the H2, if any (see SparseScoring)
+    static void FillH2(G4int id, G4double x, G4double y, G4double weight = 1.)
+    {
+      if (!IsActive(fH2Mask | fSparseMask, id)) return;
+      if (IsActive(fH2Mask, id))
+        G4AnalysisManager::Instance()->FillH2(id, x, y, weight);
+      if (IsActive(fSparseMask, id))
+        SparseScoring::Instance()->FillH2(id, x, y, weight);
+    };
+    static G4bool IsNtupleActive(G4int id) 
+      { return IsActive(fNtupleMask, id); };
+
   private:
     void Book();
+    static G4bool IsActive(uint64_t mask, G4int id)
+      { return (unsigned)id < 64 && (mask >> id & 1); };
+    
     G4String fFileName;
+    HistoManagerMessenger* fMessenger;
+    
+    static G4ThreadLocal uint64_t fH1Mask;
+    static G4ThreadLocal uint64_t fH2Mask;
+    static G4ThreadLocal uint64_t fSparseMask;   // H2s with a sparse map
+    static G4ThreadLocal uint64_t fNtupleMask;
+    static G4ThreadLocal uint64_t fLogMask;
+    static G4ThreadLocal std::vector<LogHisto*>* fLogH1s;
+    
+    // set by commands, between runs
+    static uint64_t fLethargyMask;
+    static G4bool   fFastLogBinning;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
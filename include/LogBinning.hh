@@ -0,0 +1,102 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file LogBinning.hh
+/// \brief Definition of the LogBinning class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef LogBinning_h
+#define LogBinning_h 1
+
+#include "globals.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Bins of equal width in log(x), as those of an H1 booked with the "log"
+/// binning scheme, found without searching the edges.
+/// The exponent of x and a table of log2 indexed by the leading bits of
+/// its mantissa give log2(x) within a fraction of a bin; the bin is then 
+/// made exact by comparing x with the edges on each side. The bins follow
+/// the tools axes: 0 is the underflow, 1 to n the bins, n+1 the overflow.
+
+class LogBinning
+{
+  public:
+    LogBinning();
+   ~LogBinning();
+
+  public:
+    // edges of the n bins (n+1 values); false if they are not evenly
+    // spaced in log(x), or too narrow for the table of log2
+    G4bool Set(const std::vector<G4double>& edges);
+    
+    G4int    GetNbins() const          { return fNbins; };
+    G4double GetEdge(G4int i) const    { return fEdges[i+1]; };
+    G4double GetBinsPerOctave() const  { return fScale; };
+
+    G4int Index(G4double x) const
+    {
+      // bits of |x|: biased exponent, leading bits of the mantissa
+      uint64_t bits;
+      std::memcpy(&bits, &x, sizeof(bits));
+      bits &= ~(uint64_t(1) << 63);
+      G4double log2x = G4double(G4int(bits >> 52) - 1023) 
+                     + fLog2Table[(bits >> (52 - kTableBits)) & (kTableSize-1)];
+      G4double u = log2x*fScale + fOffset;
+      u = (x > 0.) ? u : 0.;
+      u = std::min(std::max(u, 0.), G4double(fNbins + 1));
+      
+      // exact bin, within one of the estimate
+      G4int i = G4int(u);
+      i += G4int(x >= fEdges[i+1]) - G4int(x < fEdges[i]);
+      return std::min(i, fNbins + 1);
+    };
+    
+    // bin of x by binary search of the edges, as a generic axis does
+    G4int SearchIndex(G4double x) const;
+
+  private:
+    enum { kTableBits = 10, kTableSize = 1 << kTableBits };
+    static G4double     fLog2Table[kTableSize];
+    static G4bool       InitTable();
+    static const G4bool fTableReady;
+    
+    G4int    fNbins;
+    G4double fScale;                  // bins per octave
+    G4double fOffset;
+    std::vector<G4double> fEdges;     // -inf, n+1 edges, +inf
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
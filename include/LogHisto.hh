@@ -0,0 +1,94 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file LogHisto.hh
+/// \brief Definition of the LogHisto class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef LogHisto_h
+#define LogHisto_h 1
+
+#include "globals.hh"
+#include "LogBinning.hh"
+
+#include "g4root.hh"
+
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Sums of the fills of an H1 with log binning, binned by LogBinning in 
+/// this thread and added to the H1 by Flush(). 
+/// In lethargy form each weight is divided by the width of the bins in
+/// lethargy, ln(E2/E1), so that the H1 gives E dN/dE.
+
+class LogHisto
+{
+  public:
+    LogHisto();
+   ~LogHisto();
+
+  public:
+    // binning of the H1, given in its unit; false if not log binning
+    G4bool Set(const tools::histo::h1d& h1, G4double unit, G4bool lethargy);
+    
+    void Fill(G4double value, G4double weight)
+    {
+      G4double x = value*fInverseUnit;
+      G4double w = weight*fWeightScale;
+      Bin& bin = fBins[fBinning.Index(x)];
+      bin.fEntries++;
+      bin.fSw   += w;
+      bin.fSw2  += w*w;
+      bin.fSxw  += x*w;
+      bin.fSx2w += x*x*w;
+      fEmpty = false;
+    };
+    
+    // add the sums to the H1, and restart from zero
+    void Flush(tools::histo::h1d* h1);
+    
+    const LogBinning& GetBinning() const { return fBinning; };
+
+  private:
+    struct Bin {
+      Bin() : fEntries(0), fSw(0.), fSw2(0.), fSxw(0.), fSx2w(0.) {}
+      unsigned int fEntries;
+      G4double     fSw, fSw2, fSxw, fSx2w;
+    };
+    
+    LogBinning       fBinning;
+    G4double         fInverseUnit;
+    G4double         fWeightScale;
+    std::vector<Bin> fBins;
+    G4bool           fEmpty;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
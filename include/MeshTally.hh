@@ -0,0 +1,118 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file MeshTally.hh
+/// \brief Definition of the MeshTally class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef MeshTally_h
+#define MeshTally_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4Threading.hh"
+#include "SparseMesh.hh"
+
+#include <vector>
+
+class MeshTallyMessenger;
+class G4Step;
+class G4LogicalVolume;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Cartesian mesh tallies of the neutrons, defined by /testhadr/mesh/create:
+///   fluence   track length of the steps in each voxel (3D DDA through
+///             the mesh, see SparseMesh), divided by its volume
+///   capture   captures (nCapture) in each voxel, divided by its volume
+/// optionally restricted to the steps in one logical volume.
+///
+/// Each event loop thread scores the current event in a hash table of 
+/// the voxels it reached; at the end of the event, the scores go to the 
+/// sparse meshes of the thread (sums of the event scores and of their 
+/// squares). These are summed at the end of the thread run, and the sums
+/// written by the master to <file>_mesh_<name>.h04v, with the number of
+/// events (see SparseMesh for the format): fluence per source neutron is
+/// sum/(events*voxel volume).
+
+class MeshTally
+{
+  public:
+    enum EQuantity { kFluence = 0, kCapture = 1 };
+    
+    static MeshTally* Instance();
+   ~MeshTally();
+
+  public:
+    // limits and voxel size in internal units; volume "all" for all
+    void Create(const G4String& name, G4int quantity,
+                const G4ThreeVector& lower, const G4ThreeVector& upper,
+                G4double voxel, const G4String& volume);
+    void Clear();
+    void SetFileName(const G4String& name) { fFileName = name; };
+    
+    // master
+    void BeginOfRun();
+    void EndOfRun();
+    
+    // event loop threads
+    void AddStep(const G4Step* step)       { if (fActive) Score(step); };
+    void EndOfEvent();
+    void EndOfThreadRun();
+
+  private:
+    MeshTally();
+    
+    void Score(const G4Step*);
+    void PrepareThread();
+
+  private:
+    struct Definition {
+      G4String                fName;
+      G4int                   fQuantity;
+      G4int                   fN[3];
+      G4ThreeVector           fLower, fUpper;
+      G4String                fVolumeName;
+      const G4LogicalVolume*  fVolume;     // 0 for all
+      SparseMesh*             fSum;        // of all threads, current run
+    };
+    std::vector<Definition> fDefinitions;
+    G4String                fFileName;
+    
+    // current run
+    G4bool  fActive;
+    G4int   fRunCount;
+    G4long  fNbEvents;
+    G4Mutex fMutex;
+    
+    MeshTallyMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,72 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file MultigroupNeutronProcess.hh
+/// \brief Definition of the MultigroupNeutronProcess class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef MultigroupNeutronProcess_h
+#define MultigroupNeutronProcess_h 1
+
+#include "G4VDiscreteProcess.hh"
+#include "globals.hh"
+
+class MultigroupXSLibrary;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Neutron interaction sampled from the condensed group constants of
+/// MultigroupXSLibrary: either a group-to-group scattering, with the
+/// outgoing energy uniform in lethargy inside the new group and an
+/// isotropic direction, or an absorption which kills the neutron
+/// (no capture gammas are produced).
+
+class MultigroupNeutronProcess : public G4VDiscreteProcess
+{
+  public:
+    enum Kind { kScatter, kAbsorption };
+
+    MultigroupNeutronProcess(Kind kind, const G4String& name);
+   ~MultigroupNeutronProcess();
+
+  public:
+    virtual G4bool IsApplicable(const G4ParticleDefinition&);
+    virtual void BuildPhysicsTable(const G4ParticleDefinition&);
+
+    virtual G4double GetMeanFreePath(const G4Track&, G4double,
+                                     G4ForceCondition*);
+    virtual G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+
+  private:
+    Kind                 fKind;
+    MultigroupXSLibrary* fLibrary;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
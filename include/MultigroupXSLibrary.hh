@@ -0,0 +1,114 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file MultigroupXSLibrary.hh
+/// \brief Definition of the MultigroupXSLibrary class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef MultigroupXSLibrary_h
+#define MultigroupXSLibrary_h 1
+
+#include "globals.hh"
+#include "G4Material.hh"
+#include <vector>
+
+class NeutronXSTableBuilder;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Condensed multigroup neutron cross sections of the materials of the
+/// geometry, collapsed from the (broadened) ParticleHP data with a 1/E
+/// weighting spectrum on a user-chosen group structure.
+///
+/// Scattering is described by P0, transport-corrected group-to-group
+/// matrices: elastic scattering is isotropic in the centre of mass
+/// (outgoing energy uniform in [alpha E, E]) and the mean lab cosine
+/// 2/(3A) is removed from the in-group term. Below the thermal cutoff
+/// (4 eV by default) the target atoms move: the free gas kernel at the
+/// temperature of the material gives the outgoing energies, up- and 
+/// downscattering, normalized to the elastic cross section.
+/// Inelastic scattering emits one neutron uniformly in [0, E - |Q|], Q 
+/// of the lowest threshold of the element; inelastic channels open at 
+/// thermal energies, (n,alpha), (n,p), emit no neutron below 10 keV.
+/// Capture and fission are absorption.
+
+class MultigroupXSLibrary
+{
+  public:
+    struct MaterialData {
+      std::vector<G4double> fTotal;       // [group], 1/length
+      std::vector<G4double> fAbsorption;  // [group]
+      std::vector<G4double> fScatter;     // [group]
+      std::vector<G4double> fTransferCDF; // [group][group'], cumulative
+    };
+
+  public:
+    static MultigroupXSLibrary* Instance();
+   ~MultigroupXSLibrary();
+
+  public:
+    // group boundaries, increasing energies, nbGroups+1 values
+    void SetGroupBoundaries(const std::vector<G4double>&);
+    void SetLogGroups(G4int nbGroups, G4double emin, G4double emax);
+    void SetPointsPerGroup(G4int n) { fPointsPerGroup = n; };
+    void SetThermalCutoff(G4double e) { fThermalCutoff = e; };
+
+    // collapse the data of the materials of the geometry (master, once)
+    void Generate();
+    void Print() const;
+
+    G4int GetNbGroups() const { return (G4int)fBoundaries.size() - 1; };
+    G4int FindGroup(G4double energy) const;
+    G4double GetLowerEdge(G4int group) const { return fBoundaries[group]; };
+    G4double GetUpperEdge(G4int group) const { return fBoundaries[group+1]; };
+
+    const MaterialData* GetData(const G4Material* material) const
+    {
+      size_t index = material->GetIndex();
+      return (index < fData.size()) ? fData[index] : 0;
+    };
+
+  private:
+    MultigroupXSLibrary();
+    MaterialData* Collapse(const G4Material*, NeutronXSTableBuilder*);
+    
+    // fractions of the free gas scattering at energy into each group
+    void FreeGasTransfer(G4double energy, G4double massRatio, G4double kT,
+                         std::vector<G4double>& fractions) const;
+
+  private:
+    std::vector<G4double>      fBoundaries;
+    std::vector<MaterialData*> fData;          // indexed by material index
+    G4int                      fPointsPerGroup;
+    G4double                   fThermalCutoff;
+    G4bool                     fGenerated;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
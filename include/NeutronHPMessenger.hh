@@ -39,6 +39,9 @@
 class NeutronHPphysics;
 class G4UIdirectory;
 class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithADouble;
+class G4UIcommand;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -55,6 +58,15 @@ class NeutronHPMessenger: public G4UImessenger
     
     G4UIdirectory*     fPhysDir;      
     G4UIcmdWithABool*  fThermalCmd;
+    G4UIcmdWithAString* fThermalRegionCmd;
+    G4UIcmdWithABool*   fArgonCascadeCmd;
+    G4UIcmdWithAString* fArgonCascadeFileCmd;
+    
+    G4UIdirectory*      fXSDir;
+    G4UIcmdWithABool*   fXSUseCmd;
+    G4UIcmdWithAString* fXSDirectoryCmd;
+    G4UIcmdWithADouble* fXSToleranceCmd;
+    G4UIcommand*        fXSBuildCmd;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -52,9 +52,21 @@ class NeutronHPphysics : public G4VPhysicsConstructor
     
   public:
     void SetThermalPhysics(G4bool flag) {fThermal = flag;};  
+    void SetThermalRegion(const G4String& name) {fThermalRegion = name;};
+    void SetUseXSTables(G4bool flag)    {fUseXSTables = flag;};
+    void SetXSTableDirectory(const G4String&);
+    void SetXSTableTolerance(G4double tol) {fXSTolerance = tol;};
+    void BuildXSTable(const G4String& material, G4double temperature);
+    void SetArgonCascade(G4bool flag) {fArgonCascade = flag;};
+    void SetArgonCascadeFile(const G4String& name) {fArgonCascadeFile = name;};
     
   private:
     G4bool  fThermal;
+    G4String fThermalRegion;
+    G4bool  fUseXSTables;
+    G4double fXSTolerance;
+    G4bool   fArgonCascade;
+    G4String fArgonCascadeFile;
     NeutronHPMessenger* fNeutronMessenger;  
 };
 
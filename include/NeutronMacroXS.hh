@@ -0,0 +1,93 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NeutronMacroXS.hh
+/// \brief Definition of the NeutronMacroXS class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NeutronMacroXS_h
+#define NeutronMacroXS_h 1
+
+#include "globals.hh"
+#include <vector>
+
+class G4Material;
+class NeutronXSTable;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Macroscopic cross sections of one material (total and per reaction),
+/// precomputed from a NeutronXSTable on its unionized energy grid.
+///
+/// Each energy point holds one cache line of kNbLanes doubles
+/// (total, elastic, inelastic, capture, fission, padding), so a lookup
+/// touches two consecutive lines and the interpolation of all reactions
+/// vectorizes. The bin is found through a hash of log(E) into buckets of
+/// the grid, followed by a binary search restricted to the bucket.
+
+class NeutronMacroXS
+{
+  public:
+    enum Lane { kTotal = 0, kElastic, kInelastic, kCapture, kFission,
+                kNbLanes = 8 };
+
+  public:
+    NeutronMacroXS(const NeutronXSTable*, const G4Material*);
+   ~NeutronMacroXS();
+
+  public:
+    G4bool IsInRange(G4double energy) const
+      { return energy >= fMinEnergy && energy <= fMaxEnergy; };
+
+    size_t FindBin(G4double energy) const;
+
+    // macroscopic cross section (1/length) of one lane
+    G4double GetCrossSection(G4int lane, G4double energy) const;
+
+    // all lanes at once, values[kNbLanes]
+    void GetCrossSections(G4double energy, G4double* values) const;
+
+    G4bool HasThermalScatteringElements() const { return fThermalElements; };
+
+  private:
+    const G4double* Line(size_t bin) const { return fData + bin*kNbLanes; };
+
+  private:
+    std::vector<G4double> fEnergy;
+    G4double*             fData;      // aligned [bin][lane]
+    char*                 fBuffer;    // owns fData
+
+    std::vector<G4int>    fBucket;    // first bin of each log(E) bucket
+    G4double              fLogMinEnergy, fInvBucketWidth;
+    G4double              fMinEnergy, fMaxEnergy;
+    G4bool                fThermalElements;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
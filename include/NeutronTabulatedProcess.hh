@@ -0,0 +1,108 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NeutronTabulatedProcess.hh
+/// \brief Definition of the NeutronTabulatedProcess class template
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NeutronTabulatedProcess_h
+#define NeutronTabulatedProcess_h 1
+
+#include "globals.hh"
+#include "G4Track.hh"
+#include "G4Step.hh"
+#include "G4ForceCondition.hh"
+#include "G4VParticleChange.hh"
+#include "G4CrossSectionDataStore.hh"
+
+#include "NeutronMacroXS.hh"
+#include "NeutronXSTableStore.hh"
+
+#include <cfloat>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// A neutron hadronic process whose mean free path is read directly from
+/// the macroscopic table of the material (NeutronMacroXS), instead of
+/// summing the element cross sections of its data store at every step.
+/// The data store is used as fallback for materials without a table.
+/// Below fThermalLimit, materials carrying thermal scattering elements
+/// are left to the data store as well (S(alpha,beta) is not tabulated).
+///
+/// The target element is sampled by the data store (SampleZandA) from 
+/// the element cross sections of its last GetCrossSection call: when the
+/// table gave the mean free path, these are computed again, only at the
+/// interaction, before PostStepDoIt. The cross section biasing factor of
+/// the process applies to the tabulated value as well.
+
+template <class TProcess>
+class NeutronTabulatedProcess : public TProcess
+{
+  public:
+    NeutronTabulatedProcess(G4int lane, G4double thermalLimit = 0.)
+      : TProcess(), fLane(lane), fThermalLimit(thermalLimit),
+        fTabulated(false) {};
+   ~NeutronTabulatedProcess() {};
+
+  public:
+    virtual G4double GetMeanFreePath(const G4Track& track, G4double previous,
+                                     G4ForceCondition* condition)
+    {
+      const NeutronMacroXS* table
+        = NeutronXSTableStore::Instance()->GetMacroTable(track.GetMaterial());
+      G4double energy = track.GetKineticEnergy();
+      fTabulated = false;
+      if (!table || !table->IsInRange(energy) ||
+          (energy < fThermalLimit && table->HasThermalScatteringElements())) {
+        return TProcess::GetMeanFreePath(track, previous, condition);
+      }
+      fTabulated = true;
+      G4double xs = this->CrossSectionFactor()
+                  *table->GetCrossSection(fLane, energy);
+      return (xs > 0.) ? 1./xs : DBL_MAX;
+    };
+    
+    virtual G4VParticleChange* PostStepDoIt(const G4Track& track, 
+                                            const G4Step& step)
+    {
+      if (fTabulated) {
+        this->GetCrossSectionDataStore()->GetCrossSection(
+                            track.GetDynamicParticle(), track.GetMaterial());
+      }
+      return TProcess::PostStepDoIt(track, step);
+    };
+
+  private:
+    G4int    fLane;
+    G4double fThermalLimit;
+    G4bool   fTabulated;      // mean free path of the last step from the table
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,101 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NeutronXSTable.hh
+/// \brief Definition of the NeutronXSTable class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NeutronXSTable_h
+#define NeutronXSTable_h 1
+
+#include "globals.hh"
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Pre-broadened microscopic cross sections of all elements of one material
+/// at one temperature, tabulated on a single unionized energy grid.
+/// Tables are produced by NeutronXSTableBuilder and read back at run time,
+/// so that a lookup is one binary search shared by all elements and
+/// reactions of the material, with no on-the-fly Doppler broadening.
+
+class NeutronXSTable
+{
+  public:
+    enum Reaction { kElastic = 0, kInelastic, kCapture, kFission, kNbReactions };
+
+  public:
+    NeutronXSTable(const G4String& material, G4double temperature,
+                   const std::vector<G4int>& elementZ);
+   ~NeutronXSTable();
+
+  public:
+    static G4String FileName(const G4String& directory,
+                             const G4String& material, G4double temperature);
+    static NeutronXSTable* Read(const G4String& fileName);
+    G4bool Write(const G4String& fileName) const;
+
+    // filled by the builder
+    void SetGrid(const std::vector<G4double>& energies);
+    void SetCrossSection(G4int reaction, G4int element, size_t bin, G4double xs)
+      { fXS[Index(reaction, element, bin)] = xs; };
+
+    // lookup, energy in Geant4 units, cross section in Geant4 units (mm2)
+    size_t   FindBin(G4double energy) const;
+    G4double GetCrossSection(G4int reaction, G4int element, size_t bin,
+                             G4double energy) const;
+    G4double GetCrossSection(G4int reaction, G4int element,
+                             G4double energy) const
+      { return GetCrossSection(reaction, element, FindBin(energy), energy); };
+
+    G4int ElementIndex(G4int Z) const;
+
+    const G4String& GetMaterialName() const  { return fMaterial; };
+    G4double GetTemperature() const          { return fTemperature; };
+    G4int    GetNbElements() const           { return (G4int)fElementZ.size(); };
+    G4int    GetZ(G4int element) const       { return fElementZ[element]; };
+    size_t   GetNbEnergies() const           { return fEnergy.size(); };
+    G4double GetEnergy(size_t bin) const     { return fEnergy[bin]; };
+    G4double GetMinEnergy() const            { return fEnergy.front(); };
+    G4double GetMaxEnergy() const            { return fEnergy.back(); };
+
+  private:
+    size_t Index(G4int reaction, G4int element, size_t bin) const
+      { return (reaction*fElementZ.size() + element)*fEnergy.size() + bin; };
+
+  private:
+    G4String              fMaterial;
+    G4double              fTemperature;
+    std::vector<G4int>    fElementZ;
+    std::vector<G4double> fEnergy;
+    std::vector<G4double> fXS;   // [reaction][element][energy]
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
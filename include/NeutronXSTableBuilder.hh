@@ -0,0 +1,117 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NeutronXSTableBuilder.hh
+/// \brief Definition of the NeutronXSTableBuilder class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NeutronXSTableBuilder_h
+#define NeutronXSTableBuilder_h 1
+
+#include "globals.hh"
+#include <map>
+#include <vector>
+
+class G4Material;
+class G4Element;
+class G4DynamicParticle;
+class G4ParticleHPElasticData;
+class G4ParticleHPInelasticData;
+class G4ParticleHPCaptureData;
+class G4ParticleHPFissionData;
+class NeutronXSTable;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Preprocessing tool: evaluates the ParticleHP cross sections of every
+/// element of a material, Doppler-broadened at the requested temperature,
+/// and reconstructs them on a unionized energy grid.
+///
+/// The ParticleHP data are read at 0 K (NeglectDoppler), which is their
+/// deterministic point-wise form, on a grid of each element and reaction
+/// refined until linear interpolation reproduces them within the 
+/// requested tolerance. They are then broadened here, as SIGMA1 does: the
+/// free gas kernel integrated exactly over each linear segment (in terms
+/// of erfc and exponentials), below the first point the cross section 
+/// taken as 1/v, above the last one as constant. The temperature Doppler
+/// integral of ParticleHP itself is a Monte Carlo estimate, good to about
+/// 1%, and draws random numbers: it is never used. The unionized grid is 
+/// the union of the 0 K grids, the broadened data being smoother.
+
+class NeutronXSTableBuilder
+{
+  public:
+    NeutronXSTableBuilder();
+   ~NeutronXSTableBuilder();
+
+  public:
+    void SetTolerance(G4double tol)         { fTolerance = tol; };
+    void SetEnergyRange(G4double emin, G4double emax)
+      { fMinEnergy = emin; fMaxEnergy = emax; };
+
+    NeutronXSTable* Build(const G4Material*, G4double temperature);
+    G4bool BuildAndWrite(const G4Material*, G4double temperature,
+                         const G4String& directory);
+
+    // broadened microscopic cross section of one element (Geant4 units)
+    G4double GetCrossSection(G4int reaction, const G4Element*,
+                             G4double energy, G4double temperature);
+    
+    // lowest energy where the reaction is open at 0 K: 0 if open at the
+    // lowest energy of the tables, DBL_MAX if never
+    G4double GetThreshold(G4int reaction, const G4Element*);
+
+  private:
+    // ParticleHP data at 0 K, linear in energy between the points
+    struct Curve {
+      std::vector<G4double> fEnergy, fValue;
+    };
+    const Curve& GetCurve(G4int reaction, const G4Element*);
+    G4double Evaluate(G4int reaction, const G4Element*, G4double energy);
+    G4double Interpolate(const Curve&, G4double energy) const;
+    G4double Broaden(const Curve&, G4double massRatio, G4double temperature,
+                     G4double energy) const;
+
+  private:
+    G4ParticleHPElasticData*   fElastic;
+    G4ParticleHPInelasticData* fInelastic;
+    G4ParticleHPCaptureData*   fCapture;
+    G4ParticleHPFissionData*   fFission;
+    G4DynamicParticle*         fNeutron;
+
+    G4double fTolerance;
+    G4double fMinEnergy, fMaxEnergy;
+    G4int    fPointsPerDecade;
+    G4int    fMaxPoints;
+    
+    std::map<std::pair<G4int,const G4Element*>, Curve> fCurves;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
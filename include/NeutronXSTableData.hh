@@ -0,0 +1,66 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NeutronXSTableData.hh
+/// \brief Definition of the NeutronXSTableData class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NeutronXSTableData_h
+#define NeutronXSTableData_h 1
+
+#include "G4VCrossSectionDataSet.hh"
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Cross section data set reading the pre-broadened tables of
+/// NeutronXSTableStore. It is stacked on top of the ParticleHP data set of
+/// the same reaction and is only applicable to materials that have a table,
+/// so ParticleHP remains the fallback for everything else.
+
+class NeutronXSTableData : public G4VCrossSectionDataSet
+{
+  public:
+    NeutronXSTableData(G4int reaction);
+   ~NeutronXSTableData();
+
+  public:
+    virtual G4bool IsElementApplicable(const G4DynamicParticle*, G4int Z,
+                                       const G4Material* mat = 0);
+    virtual G4double GetElementCrossSection(const G4DynamicParticle*, G4int Z,
+                                            const G4Material* mat = 0);
+    virtual void BuildPhysicsTable(const G4ParticleDefinition&);
+    virtual void CrossSectionDescription(std::ostream&) const;
+
+  private:
+    G4int fReaction;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
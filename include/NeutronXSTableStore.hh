@@ -0,0 +1,78 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NeutronXSTableStore.hh
+/// \brief Definition of the NeutronXSTableStore class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NeutronXSTableStore_h
+#define NeutronXSTableStore_h 1
+
+#include "globals.hh"
+#include <vector>
+
+class G4Material;
+class NeutronXSTable;
+class NeutronMacroXS;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Shared, read-only registry of the pre-broadened cross section tables,
+/// indexed by material index. Tables are loaded once (on the master) from
+/// the table directory; worker threads only read them. The macroscopic
+/// tables of the lookup engine (NeutronMacroXS) are derived at load time.
+
+class NeutronXSTableStore
+{
+  public:
+    static NeutronXSTableStore* Instance();
+   ~NeutronXSTableStore();
+
+  public:
+    void SetDirectory(const G4String& dir) { fDirectory = dir; };
+    const G4String& GetDirectory() const   { return fDirectory; };
+
+    // load the table of every material of the material table, if present
+    void Load();
+
+    const NeutronXSTable* GetTable(const G4Material* material) const;
+    const NeutronMacroXS* GetMacroTable(const G4Material* material) const;
+
+  private:
+    NeutronXSTableStore();
+
+  private:
+    G4String                     fDirectory;
+    std::vector<NeutronXSTable*> fTables;   // indexed by material index
+    std::vector<NeutronMacroXS*> fMacroTables;
+    G4bool                       fLoaded;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,87 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file PhiloxEngine.hh
+/// \brief Definition of the PhiloxEngine class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef PhiloxEngine_h
+#define PhiloxEngine_h 1
+
+#include "globals.hh"
+#include "CLHEP/Random/RandomEngine.h"
+
+#include <cstdint>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Counter-based random engine Philox4x32-10 (Salmon et al., SC'11).
+/// The output is a bijection of a 128-bit counter under a 64-bit key: 
+/// the key is the run seed, the upper half of the counter the index of 
+/// the stream (here the event) and the lower half the position in the 
+/// stream. Any stream can thus be entered directly, without state to 
+/// carry from one event to the next.
+
+class PhiloxEngine : public CLHEP::HepRandomEngine
+{
+  public:
+    PhiloxEngine(G4long seed = 0);
+    virtual ~PhiloxEngine();
+
+  public:
+    // go to the beginning of the stream of index 'stream' for 'seed'
+    void SetStream(uint64_t seed, uint64_t stream);
+
+    virtual double flat();
+    virtual void   flatArray(const int size, double* vect);
+    virtual void   setSeed(long seed, int);
+    virtual void   setSeeds(const long* seeds, int);
+    virtual void   saveStatus(const char filename[] = "Philox.conf") const;
+    virtual void   restoreStatus(const char filename[] = "Philox.conf");
+    virtual void   showStatus() const;
+    virtual std::string name() const { return "PhiloxEngine"; };
+
+    virtual operator unsigned int();
+    
+    // known-answer test of the Random123 distribution (kat_vectors)
+    static G4bool SelfTest();
+
+  private:
+    uint32_t Next();
+    void     Generate();
+
+  private:
+    uint32_t fKey[2];
+    uint32_t fCounter[4];    // [0,1] position, [2,3] stream
+    uint32_t fBuffer[4];
+    G4int    fIndex;         // next word of fBuffer, 4 if empty
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -34,6 +34,8 @@
 #include "G4VModularPhysicsList.hh"
 #include "globals.hh"
 
+class PhysicsListMessenger;
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class PhysicsList: public G4VModularPhysicsList
@@ -45,6 +47,12 @@ public:
 public:
   virtual void ConstructParticle();
   virtual void SetCuts();
+
+  void SelectNeutronModel(const G4String&);
+
+private:
+  PhysicsListMessenger* fMessenger;
+  G4bool                fMultigroup;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,170 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file PointDetector.hh
+/// \brief Definition of the PointDetector class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef PointDetector_h
+#define PointDetector_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4Threading.hh"
+#include "LogBinning.hh"
+
+#include <vector>
+
+class PointDetectorMessenger;
+class G4Material;
+class G4Step;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Neutron and gamma flux at points of the hall (/testhadr/point/add), 
+/// by the next event estimator: at each emission of a neutron or gamma 
+/// (birth of the track, or collision it survives), the flux at a point 
+/// at distance R, seen at the lab cosine mu from the incident direction,
+/// gets the probability to be emitted toward it and to fly there 
+/// uncollided,
+///    w p(mu) exp(-tau(E(mu)))/(2 pi R^2)
+/// with p the density of the cosine of emission and E(mu) the energy of
+/// the particle emitted toward the point:
+///   - neutron elastic scattering: two body kinematics on the target 
+///     nucleus of the collision, at rest, isotropic in the centre of mass;
+///   - Compton scattering: Klein-Nishina, on free electrons at rest;
+///   - Rayleigh scattering: 3 (1 + mu^2)/8, without change of energy;
+///   - birth of the track (source, capture gammas, other secondaries): 
+///     isotropic, p = 1/2, as the other collisions which the track 
+///     survives, for want of their kinematics.
+/// The optical depth tau is found by marching through the volumes between
+/// the two points with a navigator of the thread, with the total cross
+/// sections of their materials, tabulated by the master at the start of
+/// the run and read by all the threads: from the hadronic process store 
+/// (neutrons, 0 K data: the Doppler broadening of ParticleHP is sampled 
+/// with the random engine, which would change the histories) and from 
+/// G4EmCalculator (gammas).
+///
+/// Bounded variance: within the exclusion sphere of radius R0 around a
+/// point, 1/(4 pi R^2) is replaced by its mean over the sphere, with the 
+/// material of the emission: 3 (1 - exp(-S R0))/(4 pi S R0^3). The rays
+/// are optionally rouletted (/testhadr/point/roulette k) when their upper
+/// bound, w p(mu)/(2 pi R^2), is below k times the mean contribution to 
+/// the point so far; the survivors are weighted up, the tally stays 
+/// unbiased.
+///
+/// The contributions are binned in energy (see LogBinning) and the event
+/// scores summed as in FluenceTally, giving relative errors and figures 
+/// of merit; spectra per unit lethargy go to <file>_point.txt, their raw
+/// sums to <file>_point.h04s (see TallySums).
+
+class PointDetector
+{
+  public:
+    enum EParticle { kNeutron = 0, kGamma = 1, kNbParticles = 2 };
+    
+    // angular distribution of an emission
+    enum EEmission { kIsotropic, kElastic, kCompton, kRayleigh };
+    struct Emission {
+      EEmission     fType;
+      G4ThreeVector fDirection;      // incident direction
+      G4double      fMassRatio;      // of the target, kElastic
+    };
+    
+    static PointDetector* Instance();
+   ~PointDetector();
+
+  public:
+    void AddPoint(const G4String& name, const G4ThreeVector& position);
+    void ClearPoints()                     { fPoints.clear(); };
+    void SetExclusionRadius(G4double r)    { fExclusion = r; };
+    void SetRoulette(G4double k)           { fRoulette = k; };
+    void SetCrossSectionPoints(G4int n)    { fXsPoints = n; };
+    void SetBinning(G4int nbins, G4double emin, G4double emax);
+    void SetFileName(const G4String& name) { fFileName = name; };
+    
+    // master
+    void BeginOfRun();
+    void EndOfRun();
+    
+    // event loop threads
+    void AddStep(const G4Step* step)       { if (fActive) Score(step); };
+    void EndOfEvent();
+    void EndOfThreadRun();
+
+  private:
+    PointDetector();
+    
+    void Score(const G4Step*);
+    void Contribute(const G4ThreeVector& position, G4int particle, 
+                    G4double energy, G4double weight, const G4Material*,
+                    const Emission&);
+    
+    // total macroscopic cross sections, tabulated by the master
+    void     BuildTables();
+    G4double CrossSection(const G4Material*, G4int particle, 
+                          G4double energy) const;
+    G4double OpticalDepth(const G4ThreeVector& from, const G4ThreeVector& to,
+                          G4int particle, G4double energy);
+    void PrepareThread();
+    void WriteSpectra(G4long nbEvents) const;
+
+  private:
+    struct Point {
+      G4String      fName;
+      G4ThreeVector fPosition;
+    };
+    std::vector<Point> fPoints;
+    G4double           fExclusion;
+    G4double           fRoulette;
+    G4int              fXsPoints;         // per decade of energy
+    G4int              fNbBins;
+    G4double           fEmin, fEmax;
+    G4String           fFileName;
+    
+    // current run; bins of each point and particle are underflow, 
+    // nbins, overflow, and the total
+    G4bool     fActive;
+    G4int      fRunCount;
+    LogBinning fBinning;
+    size_t     fStride;
+    G4double   fStart;
+    std::vector<std::vector<G4double> > fTables;  // per material and particle
+    
+    // sums of the threads, under fMutex
+    std::vector<G4double> fSum, fSum2;
+    G4long                fNbEvents;
+    G4long                fNbRays, fNbRouletted;
+    G4Mutex               fMutex;
+    
+    PointDetectorMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
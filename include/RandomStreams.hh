@@ -0,0 +1,102 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RandomStreams.hh
+/// \brief Definition of the RandomStreams class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef RandomStreams_h
+#define RandomStreams_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+class RandomStreamsMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Per-event random streams. When counter-based streams are selected, 
+/// each thread runs a PhiloxEngine which is set, at the start of every 
+/// event, to the stream (seed, first event + event ID). An event then 
+/// draws the same numbers whatever the thread, the number of threads or
+/// the order of processing, and whatever the split of a campaign between
+/// processes, provided each process is given its first event index.
+/// Successive runs of a job continue the numbering, so that an event is
+/// replayed alone with /testhadr/random/firstEvent and /run/beamOn 1.
+///
+/// Settings are made on the master, before the run, and read by all the
+/// threads during the run.
+
+class RandomStreams
+{
+  public:
+    static RandomStreams* Instance();
+   ~RandomStreams();
+
+  public:
+    // the engine is checked against its known answers before it is used
+    void   SetCounterBased(G4bool flag);
+    G4bool IsCounterBased() const         { return fCounterBased; };
+    void     SetSeed(uint64_t seed)       { fSeed = seed; };
+    uint64_t GetSeed() const              { return fSeed; };
+    void     SetFirstEvent(uint64_t first) { fFirstEvent = first; };
+    uint64_t GetFirstEvent() const        { return fFirstEvent; };
+    
+    // explicit streams of the next run, e.g. the events still to be done
+    // when a run is resumed; the next run after it starts at 'end'
+    void SetStreamList(const std::vector<uint64_t>& streams, uint64_t end)
+      { fStreamList = streams; fStreamListEnd = end; };
+    
+    uint64_t GetStreamIndex(G4int eventID) const
+      { return fStreamList.empty() ? fFirstEvent + (uint64_t)eventID 
+                                   : fStreamList[eventID]; };
+
+    // any thread, before the primaries are generated
+    void BeginOfEvent(G4int eventID);
+
+    // master: print the streams of the run, then skip past them
+    void BeginOfRun(G4int nbEvents) const;
+    void EndOfRun(G4int nbEvents);
+
+  private:
+    RandomStreams();
+
+  private:
+    G4bool                  fCounterBased;
+    uint64_t                fSeed;
+    uint64_t                fFirstEvent;
+    std::vector<uint64_t>   fStreamList;
+    uint64_t                fStreamListEnd;
+    RandomStreamsMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,122 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RecordChunk.hh
+/// \brief Definition of the RecordChunk class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef RecordChunk_h
+#define RecordChunk_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+class RecordChunk;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Tables of records written in columnar form (see ColumnarWriter), and
+/// their typed columns:
+///   crossing: event (uint32), code (uint8, ECrossing), x y z (float32, m),
+///             energy (float32, MeV), time (float32, ns)
+///   capture:  event (uint32), x y z (float32, m), time (float32, ns),
+///             gammaSum (float32, MeV, capture gammas)
+
+namespace RecordSchema {
+  enum EColumnType { kFloat32 = 0, kUInt8 = 1, kUInt32 = 2 };
+  enum ETable      { kCrossing = 0, kCapture = 1, kNbTables = 2 };
+  enum ECrossing   { kNeutronExitCryostat = 1, kGammaExitCryostat = 2,
+                     kNeutronEnterArgon = 3 };
+  
+  struct Column {
+    const char* fName;
+    G4int       fType;
+  };
+  struct Table {
+    const char*   fName;
+    G4int         fNbColumns;
+    const Column* fColumns;
+  };
+  
+  const Table& GetTable(G4int table);
+  size_t       TypeSize(G4int type);
+  
+  // one row, in the units of the columns, appended to a chunk of the table
+  void AppendCrossing(RecordChunk&, uint32_t event, G4int code,
+                      const G4ThreeVector& position, G4double energy,
+                      G4double time);
+  void AppendCapture(RecordChunk&, uint32_t event,
+                     const G4ThreeVector& position, G4double time,
+                     G4double gammaSum);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Rows of one table, column by column, for at most a given number of
+/// rows: the unit handed by the event loop threads to the output.
+
+class RecordChunk
+{
+  public:
+    RecordChunk(G4int table, size_t capacity);
+   ~RecordChunk();
+
+  public:
+    G4int  GetTable() const     { return fTable; };
+    size_t GetNbRows() const    { return fNbRows; };
+    size_t GetCapacity() const  { return fCapacity; };
+    G4bool IsFull() const       { return fNbRows >= fCapacity; };
+    
+    // a row is given column after column, then closed by EndRow()
+    template <class T> void Append(G4int column, T value)
+    {
+      std::vector<char>& data = fColumns[column];
+      size_t size = data.size();
+      data.resize(size + sizeof(T));
+      std::memcpy(&data[size], &value, sizeof(T));
+    };
+    void EndRow()               { fNbRows++; };
+    void Clear();
+    
+    const std::vector<char>& GetColumn(G4int column) const 
+                                { return fColumns[column]; };
+
+  private:
+    G4int                          fTable;
+    size_t                         fCapacity;
+    size_t                         fNbRows;
+    std::vector<std::vector<char> > fColumns;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
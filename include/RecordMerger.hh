@@ -0,0 +1,86 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RecordMerger.hh
+/// \brief Definition of the RecordMerger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef RecordMerger_h
+#define RecordMerger_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Manifests of the record files of a run, and their merge.
+///
+/// A manifest <file>.h04m lists the record files written by a run, one 
+/// line per file: table, thread (-1 for a file of all threads), rows, 
+/// bytes and name, relative to the manifest. With /testhadr/records/shards
+/// each thread writes its own files <file>_<table>_t<thread>.h04c.
+///
+/// The merge concatenates the files of each table, in the order of the
+/// manifests, into <stem>_<table>.h04c. The blocks are copied as they are,
+/// not decoded: their room is reserved in the output first, then several
+/// threads copy them, from the memory-mapped inputs, each to its place.
+
+class RecordMerger
+{
+  public:
+    struct Shard {
+      Shard() : fTable(0), fThread(-1), fNbRows(0), fSize(0) {};
+      G4int    fTable;
+      G4int    fThread;
+      uint64_t fNbRows;
+      uint64_t fSize;
+      G4String fFile;
+    };
+    
+    static G4bool WriteManifest(const G4String& fileName, 
+                                const std::vector<Shard>&);
+    static G4bool ReadManifest(const G4String& fileName, std::vector<Shard>&);
+
+  public:
+    RecordMerger(G4int nbThreads);
+   ~RecordMerger();
+
+  public:
+    G4bool Merge(const std::vector<G4String>& manifests, const G4String& stem);
+    G4bool MergeTable(G4int table, const std::vector<G4String>& files,
+                      const G4String& output);
+
+  private:
+    G4int fNbThreads;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
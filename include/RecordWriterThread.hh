@@ -0,0 +1,136 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RecordWriterThread.hh
+/// \brief Definition of the RecordWriterThread class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef RecordWriterThread_h
+#define RecordWriterThread_h 1
+
+#include "globals.hh"
+#include "RecordChunk.hh"
+#include "SpscQueue.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+class ColumnarWriter;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Output thread of the record files (see Records). Each event loop 
+/// thread has its own lane: a bounded lock-free queue of full chunks to
+/// the writer thread, and queues of the chunks written and cleared, back
+/// to the event loop thread for reuse. Encoding (zlib) and file output 
+/// happen in the writer thread while the event loop threads go on; an 
+/// event loop thread waits only when its lane holds the maximal number of
+/// chunks (a stall, counted).
+///
+/// Flush semantics:
+///   Flush()  event loop thread: returns once all chunks it handed over 
+///            are written and the files flushed to the system (used before
+///            a checkpoint, so that the records of the checkpointed events
+///            are in the files).
+///   Stop()   master, end of run: the writer thread writes all chunks 
+///            still queued, then ends; the files can be closed.
+///
+/// A chunk goes to the file of its table given at construction, or to 
+/// another writer given with it (the file of a thread, see Records).
+///
+/// With a queue depth of 0 there is no writer thread: the chunks are 
+/// written at once by the event loop threads, under a lock.
+
+class RecordWriterThread
+{
+  public:
+    static const G4int  kMaxLanes = 256;
+    static const size_t kMaxDepth = 64;
+
+  public:
+    RecordWriterThread(ColumnarWriter* writers);
+   ~RecordWriterThread();
+
+  public:
+    // master
+    void Start(G4int depth);
+    void Stop();
+    
+    // event loop threads: hand over a full chunk, get an empty one of the
+    // same table and capacity
+    RecordChunk* Push(RecordChunk*, ColumnarWriter* target = 0);
+    void         Flush();
+    
+    uint64_t GetNbChunks() const { return fNbChunks; };
+    uint64_t GetNbStalls() const { return fNbStalls; };
+
+  private:
+    struct Item {
+      RecordChunk*    fChunk;
+      ColumnarWriter* fTarget;
+    };
+    struct alignas(64) Lane {
+      Lane() : fPushed(0), fWritten(0), fFlushRequest(0), fFlushed(0) {};
+      SpscQueue<Item,kMaxDepth>         fFull;
+      SpscQueue<RecordChunk*,4>         fFree[RecordSchema::kNbTables];
+      uint64_t              fPushed;         // event loop thread only
+      std::atomic<uint64_t> fWritten;
+      std::atomic<uint64_t> fFlushRequest;
+      std::atomic<uint64_t> fFlushed;
+    };
+    
+    Lane*        GetLane();
+    void         Loop();
+    size_t       Drain();
+    void         Write(RecordChunk*, ColumnarWriter* target);
+    void         Wake();
+
+  private:
+    ColumnarWriter*         fWriters;
+    G4int                   fDepth;
+    
+    Lane                    fLanes[kMaxLanes];
+    std::atomic<G4int>      fNbLanes;
+    
+    std::thread             fThread;
+    std::mutex              fWakeMutex;
+    std::condition_variable fWakeCondition;
+    G4bool                  fStop;
+    std::atomic<G4bool>     fRunning;
+    
+    std::mutex              fWriteMutex;
+    std::atomic<uint64_t>   fNbChunks;
+    std::atomic<uint64_t>   fNbStalls;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
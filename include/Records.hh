@@ -0,0 +1,135 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Records.hh
+/// \brief Definition of the Records class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef Records_h
+#define Records_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "ColumnarWriter.hh"
+#include "RecordChunk.hh"
+#include "RecordWriterThread.hh"
+#include "RecordMerger.hh"
+
+#include <mutex>
+#include <vector>
+
+class RecordsMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Crossing and capture records, beside the ntuples of the analysis 
+/// manager, in the columnar format of ColumnarWriter: one file per table,
+/// <file>_crossing.h04c and <file>_capture.h04c, listed in the manifest
+/// <file>.h04m (see RecordMerger).
+///
+/// Each event loop thread fills its own chunks of rows (typed columns, 
+/// no lock); a full chunk is handed to the writer thread (see 
+/// RecordWriterThread), which writes it as a block per column. The event
+/// of a record is its random stream with /testhadr/random/engine philox, 
+/// its event ID otherwise.
+///
+/// With /testhadr/records/shards, the chunks of each thread go to files 
+/// of its own, <file>_<table>_t<thread>.h04c: no file is shared by the
+/// threads. The shards are merged by Hadr04 -m in a campaign, or at the 
+/// end of the run with /testhadr/records/mergeShards.
+
+class Records
+{
+  public:
+    static Records* Instance();
+   ~Records();
+
+  public:
+    void SetEnabled(G4bool flag)           { fEnabled = flag; };
+    void SetFileName(const G4String& name) { fFileName = name; };
+    void SetChunkRows(G4int n)             { fChunkRows = n; };
+    void SetCodec(G4int codec)             { fCodec = codec; };
+    void SetQueueDepth(G4int n)            { fQueueDepth = n; };
+    void SetShards(G4bool flag)            { fShards = flag; };
+    void SetMergeShards(G4bool flag)       { fMergeShards = flag; };
+    
+    // master
+    void BeginOfRun();
+    void EndOfRun();
+    
+    // event loop threads
+    void BeginOfEvent(G4int eventID);
+    void AddCrossing(G4int code, const G4ThreeVector& position, 
+                     G4double energy, G4double time);
+    void AddCapture(const G4ThreeVector& position, G4double time, 
+                    G4double gammaSum);
+    // records of the events done by this thread in the files (checkpoint)
+    void FlushThread();
+    void EndOfThreadRun();
+
+  private:
+    Records();
+    
+    RecordChunk*&   GetChunk(G4int table);
+    ColumnarWriter* GetShard(G4int table);
+    void            Flush(RecordChunk*&);
+    void            CloseShards(std::vector<RecordMerger::Shard>&);
+    void            MergeShards(std::vector<RecordMerger::Shard>&);
+
+  private:
+    G4bool   fEnabled;
+    G4String fFileName;
+    G4int    fChunkRows;
+    G4int    fCodec;
+    G4int    fQueueDepth;
+    G4bool   fShards;
+    G4bool   fMergeShards;
+    
+    // current run
+    G4bool             fActive;
+    G4int              fRunCount;
+    G4String           fNames[RecordSchema::kNbTables];
+    G4String           fManifestName;
+    ColumnarWriter     fWriters[RecordSchema::kNbTables];
+    RecordWriterThread fWriterThread;
+    
+    // shards of the current run
+    struct ShardWriter {
+      G4int           fTable;
+      G4int           fThread;
+      ColumnarWriter* fWriter;
+    };
+    std::vector<ShardWriter> fShardWriters;
+    std::mutex               fShardMutex;
+    
+    RecordsMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,70 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RecordsMessenger.hh
+/// \brief Definition of the RecordsMessenger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef RecordsMessenger_h
+#define RecordsMessenger_h 1
+
+#include "globals.hh"
+#include "G4UImessenger.hh"
+
+class Records;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class RecordsMessenger: public G4UImessenger
+{
+  public:
+    RecordsMessenger(Records*);
+   ~RecordsMessenger();
+    
+    virtual void SetNewValue(G4UIcommand*, G4String);
+    
+  private:    
+    Records*              fRecords;
+    
+    G4UIdirectory*        fRecordsDir;
+    G4UIcmdWithABool*     fEnableCmd;
+    G4UIcmdWithAString*   fFileCmd;
+    G4UIcmdWithAnInteger* fChunkRowsCmd;
+    G4UIcmdWithAString*   fCompressionCmd;
+    G4UIcmdWithAnInteger* fQueueDepthCmd;
+    G4UIcmdWithABool*     fShardsCmd;
+    G4UIcmdWithABool*     fMergeShardsCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,71 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RegionThermalScatteringData.hh
+/// \brief Definition of the RegionThermalScatteringData class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef RegionThermalScatteringData_h
+#define RegionThermalScatteringData_h 1
+
+#include "globals.hh"
+#include "G4ParticleHPThermalScatteringData.hh"
+#include <vector>
+
+class G4HadronicInteraction;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Thermal scattering cross sections restricted to the materials of one
+/// region. At each BuildPhysicsTable the energy ranges of the two elastic
+/// models are set per material: below 4 eV, G4ParticleHPThermalScattering
+/// inside the region, the free-gas G4ParticleHPElastic everywhere else.
+
+class RegionThermalScatteringData : public G4ParticleHPThermalScatteringData
+{
+  public:
+    RegionThermalScatteringData(const G4String& region,
+                                G4HadronicInteraction* freeGas,
+                                G4HadronicInteraction* thermal);
+   ~RegionThermalScatteringData();
+
+  public:
+    virtual G4bool IsIsoApplicable(const G4DynamicParticle*, G4int, G4int,
+                                   const G4Element*, const G4Material*);
+    virtual void BuildPhysicsTable(const G4ParticleDefinition&);
+
+  private:
+    G4String               fRegionName;
+    G4HadronicInteraction* fFreeGas;
+    G4HadronicInteraction* fThermal;
+    std::vector<G4bool>    fInRegion;    // indexed by material index
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -37,14 +37,31 @@
 #include "G4VProcess.hh"
 #include "globals.hh"
 #include <map>
+#include <vector>
 
 class DetectorConstruction;
 class G4ParticleDefinition;
+class RunSummary;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class Run : public G4Run
 {
+  public:
+    // cost of one event
+    struct EventCost {
+     EventCost()
+       : fEventID(0), fThread(0), fStream(-1), fTime(0.),
+         fNbSteps(0), fNbSecondaries(0) {}
+     G4int     fEventID;
+     G4int     fThread;
+     G4long    fStream;          // -1 without counter-based random streams
+     G4double  fTime;            // wall time, in s
+     G4long    fNbSteps;
+     G4long    fNbSecondaries;
+     G4String  fWhere;           // where the time went, see EventAction
+    };
+
   public:
     Run(DetectorConstruction*);
    ~Run();
@@ -53,11 +70,38 @@ class Run : public G4Run
     void CountProcesses(const G4VProcess* process);                  
     void ParticleCount(G4String, G4double);
     void SumTrackLength (G4int,G4int,G4double,G4double,G4double,G4double);
+    void AddEventTime(G4double start, G4double end);
+    
+    // totals of the event costs; true if the event is among the slowest
+    // ones of this thread, to be then given with AddSlowEvent
+    G4bool AddEventCost(G4double time, G4long nbSteps, G4long nbSecondaries);
+    void   AddSlowEvent(const EventCost&);
+    
+    // tracks killed by the Watchdog, events where it happened
+    void AddKilledTrack(G4int breach, G4double weight);
+    void AddWatchdogEvent(const EventCost&);
+    
+    // wall clock, in seconds, common to all threads
+    static G4double WallClock();
     
     void SetPrimary(G4ParticleDefinition* particle, G4double energy);    
     void EndOfRun(); 
             
     virtual void Merge(const G4Run*);
+    
+    // pairwise reduction of the worker runs, see Run.cc
+    void Reduce();
+    void CollectReduced();
+    void SetWriteTime(G4double time) { fWriteTime = time; };
+    
+    // counters in the mergeable form of RunSummary
+    void   FillSummary(RunSummary&) const;
+    void   AddSummary(const RunSummary&);
+    G4bool WriteSummary(const G4String& fileName) const;
+    
+    // rows added to the ntuples of this thread
+    void  CountNtupleRow(G4int id);
+    const std::vector<G4int>& GetNtupleRows() const { return fNtupleRows; };
    
   private:
     struct ParticleData {
@@ -70,6 +114,25 @@ class Run : public G4Run
      G4double  fEmin;
      G4double  fEmax;
     };
+    
+    // busy time of one worker thread
+    struct ThreadLoad {
+     ThreadLoad(G4int thread)
+       : fThread(thread), fNbEvents(0), fBusy(0.), fFirst(0.), fLast(0.),
+         fMaxEvent(0.) {}
+     G4int     fThread;
+     G4int     fNbEvents;
+     G4double  fBusy;
+     G4double  fFirst, fLast;    // start of first and end of last event
+     G4double  fMaxEvent;
+    };
+    
+    void MergeSummaries(const Run*);
+    void PrintThreadLoads();
+    void PrintMergeStatistics();
+    void PrintEventCosts();
+    void PrintWatchdog();
+    void KeepSlowest(size_t nbSlowest);
      
   private:
     DetectorConstruction* fDetector;
@@ -82,6 +145,30 @@ class Run : public G4Run
     G4int    fNbStep1, fNbStep2;
     G4double fTrackLen1, fTrackLen2;
     G4double fTime1, fTime2;    
+    
+    // load balance: per-thread busy time, log histogram of event times
+    G4double                fRunStart;
+    std::vector<ThreadLoad> fThreadLoads;
+    std::vector<G4int>      fEventTimeHisto;
+    
+    // event costs: totals, slowest events
+    G4long                  fNbSteps;
+    G4long                  fNbSecondaries;
+    std::vector<EventCost>  fSlowEvents;
+    
+    // watchdog: killed tracks and weights by breach, first events
+    std::vector<G4int>      fKilledTracks;
+    std::vector<G4double>   fKilledWeight;
+    std::vector<EventCost>  fWatchdogEvents;
+    
+    // reduction of the worker runs
+    G4int    fNbReduced;       // worker runs summed in this one
+    G4int    fMergeDepth;      // depth of the reduction tree
+    G4double fMergeTime;       // time spent merging, summed over threads
+    G4double fWriteTime;       // time spent in analysis Write, idem
+    G4double fReducedAt;       // wall clock at the end of the reduction
+    
+    std::vector<G4int> fNtupleRows;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,148 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RunManager.hh
+/// \brief Definition of the RunManager class template
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef RunManager_h
+#define RunManager_h 1
+
+#include "globals.hh"
+#include "EventChunkPolicy.hh"
+#include "CampaignRunManager.hh"
+#include "Convergence.hh"
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
+#include "G4Event.hh"
+#include "G4RNGHelper.hh"
+
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Multi-threaded run manager of the application: TBase is G4MTRunManager
+/// or, from Geant4 10.7, G4TaskRunManager (the tasking pool balances the
+/// event chunks between threads by work stealing). At each BeamOn the
+/// modulo of the policy is the one fixed with /run/eventModulo, if any, 
+/// or else computed by the EventChunkPolicy; /run/eventModulo itself is 
+/// left untouched. Each time a worker asks for new events the chunk is
+/// resized by the policy from the number of events still to be processed.
+///
+/// The events are set up here rather than by the base class: its lock 
+/// (setUpEventMutex) is local to its source file, and the chunk must be
+/// computed and applied with the counters of events under the same lock.
+/// All the workers go through these methods, under fSetUpMutex.
+/// In a campaign, BeamOn runs the share of this process (CampaignRunManager).
+/// No more events are dispatched once an adaptive run has converged.
+
+template <class TBase>
+class RunManager : public CampaignRunManager<TBase>
+{
+  public:
+    RunManager() : CampaignRunManager<TBase>(), 
+                   fPolicyModulo(1), fFixedModulo(false) {};
+   ~RunManager() {};
+
+  public:
+    virtual void InitializeEventLoop(G4int nEvents, const char* macroFile = 0,
+                                     G4int nSelect = -1)
+    {
+      // /run/eventModulo, 0 if not set
+      G4int modulo = TBase::GetEventModulo();
+      fFixedModulo = modulo > 0;
+      fPolicyModulo = fFixedModulo ? modulo 
+        : fChunkPolicy.ComputeModulo(nEvents, TBase::GetNumberOfThreads());
+      TBase::InitializeEventLoop(nEvents, macroFile, nSelect);
+    };
+
+    virtual G4bool SetUpAnEvent(G4Event* evt, long& s1, long& s2, long& s3,
+                                G4bool reseedRequired = true)
+    {
+      if (Convergence::Instance()->IsDone()) return false;
+      G4AutoLock lock(&fSetUpMutex);
+      if (TBase::numberOfEventProcessed >= TBase::numberOfEventToBeProcessed ||
+          TBase::runAborted) return false;
+      evt->SetEventID(TBase::numberOfEventProcessed);
+      if (reseedRequired) {
+        G4RNGHelper* helper = G4RNGHelper::GetInstance();
+        G4int index = TBase::nSeedsPerEvent*TBase::nSeedsUsed;
+        s1 = helper->GetSeed(index);
+        s2 = helper->GetSeed(index + 1);
+        if (TBase::nSeedsPerEvent == 3) s3 = helper->GetSeed(index + 2);
+        if (++TBase::nSeedsUsed == TBase::nSeedsFilled) TBase::RefillSeeds();
+      }
+      TBase::numberOfEventProcessed++;
+      return true;
+    };
+
+    virtual G4int SetUpNEvents(G4Event* evt, G4SeedsQueue* seedsQueue,
+                               G4bool reseedRequired = true)
+    {
+      if (Convergence::Instance()->IsDone()) return 0;
+      G4AutoLock lock(&fSetUpMutex);
+      G4int nRemaining = TBase::numberOfEventToBeProcessed
+                       - TBase::numberOfEventProcessed;
+      if (nRemaining <= 0 || TBase::runAborted) return 0;
+      
+      // chunk of the policy, in the same critical section as the counters
+      G4int chunk = fFixedModulo ? fPolicyModulo 
+        : fChunkPolicy.NextChunk(nRemaining, TBase::GetNumberOfThreads(), 
+                                 fPolicyModulo);
+      chunk = std::max(1, std::min(chunk, nRemaining));
+      
+      evt->SetEventID(TBase::numberOfEventProcessed);
+      if (reseedRequired) {
+        G4RNGHelper* helper = G4RNGHelper::GetInstance();
+        G4int nbSeeded = (TBase::SeedOncePerCommunication() > 0) ? 1 : chunk;
+        for (G4int i=0; i<nbSeeded; ++i) {
+          G4int index = TBase::nSeedsPerEvent*TBase::nSeedsUsed;
+          seedsQueue->push(helper->GetSeed(index));
+          seedsQueue->push(helper->GetSeed(index + 1));
+          if (TBase::nSeedsPerEvent == 3) {
+            seedsQueue->push(helper->GetSeed(index + 2));
+          }
+          if (++TBase::nSeedsUsed == TBase::nSeedsFilled) TBase::RefillSeeds();
+        }
+      }
+      TBase::numberOfEventProcessed += chunk;
+      return chunk;
+    };
+
+    EventChunkPolicy* GetChunkPolicy() { return &fChunkPolicy; };
+
+  private:
+    EventChunkPolicy fChunkPolicy;
+    G4int            fPolicyModulo;    // /run/eventModulo, or by the policy
+    G4bool           fFixedModulo;     // by /run/eventModulo: no adaptation
+    G4Mutex          fSetUpMutex;      // event counters of the base
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
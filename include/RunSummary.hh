@@ -0,0 +1,86 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RunSummary.hh
+/// \brief Definition of the RunSummary class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef RunSummary_h
+#define RunSummary_h 1
+
+#include "globals.hh"
+#include <iostream>
+#include <map>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Counters of a Run (process calls, created particles, parcours of the
+/// incident neutron) in a text form that can be summed between processes.
+/// One "key values" record per line; lengths, times and energies are in
+/// Geant4 internal units (mm, ns, MeV).
+
+class RunSummary
+{
+  public:
+    struct ParticleData {
+     ParticleData()
+       : fCount(0), fEsum(0.), fEmin(0.), fEmax(0.) {}
+     ParticleData(G4int count, G4double esum, G4double emin, G4double emax)
+       : fCount(count), fEsum(esum), fEmin(emin), fEmax(emax) {}
+     G4int     fCount;
+     G4double  fEsum;
+     G4double  fEmin;
+     G4double  fEmax;
+    };
+
+  public:
+    RunSummary();
+   ~RunSummary();
+
+  public:
+    G4bool Write(const G4String& fileName) const;
+    G4bool Read(const G4String& fileName);
+    void   Write(std::ostream&) const;
+    G4bool Read(std::istream&, const G4String& source);
+    void   Add(const RunSummary&);
+    void   Print() const;
+
+  public:
+    G4int    fNbEvents;
+    G4String fPrimary;
+    G4double fEkin;
+    G4int    fNbStep1, fNbStep2;
+    G4double fTrackLen1, fTrackLen2;
+    G4double fTime1, fTime2;
+    std::map<G4String,G4int>        fProcCounter;
+    std::map<G4String,ParticleData> fParticleDataMap;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
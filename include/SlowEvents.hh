@@ -0,0 +1,73 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SlowEvents.hh
+/// \brief Definition of the SlowEvents class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef SlowEvents_h
+#define SlowEvents_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+
+class SlowEventsMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Settings of the capture of the slowest events of a run (see 
+/// Run::AddEventCost), and their replay. An event is identified by its
+/// counter-based random stream (/testhadr/random/engine philox): 
+/// /run/replayEvent <stream> runs this event alone, whatever the thread 
+/// and the run it came from.
+
+class SlowEvents
+{
+  public:
+    static SlowEvents* Instance();
+   ~SlowEvents();
+
+  public:
+    void  SetNbSlowest(G4int n)   { fNbSlowest = n; };
+    G4int GetNbSlowest() const    { return fNbSlowest; };
+    
+    // a run of the single event of this random stream
+    void Replay(uint64_t stream);
+
+  private:
+    SlowEvents();
+
+  private:
+    G4int                fNbSlowest;
+    SlowEventsMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
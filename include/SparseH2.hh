@@ -0,0 +1,142 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SparseH2.hh
+/// \brief Definition of the SparseH2 class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef SparseH2_h
+#define SparseH2_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// 2D histogram of fixed binning which stores only its occupied bins, in 
+/// an open addressing hash table (linear probing, at most half full): its
+/// memory grows with the bins hit, not with nx*ny. 
+/// Bins are numbered as in the tools axes: 0 underflow, 1 to n, n+1 
+/// overflow. Histograms of same binning are summed with Add(); they are
+/// written as a list of occupied bins (COO) or as the full nx*ny grid.
+///
+/// Write() gives the raw sums in a binary file, little endian: "H04H", 
+/// u32 version (1), u32 nx ny, f64 xmin xmax ymin ymax (mm), f64 unit, 
+/// unit name (u32 length, chars), u32 text formats (bit 0 COO, bit 1 
+/// dense), u64 occupied bins, then per bin: u64 key (ix << 32 | iy), 
+/// f64 sumw sumw2, u32 entries. Files of same binning are summed with 
+/// Read() and Add(), and their text written again, by CampaignMerger.
+
+class SparseH2
+{
+  public:
+    SparseH2(G4int nx, G4double xmin, G4double xmax,
+             G4int ny, G4double ymin, G4double ymax);
+   ~SparseH2();
+
+  public:
+    void Fill(G4double x, G4double y, G4double weight = 1.)
+    {
+      Cell& cell = Find(Key(Bin(x, fXmin, fXscale, fNx), 
+                            Bin(y, fYmin, fYscale, fNy)));
+      cell.fEntries++;
+      cell.fSw  += weight;
+      cell.fSw2 += weight*weight;
+    };
+    
+    // sum of a histogram of same binning; false otherwise
+    G4bool Add(const SparseH2&);
+    void   Reset();
+    
+    size_t GetNbOccupied() const  { return fNbOccupied; };
+    size_t GetMemory() const      { return fCells.size()*sizeof(Cell); };
+    size_t GetDenseMemory() const;
+    
+    // values of x and y in the given unit
+    G4bool WriteCoo(const G4String& fileName, 
+                    G4double unit, const G4String& unitName) const;
+    G4bool WriteDense(const G4String& fileName,
+                      G4double unit, const G4String& unitName) const;
+    
+    // raw sums, with the unit and the text formats to write from them
+    G4bool Write(const G4String& fileName, G4double unit, 
+                 const G4String& unitName, G4int formats) const;
+    static SparseH2* Read(const G4String& fileName, G4double& unit,
+                          G4String& unitName, G4int& formats);
+
+  private:
+    struct Cell {
+      uint64_t fKey;
+      G4double fSw, fSw2;
+      uint32_t fEntries;
+    };
+    static const uint64_t kEmpty = ~uint64_t(0);
+    
+    static G4int Bin(G4double v, G4double vmin, G4double scale, G4int n)
+    {
+      G4double u = (v - vmin)*scale;
+      if (!(u >= 0.)) return 0;
+      if (u >= n) return n + 1;
+      return G4int(u) + 1;
+    };
+    static uint64_t Key(G4int ix, G4int iy) 
+      { return uint64_t(uint32_t(ix)) << 32 | uint32_t(iy); };
+      
+    Cell& Find(uint64_t key)
+    {
+      size_t mask = fCells.size() - 1;
+      size_t i = Hash(key);
+      while (fCells[i].fKey != key) {
+        if (fCells[i].fKey == kEmpty) return Insert(key);
+        i = (i + 1) & mask;
+      }
+      return fCells[i];
+    };
+    size_t Hash(uint64_t key) const
+      { return (key*0x9E3779B97F4A7C15ULL) >> fShift; };
+    Cell& Insert(uint64_t key);
+    void  Grow();
+    
+    // occupied cells, sorted by bin (y, then x)
+    std::vector<const Cell*> SortedCells() const;
+
+  private:
+    G4int    fNx, fNy;
+    G4double fXmin, fXmax, fXscale;
+    G4double fYmin, fYmax, fYscale;
+    
+    std::vector<Cell> fCells;      // a power of 2
+    G4int             fShift;      // 64 - log2(size)
+    size_t            fNbOccupied;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,206 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SparseMesh.hh
+/// \brief Definition of the SparseMesh class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef SparseMesh_h
+#define SparseMesh_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Cartesian mesh of nx*ny*nz voxels, stored by blocks of 8x8x8 voxels
+/// allocated at their first score: the memory grows with the region 
+/// reached, not with the extent of the mesh. The blocks are found by an
+/// open addressing hash table of their coordinates (linear probing, at
+/// most half full); each holds the sums of the event scores and of their
+/// squares of its voxels.
+///
+/// A voxel is given by its key, ix << 42 | iy << 21 | iz (up to 2^21 
+/// voxels per axis). Traverse() walks a segment through the voxels by 3D
+/// DDA (Amanatides and Woo): one step per voxel boundary crossed, giving
+/// the length of the segment in each voxel.
+///
+/// Write() gives a binary file, little endian: "H04V", u32 version (1), 
+/// u32 nx ny nz, f64 lower corner and upper corner (mm), u64 events, 
+/// u64 blocks, then per block: u32 bx by bz (block coordinates), 
+/// f64 sum[512], f64 sum2[512] (voxel ix = 8 bx + i, i the fastest
+/// index being z, then y, then x). Files of same mesh are summed block 
+/// by block with Read() and Add(), as done by CampaignMerger.
+
+class SparseMesh
+{
+  public:
+    static const G4int kBlockBits  = 3;
+    static const G4int kBlockSide  = 1 << kBlockBits;
+    static const G4int kBlockSize  = kBlockSide*kBlockSide*kBlockSide;
+    
+    SparseMesh(G4int nx, G4int ny, G4int nz, 
+               const G4ThreeVector& lower, const G4ThreeVector& upper);
+   ~SparseMesh();
+
+  public:
+    G4int GetNx() const                { return fN[0]; };
+    G4int GetNy() const                { return fN[1]; };
+    G4int GetNz() const                { return fN[2]; };
+    G4double GetVoxelVolume() const    { return fSize[0]*fSize[1]*fSize[2]; };
+    
+    static uint64_t Key(G4int ix, G4int iy, G4int iz) 
+    { 
+      return uint64_t(ix) << 42 | uint64_t(iy) << 21 | uint64_t(iz); 
+    };
+    
+    // key of the voxel of a point; false if outside the mesh
+    G4bool Find(const G4ThreeVector& point, uint64_t& key) const;
+    
+    // calls function(key, length) for each voxel crossed by the segment
+    // from a to b, within the mesh
+    template <class F> void Traverse(const G4ThreeVector& a, 
+                                     const G4ThreeVector& b, F& function) const;
+    
+    // score of one event in a voxel: added to its sums
+    void AddEventScore(uint64_t key, G4double score);
+    
+    // sums of a mesh of same binning; false otherwise
+    G4bool Add(const SparseMesh&);
+    
+    // sum of the scores of all voxels
+    G4double GetTotal() const;
+    
+    size_t GetNbBlocks() const         { return fBlocks.size(); };
+    size_t GetMemory() const;
+    G4double GetDenseMemory() const;
+    
+    G4bool Write(const G4String& fileName, G4long nbEvents) const;
+    
+    // mesh of a file given by Write, 0 if it cannot be read
+    static SparseMesh* Read(const G4String& fileName, G4long& nbEvents);
+
+  private:
+    struct Block {
+      G4double fSum[kBlockSize];
+      G4double fSum2[kBlockSize];
+    };
+    struct Slot {
+      uint64_t fKey;                   // block coordinates
+      G4int    fBlock;                 // in fBlocks, -1 if empty
+    };
+    
+    Block& GetBlock(uint64_t blockKey);
+    void   Grow();
+    size_t Hash(uint64_t key) const
+      { return (key*0x9E3779B97F4A7C15ULL) >> fShift; };
+
+  private:
+    G4int    fN[3];
+    G4double fLower[3], fUpper[3], fSize[3];
+    
+    std::vector<Block*> fBlocks;
+    std::vector<Slot>   fSlots;        // a power of 2
+    G4int               fShift;        // 64 - log2(size)
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <class F> 
+void SparseMesh::Traverse(const G4ThreeVector& a, const G4ThreeVector& b,
+                          F& function) const
+{
+  // segment a + t (b - a), t in [0,1], in voxel units
+  G4double u[3], d[3];
+  for (G4int k=0; k<3; ++k) {
+    u[k] = (a[k] - fLower[k])/fSize[k];
+    d[k] = (b[k] - a[k])/fSize[k];
+  }
+  
+  // clipped to the mesh, slab by slab
+  G4double t0 = 0., t1 = 1.;
+  for (G4int k=0; k<3; ++k) {
+    if (d[k] == 0.) {
+      if (u[k] < 0. || u[k] >= fN[k]) return;
+      continue;
+    }
+    G4double ta = -u[k]/d[k], tb = (fN[k] - u[k])/d[k];
+    if (ta > tb) std::swap(ta, tb);
+    t0 = std::max(t0, ta);
+    t1 = std::min(t1, tb);
+  }
+  if (!(t0 < t1)) return;
+  G4double length = (b - a).mag();
+  
+  // first voxel, and the t of the next boundary along each axis
+  G4int index[3], step[3];
+  G4double tMax[3], tDelta[3];
+  G4double tMiddle = 0.5*(t0 + std::min(t1, t0 + 1.e-9));
+  for (G4int k=0; k<3; ++k) {
+    G4double position = u[k] + tMiddle*d[k];
+    index[k] = std::min(std::max(G4int(std::floor(position)), 0), fN[k] - 1);
+    if (d[k] > 0.) {
+      step[k] = 1;
+      tMax[k] = (index[k] + 1 - u[k])/d[k];
+      tDelta[k] = 1./d[k];
+    }
+    else if (d[k] < 0.) {
+      step[k] = -1;
+      tMax[k] = (index[k] - u[k])/d[k];
+      tDelta[k] = -1./d[k];
+    }
+    else {
+      step[k] = 0;
+      tMax[k] = tDelta[k] = DBL_MAX;
+    }
+  }
+  
+  G4double t = t0;
+  while (t < t1) {
+    G4int k = (tMax[0] < tMax[1]) ? ((tMax[0] < tMax[2]) ? 0 : 2)
+                                  : ((tMax[1] < tMax[2]) ? 1 : 2);
+    G4double tNext = std::min(tMax[k], t1);
+    if (tNext > t) {
+      function(Key(index[0], index[1], index[2]), (tNext - t)*length);
+    }
+    t = tNext;
+    index[k] += step[k];
+    if (index[k] < 0 || index[k] >= fN[k]) break;
+    tMax[k] += tDelta[k];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
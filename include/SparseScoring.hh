@@ -0,0 +1,121 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SparseScoring.hh
+/// \brief Definition of the SparseScoring class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef SparseScoring_h
+#define SparseScoring_h 1
+
+#include "globals.hh"
+#include "SparseH2.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class SparseScoringMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// High resolution maps of the test planes, as SparseH2 histograms: a map
+/// defined for an H2 id (/testhadr/sparse/h2) gets the fills of that H2,
+/// with its own binning, whether the H2 itself is active or not.
+///
+/// Each event loop thread fills maps of its own, created at its first 
+/// fill of the run; they are summed at the end of the thread run, and
+/// the sums written by the master to <file>_sparse<id>.coo (occupied
+/// bins) and/or <file>_sparse<id>.dense (full grid), and as raw sums to
+/// <file>_sparse<id>.h04h (see SparseH2), merged over a campaign.
+
+class SparseScoring
+{
+  public:
+    enum EFormat { kCoo = 1, kDense = 2 };
+    static const G4int kMaxH2 = 64;
+    
+    static SparseScoring* Instance();
+   ~SparseScoring();
+
+  public:
+    // binning in internal units; the unit is that of the files
+    void Define(G4int id, G4int nx, G4double xmin, G4double xmax,
+                G4int ny, G4double ymin, G4double ymax, 
+                const G4String& unitName);
+    void Clear()                           { fDefinitions.clear(); };
+    void SetFileName(const G4String& name) { fFileName = name; };
+    void SetFormat(G4int format)           { fFormat = format; };
+    
+    // master
+    void BeginOfRun();
+    void EndOfRun();
+    
+    // event loop threads: one branch if the H2 has no map
+    void FillH2(G4int id, G4double x, G4double y, G4double weight)
+    {
+      if ((unsigned)id < (unsigned)kMaxH2 && 
+          (fH2Mask.load(std::memory_order_relaxed) >> id & 1)) 
+        Fill(id, x, y, weight);
+    };
+    void EndOfThreadRun();
+    
+    // H2 ids with a map in the current run, set by BeginOfRun
+    uint64_t GetH2Mask() const 
+      { return fH2Mask.load(std::memory_order_relaxed); };
+
+  private:
+    SparseScoring();
+    
+    void Fill(G4int id, G4double x, G4double y, G4double weight);
+
+  private:
+    struct Definition {
+      G4int     fId;
+      G4int     fNx, fNy;
+      G4double  fXmin, fXmax, fYmin, fYmax;
+      G4String  fUnitName;
+      SparseH2* fSum;
+    };
+    std::vector<Definition> fDefinitions;
+    G4String                fFileName;
+    G4int                   fFormat;
+    
+    // current run
+    std::atomic<uint64_t> fH2Mask;
+    G4int                 fRunCount;
+    G4int                 fIndex[kMaxH2];      // of the definitions
+    std::mutex            fSumMutex;
+    
+    SparseScoringMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
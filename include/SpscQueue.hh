@@ -0,0 +1,92 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SpscQueue.hh
+/// \brief Definition of the SpscQueue class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef SpscQueue_h
+#define SpscQueue_h 1
+
+#include "globals.hh"
+
+#include <atomic>
+#include <cstddef>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Bounded lock-free queue of N values (N a power of 2) between a single
+/// producer thread and a single consumer thread. The producer owns the 
+/// tail, the consumer the head, each on its own cache line; a value is 
+/// published by the release store of the tail.
+
+template <class T, size_t N>
+class SpscQueue
+{
+  public:
+    SpscQueue() : fHead(0), fTail(0) {};
+
+  public:
+    // producer: false if the queue is full
+    G4bool Push(const T& value)
+    {
+      size_t tail = fTail.load(std::memory_order_relaxed);
+      if (tail - fHead.load(std::memory_order_acquire) >= N) return false;
+      fItems[tail & (N-1)] = value;
+      fTail.store(tail + 1, std::memory_order_release);
+      return true;
+    };
+    
+    // consumer: false if the queue is empty
+    G4bool Pop(T& value)
+    {
+      size_t head = fHead.load(std::memory_order_relaxed);
+      if (head == fTail.load(std::memory_order_acquire)) return false;
+      value = fItems[head & (N-1)];
+      fHead.store(head + 1, std::memory_order_release);
+      return true;
+    };
+    
+    // either side, approximate while the other one is active
+    size_t Size() const
+    { 
+      return fTail.load(std::memory_order_acquire) 
+           - fHead.load(std::memory_order_acquire); 
+    };
+
+  private:
+    static_assert((N & (N-1)) == 0, "SpscQueue: N must be a power of 2");
+    
+    T fItems[N];
+    alignas(64) std::atomic<size_t> fHead;
+    alignas(64) std::atomic<size_t> fTail;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,189 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StreamSink.hh
+/// \brief Definition of the StreamSink class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef StreamSink_h
+#define StreamSink_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "RecordChunk.hh"
+#include "SpscQueue.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class StreamSinkMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Live stream of the run to a local consumer, through a named pipe 
+/// (created if needed) or a UNIX domain socket (the consumer listens):
+/// batches of crossing and capture records (the tables of RecordSchema)
+/// and, every period, snapshots of chosen H1 histograms, with the binning
+/// of the analysis manager.
+///
+/// Frames, little endian: "H04S", u16 type, u16 version (1), u32 payload 
+/// size, u32 sequence number, then the payload:
+///   kHello     u32 run, u32 tables, per table: u8 length, name, u32 
+///              columns, per column: u8 type, u8 length, name
+///   kBatch     u8 table, 3 bytes 0, u32 thread lane, u32 rows, then the
+///              values column after column
+///   kHistogram u32 H1 id, u32 bins, f64 seconds since the start of the 
+///              run, f64 edges[bins+1], u64 entries[bins+2] (underflow 
+///              first, overflow last)
+///   kStats     u64 batches sent, u64 dropped, u64 discarded
+///   kEndOfRun  u32 run
+///
+/// The event loop threads never wait on the consumer. Their batches go
+/// through a bounded lock-free queue per thread to the sender thread; a
+/// batch is dropped when the queue is full, and discarded by the sender 
+/// thread when no consumer is connected or the consumer is too far
+/// behind. Both are counted and reported. The histogram entries are 
+/// counted per thread (one writer per slot, relaxed atomics, as in 
+/// Telemetry), thus complete whatever was dropped.
+
+class StreamSink
+{
+  public:
+    enum EFrame { kHello = 1, kBatch = 2, kHistogram = 3, kStats = 4,
+                  kEndOfRun = 5 };
+    
+    static const G4int kMaxLanes = 256;
+    static const G4int kMaxH1 = 64;
+    
+    static StreamSink* Instance();
+   ~StreamSink();
+
+  public:
+    void SetTarget(const G4String& path, G4bool socket)
+                                         { fPath = path; fSocket = socket; };
+    void SetEnabled(G4bool flag)         { fEnabled = flag; };
+    void SetPeriod(G4double seconds)     { fPeriod = seconds; };
+    void SetBatchRows(G4int n)           { fBatchRows = n; };
+    void AddH1(G4int id);
+    void ClearH1s()                      { fH1Ids.clear(); };
+    
+    // master
+    void BeginOfRun(G4int runID);
+    void EndOfRun();
+    
+    // event loop threads
+    void BeginOfEvent(G4int eventID);
+    void AddCrossing(G4int code, const G4ThreeVector& position, 
+                     G4double energy, G4double time);
+    void AddCapture(const G4ThreeVector& position, G4double time, 
+                    G4double gammaSum);
+    void EndOfEvent();
+    void EndOfThreadRun();
+    
+    // beside G4AnalysisManager::FillH1: one branch if not streamed
+    void FillH1(G4int id, G4double value)
+    { 
+      if ((unsigned)id < (unsigned)kMaxH1 && 
+          (fH1Mask.load(std::memory_order_relaxed) >> id & 1)) Count(id, value);
+    };
+
+  private:
+    StreamSink();
+    
+    struct Spectrum {
+      G4int                 fId;
+      G4double              fUnit;
+      std::vector<G4double> fEdges;
+      size_t                fOffset;    // of its entries in a slot
+    };
+    struct alignas(64) Lane {
+      Lane() : fEntries(0) {};
+      SpscQueue<RecordChunk*,16> fFull;
+      SpscQueue<RecordChunk*,4>  fFree[RecordSchema::kNbTables];
+      std::atomic<std::atomic<uint64_t>*> fEntries;   // of the thread
+    };
+    
+    Lane*        GetLane();
+    RecordChunk* GetChunk(G4int table);
+    void         Hand(RecordChunk*&);
+    void         Count(G4int id, G4double value);
+    
+    // sender thread
+    void Sender();
+    void Connect();
+    void Hello();
+    void Disconnect();
+    void Drain();
+    void Snapshot(G4bool last);
+    void Send(G4bool last);
+    void Frame(G4int type, const std::vector<char>& payload);
+
+  private:
+    G4String           fPath;
+    G4bool             fSocket;
+    G4bool             fEnabled;
+    G4double           fPeriod;
+    G4int              fBatchRows;
+    std::vector<G4int> fH1Ids;
+    
+    // current run
+    G4bool                fActive;
+    G4int                 fRunID;
+    G4int                 fRunCount;
+    G4double              fStart;
+    std::vector<Spectrum> fSpectra;
+    G4int                 fSpectrumIndex[kMaxH1];
+    size_t                fNbEntries;
+    std::atomic<uint64_t> fH1Mask;
+    
+    Lane                  fLanes[kMaxLanes];
+    std::atomic<G4int>    fNbLanes;
+    std::atomic<uint64_t> fNbDropped;
+    
+    // sender thread
+    std::thread             fSender;
+    std::mutex              fStopMutex;
+    std::condition_variable fStopCondition;
+    G4bool                  fStop;
+    G4int                   fFd;
+    G4double                fLastConnect;
+    std::vector<char>       fPending;
+    size_t                  fPendingStart;
+    uint32_t                fSequence;
+    uint64_t                fNbSent, fNbDiscarded;
+    
+    StreamSinkMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
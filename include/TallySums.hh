@@ -0,0 +1,88 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file TallySums.hh
+/// \brief Definition of the TallySums class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef TallySums_h
+#define TallySums_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Raw sums of a spectrum tally (see FluenceTally, PointDetector), entry
+/// by entry: its key (the text columns of the bin), the scale from the 
+/// mean score per event to the value printed, the sum of the event scores
+/// and of their squares, with the number of events.
+///
+/// Write() gives a binary file, little endian: "H04S", u32 version (1),
+/// u64 events, title and columns (u32 length, chars), u64 entries, then
+/// per entry: key (u32 length, chars), f64 scale, sum, sum2. WriteText()
+/// gives the lines "key value relError", value = scale*sum/events, at 
+/// precision 6. Files of same entries are summed with Read() and Add(), 
+/// as done by CampaignMerger, and the text written again from the sums.
+
+class TallySums
+{
+  public:
+    TallySums(const G4String& title, const G4String& columns);
+   ~TallySums();
+
+  public:
+    void   SetNbEvents(G4long n)    { fNbEvents = n; };
+    G4long GetNbEvents() const      { return fNbEvents; };
+    size_t GetNbEntries() const     { return fEntries.size(); };
+    
+    void   AddEntry(const G4String& key, G4double scale, 
+                    G4double sum, G4double sum2);
+    // sum of a tally of same entries; false otherwise
+    G4bool Add(const TallySums&);
+    
+    G4bool Write(const G4String& fileName) const;
+    G4bool WriteText(const G4String& fileName) const;
+    static TallySums* Read(const G4String& fileName);
+
+  private:
+    struct Entry {
+      G4String fKey;
+      G4double fScale, fSum, fSum2;
+    };
+    
+    G4String           fTitle;
+    G4String           fColumns;
+    G4long             fNbEvents;
+    std::vector<Entry> fEntries;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,124 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Telemetry.hh
+/// \brief Definition of the Telemetry class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef Telemetry_h
+#define Telemetry_h 1
+
+#include "globals.hh"
+#include "Convergence.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+class TelemetryMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Live telemetry of a run, for the batch monitoring. Each event loop 
+/// thread publishes its counters (events, steps, tally counts) at the end
+/// of each event into its own slot of a fixed array: one writer per slot,
+/// relaxed atomics, one cache line per slot, no lock; threads of ID 
+/// kMaxSlots and beyond get no slot and are not monitored. During the run a 
+/// monitor thread reads the slots every period and writes
+///   <file>.prom   Prometheus text format, replaced atomically
+///   <file>.jsonl  one JSON object per period, appended
+/// with the rates per thread, the resident memory of the process, the 
+/// relative errors of the tallies and the estimated time to completion.
+
+class Telemetry
+{
+  public:
+    static const G4int kMaxSlots = 256;
+    
+    static Telemetry* Instance();
+   ~Telemetry();
+
+  public:
+    void SetFileName(const G4String& name)  { fFileName = name; };
+    void SetPeriod(G4double seconds)        { fPeriod = seconds; };
+    void SetEnabled(G4bool flag)            { fEnabled = flag; };
+    
+    // master
+    void BeginOfRun(G4int runID, G4int nbEvents);
+    void EndOfRun();
+    
+    // event loop threads
+    void EndOfEvent(G4long nbSteps, 
+                    const G4double scores[Convergence::kNbTallies]);
+
+  private:
+    Telemetry();
+    
+    // counters of one thread
+    struct alignas(64) Slot {
+      std::atomic<uint64_t> fEvents;
+      std::atomic<uint64_t> fSteps;
+      std::atomic<uint64_t> fTallies[Convergence::kNbTallies];
+    };
+    
+    void Monitor();
+    void Publish(G4bool last);
+    static uint64_t ResidentMemory();
+
+  private:
+    G4String fFileName;
+    G4double fPeriod;
+    G4bool   fEnabled;
+    
+    Slot     fSlots[kMaxSlots];
+    std::atomic<G4bool> fUnmonitored;   // a thread had no slot
+    
+    // current run, monitor thread
+    G4int    fRunID;
+    G4int    fNbEvents;
+    G4double fStart;
+    G4String fHost;
+    G4String fPromName, fJsonName;
+    uint64_t fLastEvents[kMaxSlots];
+    uint64_t fLastSteps[kMaxSlots];
+    G4double fLastTime;
+    
+    std::thread             fMonitor;
+    std::mutex              fStopMutex;
+    std::condition_variable fStopCondition;
+    G4bool                  fStop;
+    G4bool                  fDiscard;   // stop without publishing
+    
+    TelemetryMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
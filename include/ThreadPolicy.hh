@@ -0,0 +1,60 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ThreadPolicy.hh
+/// \brief Definition of the ThreadPolicy class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ThreadPolicy_h
+#define ThreadPolicy_h 1
+
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Number of worker threads for the run manager, from (by priority):
+///   - the command line (-t N),
+///   - the environment variable HADR04_NTHREADS,
+///   - the CPUs actually granted to the process: the cgroup CPU quota
+///     (v2 cpu.max or v1 cfs_quota/cfs_period) and the affinity mask,
+///   - G4Threading::G4GetNumberOfCores().
+
+class ThreadPolicy
+{
+  public:
+    static G4int GetNumberOfThreads(G4int requested = 0);
+    
+    // components, for the printout; 0 when not available
+    static G4int GetEnvironmentThreads();
+    static G4int GetCgroupQuota();
+    static G4int GetAffinityCount();
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -36,12 +36,14 @@
 #include "G4UserTrackingAction.hh"
 #include "globals.hh"
 
+class EventAction;
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class TrackingAction : public G4UserTrackingAction {
 
   public:  
-    TrackingAction();
+    TrackingAction(EventAction*);
    ~TrackingAction() {};
    
     virtual void  PreUserTrackingAction(const G4Track*);   
@@ -50,6 +52,8 @@ class TrackingAction : public G4UserTrackingAction {
     void UpdateTrackInfo(G4double, G4double, G4double);    
     
   private:
+    EventAction* fEventAction;
+    G4double fTrackStart;
     G4int fNbStep1, fNbStep2;
     G4double fTrackLen1, fTrackLen2;
     G4double fTime1, fTime2;
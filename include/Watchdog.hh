@@ -0,0 +1,100 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Watchdog.hh
+/// \brief Definition of the Watchdog class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef Watchdog_h
+#define Watchdog_h 1
+
+#include "globals.hh"
+
+class G4Step;
+class WatchdogMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Budgets of steps and of CPU time (of the thread) per track and per 
+/// event, so that a stuck history cannot stall a worker. A track over its
+/// budget is killed; after an event is over its budget, every track left
+/// in it is killed with its secondaries at its next step. The weights of
+/// the killed tracks are tallied in the Run, and the events are logged 
+/// with their random stream for /run/replayEvent.
+///
+/// A budget of 0 is no limit (default). The CPU time is read every 
+/// kTimeCheckPeriod steps only.
+
+class Watchdog
+{
+  public:
+    enum Breach { kNone, kTrackSteps, kTrackTime, kEventSteps, kEventTime,
+                  kNbBreaches };
+    
+    static const G4int kTimeCheckPeriod = 32;
+
+  public:
+    static Watchdog* Instance();
+   ~Watchdog();
+
+  public:
+    static const char* GetBreachName(G4int breach);
+    
+    void SetMaxTrackSteps(G4long n)        { fMaxTrackSteps = n; };
+    void SetMaxEventSteps(G4long n)        { fMaxEventSteps = n; };
+    void SetMaxTrackTime(G4double seconds) { fMaxTrackTime = seconds; };
+    void SetMaxEventTime(G4double seconds) { fMaxEventTime = seconds; };
+    
+    // event loop threads
+    void BeginOfEvent();
+    void BeginOfTrack();
+    // kills the track of the step if over a budget
+    void Check(const G4Step*);
+
+  private:
+    Watchdog();
+    
+    G4bool IsActive() const
+      { return fMaxTrackSteps > 0 || fMaxEventSteps > 0 || 
+               fMaxTrackTime > 0. || fMaxEventTime > 0.; };
+    G4bool HasTimeLimit() const
+      { return fMaxTrackTime > 0. || fMaxEventTime > 0.; };
+    static G4double ThreadCpuTime();
+
+  private:
+    G4long   fMaxTrackSteps;
+    G4long   fMaxEventSteps;
+    G4double fMaxTrackTime;
+    G4double fMaxEventTime;
+    
+    WatchdogMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
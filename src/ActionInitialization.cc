@@ -69,7 +69,7 @@ void ActionInitialization::Build() const
   EventAction* eventAction = new EventAction(runAction);
   SetUserAction(eventAction);
   
-  TrackingAction* trackingAction = new TrackingAction();
+  TrackingAction* trackingAction = new TrackingAction(eventAction);
   SetUserAction(trackingAction);
   
   SteppingAction* steppingAction = new SteppingAction(eventAction, trackingAction);
@@ -0,0 +1,203 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ArgonCaptureCascade.cc
+/// \brief Implementation of the ArgonCaptureCascade class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ArgonCaptureCascade.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4AutoLock.hh"
+
+#include <fstream>
+#include <sstream>
+#include <map>
+
+namespace {
+  G4Mutex cascadeMutex = G4MUTEX_INITIALIZER;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ArgonCaptureCascade* ArgonCaptureCascade::Instance()
+{
+  static ArgonCaptureCascade instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ArgonCaptureCascade::ArgonCaptureCascade()
+: fSeparationEnergy(0.)
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ArgonCaptureCascade::~ArgonCaptureCascade()
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ArgonCaptureCascade::Load(const G4String& fileName)
+{
+  G4AutoLock lock(&cascadeMutex);
+  if (IsLoaded()) return true;
+
+  std::ifstream in(fileName);
+  if (!in) {
+    G4cout << "### ArgonCaptureCascade: cannot open " << fileName << G4endl;
+    return false;
+  }
+
+  std::map<G4int, G4double> levels;
+  std::vector< std::pair<G4int, Branch> > branches;
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream is(line);
+    std::string key;
+    if (!(is >> key) || key[0] == '#') continue;
+    if (key == "capture") {
+      is >> fSeparationEnergy;
+      fSeparationEnergy *= keV;
+    } else if (key == "level") {
+      G4int index; G4double energy;
+      if (is >> index >> energy) levels[index] = energy*keV;
+    } else if (key == "branch") {
+      G4int from; Branch branch;
+      if (is >> from >> branch.fTo >> branch.fIntensity)
+        branches.push_back(std::make_pair(from, branch));
+    }
+  }
+
+  // levels must be numbered 0..n-1, ground state first
+  G4int nbLevels = (G4int)levels.size();
+  G4bool valid = (nbLevels > 0 && fSeparationEnergy > 0.);
+  fLevelEnergy.assign(nbLevels, 0.);
+  for (G4int i=0; valid && i<nbLevels; ++i) {
+    valid = (levels.count(i) == 1);
+    if (valid) fLevelEnergy[i] = levels[i];
+  }
+  fBranches.assign(nbLevels+1, std::vector<Branch>());
+  for (size_t i=0; valid && i<branches.size(); ++i) {
+    G4int from = branches[i].first;
+    G4int to = branches[i].second.fTo;
+    valid = (from >= -1 && from < nbLevels && to >= 0 && to < nbLevels);
+    // transitions go down in energy: no loop is possible
+    if (valid) {
+      G4double efrom = (from < 0) ? fSeparationEnergy : fLevelEnergy[from];
+      valid = (fLevelEnergy[to] < efrom && branches[i].second.fIntensity > 0.);
+    }
+    if (valid) fBranches[from+1].push_back(branches[i].second);
+  }
+  for (G4int i=1; valid && i<nbLevels; ++i) {
+    // an excited level without branch decays to the ground state
+    if (fBranches[i+1].empty()) {
+      Branch ground = { 0, 1. };
+      fBranches[i+1].push_back(ground);
+    }
+  }
+  if (!valid || fBranches[0].empty()) {
+    G4cout << "### ArgonCaptureCascade: invalid level scheme in "
+           << fileName << G4endl;
+    fBranches.clear();
+    return false;
+  }
+
+  // enumerate all the cascades once
+  std::vector<G4double> gammas;
+  Enumerate(-1, 1., gammas);
+  BuildAliasTable(fPathProbability);
+
+  G4cout << " ArgonCaptureCascade: " << fileName << ", " << nbLevels
+         << " levels, " << fPaths.size() << " cascades, Sn = "
+         << fSeparationEnergy/keV << " keV" << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ArgonCaptureCascade::Enumerate(G4int level, G4double probability,
+                                    std::vector<G4double>& gammas)
+{
+  if (level == 0) {
+    fPaths.push_back(gammas);
+    fPathProbability.push_back(probability);
+    return;
+  }
+  const std::vector<Branch>& branches = fBranches[level+1];
+  G4double sum = 0.;
+  for (size_t i=0; i<branches.size(); ++i) sum += branches[i].fIntensity;
+
+  G4double energy = (level < 0) ? fSeparationEnergy : fLevelEnergy[level];
+  for (size_t i=0; i<branches.size(); ++i) {
+    gammas.push_back(energy - fLevelEnergy[branches[i].fTo]);
+    Enumerate(branches[i].fTo, probability*branches[i].fIntensity/sum, gammas);
+    gammas.pop_back();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ArgonCaptureCascade::BuildAliasTable(const std::vector<G4double>& prob)
+{
+  // Walker's alias method (Vose's construction)
+  G4int n = (G4int)prob.size();
+  fAliasProbability.assign(n, 1.);
+  fAlias.assign(n, 0);
+  std::vector<G4double> scaled(n);
+  std::vector<G4int> small, large;
+  for (G4int i=0; i<n; ++i) {
+    fAlias[i] = i;
+    scaled[i] = prob[i]*n;
+    if (scaled[i] < 1.) small.push_back(i);
+    else large.push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    G4int s = small.back(); small.pop_back();
+    G4int l = large.back(); large.pop_back();
+    fAliasProbability[s] = scaled[s];
+    fAlias[s] = l;
+    scaled[l] -= 1. - scaled[s];
+    if (scaled[l] < 1.) small.push_back(l);
+    else large.push_back(l);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const std::vector<G4double>&
+ArgonCaptureCascade::Sample(G4double r1, G4double r2) const
+{
+  G4int n = (G4int)fPaths.size();
+  G4int i = (G4int)(r1*n);
+  if (i >= n) i = n-1;
+  return fPaths[(r2 < fAliasProbability[i]) ? i : fAlias[i]];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
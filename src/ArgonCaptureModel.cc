@@ -0,0 +1,134 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ArgonCaptureModel.cc
+/// \brief Implementation of the ArgonCaptureModel class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ArgonCaptureModel.hh"
+#include "ArgonCaptureCascade.hh"
+
+#include "G4ParticleHPCapture.hh"
+#include "G4HadProjectile.hh"
+#include "G4Nucleus.hh"
+#include "G4Gamma.hh"
+#include "G4IonTable.hh"
+#include "G4RandomDirection.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ArgonCaptureModel::ArgonCaptureModel(const G4String& cascadeFile)
+: G4HadronicInteraction("ArgonCapture"), fHPCapture(0), fCascade(0),
+  fFileName(cascadeFile)
+{
+  SetMinEnergy(0.);
+  SetMaxEnergy(20.*MeV);
+  fHPCapture = new G4ParticleHPCapture();
+  fCascade = ArgonCaptureCascade::Instance();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ArgonCaptureModel::~ArgonCaptureModel()
+{
+  delete fHPCapture;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ArgonCaptureModel::BuildPhysicsTable(const G4ParticleDefinition& particle)
+{
+  fHPCapture->BuildPhysicsTable(particle);
+  // if the library is missing, every capture goes to ParticleHP
+  fCascade->Load(fFileName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4HadFinalState* ArgonCaptureModel::ApplyYourself(const G4HadProjectile& projectile,
+                                                  G4Nucleus& target)
+{
+  if (target.GetZ_asInt() != 18 || target.GetA_asInt() != 40 ||
+      !fCascade->IsLoaded()) {
+    return fHPCapture->ApplyYourself(projectile, target);
+  }
+
+  theParticleChange.Clear();
+  theParticleChange.SetStatusChange(stopAndKill);
+
+  const std::vector<G4double>& gammas
+    = fCascade->Sample(G4UniformRand(), G4UniformRand());
+
+  // kinetic energy available in the centre of mass
+  G4double ekinCM = projectile.GetKineticEnergy()*40./41.;
+  G4ThreeVector momentum = projectile.Get4Momentum().vect();
+
+  for (size_t i=0; i<gammas.size(); ++i) {
+    G4double energy = gammas[i];
+    if (i == 0) energy += ekinCM;
+    G4ThreeVector direction = G4RandomDirection();
+    theParticleChange.AddSecondary(
+      new G4DynamicParticle(G4Gamma::Gamma(), direction, energy));
+    momentum -= energy*direction;
+  }
+
+  // recoil nucleus, in its ground state
+  G4ParticleDefinition* ion = G4IonTable::GetIonTable()->GetIon(18, 41, 0.);
+  if (ion) {
+    G4double mass = ion->GetPDGMass();
+    G4double p = momentum.mag();
+    G4double ekin = p*p/(std::sqrt(p*p + mass*mass) + mass);
+    G4ThreeVector direction = (p > 0.) ? momentum/p : G4RandomDirection();
+    theParticleChange.AddSecondary(
+      new G4DynamicParticle(ion, direction, ekin));
+  }
+  return &theParticleChange;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const std::pair<G4double, G4double>
+ArgonCaptureModel::GetFatalEnergyCheckLevels() const
+{
+  return fHPCapture->GetFatalEnergyCheckLevels();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ArgonCaptureModel::ModelDescription(std::ostream& outFile) const
+{
+  outFile << "Neutron capture on Ar-40 with complete gamma cascades of\n"
+          << "Ar-41 sampled from a level-scheme library (" << fFileName
+          << "); G4ParticleHPCapture on the other targets.\n";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
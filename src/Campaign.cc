@@ -0,0 +1,222 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Campaign.cc
+/// \brief Implementation of the Campaign class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "Campaign.hh"
+#include "CampaignMerger.hh"
+#include "RandomStreams.hh"
+#include "ThreadPolicy.hh"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Campaign* Campaign::Instance()
+{
+  static Campaign instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Campaign::Campaign()
+: fIndex(0), fNbProcesses(0), fDirectory("."), fFirstEvent(0)
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Campaign::~Campaign()
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int Campaign::Launch(G4int nbProcesses, const G4String& directory,
+                       const std::vector<G4String>& arguments)
+{
+  if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+    G4cerr << "### Campaign: cannot create " << directory << ": " 
+           << std::strerror(errno) << G4endl;
+    return 1;
+  }
+  
+  // share the CPUs of the node unless the thread count is given
+  G4String threads;
+  if (!std::getenv("HADR04_NTHREADS")) {
+    G4int nbThreads = ThreadPolicy::GetNumberOfThreads()/nbProcesses;
+    std::ostringstream os;
+    os << ((nbThreads > 0) ? nbThreads : 1);
+    threads = os.str();
+  }
+  
+  G4cout << "\n Campaign of " << nbProcesses << " processes in " 
+         << directory << "/" << G4endl;
+  auto start = std::chrono::steady_clock::now();
+  
+  std::vector<pid_t> pids(nbProcesses, -1);
+  for (G4int k=0; k<nbProcesses; ++k) {
+    std::ostringstream process, log;
+    process << k << "/" << nbProcesses;
+    log << directory << "/log_p" << k << ".txt";
+    
+    pid_t pid = fork();
+    if (pid < 0) {
+      G4cerr << "### Campaign: fork failed: " << std::strerror(errno) 
+             << G4endl;
+      break;
+    }
+    if (pid == 0) {
+      // child: output to its log file, then the application again
+      G4int fd = open(log.str().c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644);
+      if (fd >= 0) { dup2(fd, 1); dup2(fd, 2); close(fd); }
+      if (!threads.empty()) setenv("HADR04_NTHREADS", threads.c_str(), 1);
+      std::vector<G4String> args;
+      args.push_back(arguments[0]);
+      args.push_back("-k"); args.push_back(process.str());
+      args.push_back("-o"); args.push_back(directory);
+      args.insert(args.end(), arguments.begin()+1, arguments.end());
+      std::vector<char*> argv;
+      for (size_t i=0; i<args.size(); ++i) {
+        argv.push_back(const_cast<char*>(args[i].c_str()));
+      }
+      argv.push_back(0);
+      execv("/proc/self/exe", &argv[0]);
+      execvp(argv[0], &argv[0]);
+      _exit(127);
+    }
+    pids[k] = pid;
+  }
+  
+  // wait for all of them
+  G4int nbFailed = 0;
+  for (G4int k=0; k<nbProcesses; ++k) {
+    G4int status = 0;
+    if (pids[k] < 0 || waitpid(pids[k], &status, 0) < 0) { ++nbFailed; continue; }
+    G4bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    if (!ok) {
+      ++nbFailed;
+      G4cerr << "### Campaign: process " << k << " failed (";
+      if (WIFSIGNALED(status)) G4cerr << "signal " << WTERMSIG(status);
+      else G4cerr << "exit code " << WEXITSTATUS(status);
+      G4cerr << "), see " << directory << "/log_p" << k << ".txt" << G4endl;
+    }
+  }
+  std::chrono::duration<G4double> elapsed 
+    = std::chrono::steady_clock::now() - start;
+  G4cout << " Campaign: " << nbProcesses - nbFailed << " of " << nbProcesses 
+         << " processes done in " << elapsed.count() << " s" << G4endl;
+  if (nbFailed > 0) return 1;
+  
+  CampaignMerger merger(directory);
+  return merger.Merge(nbProcesses) ? 0 : 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Campaign::SetProcess(G4int index, G4int nbProcesses, const G4String& dir)
+{
+  fIndex = index;
+  fNbProcesses = nbProcesses;
+  fDirectory = dir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int Campaign::BeginOfRun(G4int nbEvents)
+{
+  if (!IsProcess() || nbEvents <= 0) return nbEvents;
+
+  RandomStreams* streams = RandomStreams::Instance();
+  if (!streams->IsCounterBased()) {
+    G4cout << "\n Campaign: counter-based random streams are required,"
+           << " /testhadr/random/engine philox is set" << G4endl;
+    streams->SetCounterBased(true);
+  }
+  
+  // events [first, last) of this process
+  fFirstEvent = streams->GetFirstEvent();
+  uint64_t first = (uint64_t)nbEvents*fIndex/fNbProcesses;
+  uint64_t last  = (uint64_t)nbEvents*(fIndex+1)/fNbProcesses;
+  streams->SetFirstEvent(fFirstEvent + first);
+  
+  G4cout << "\n Campaign process " << fIndex << "/" << fNbProcesses 
+         << ": events " << first << " to " << last << " of " << nbEvents 
+         << G4endl;
+  return (G4int)(last - first);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Campaign::EndOfRun(G4int nbEvents)
+{
+  // all processes go past the whole run
+  if (IsProcess() && nbEvents > 0) {
+    RandomStreams::Instance()->SetFirstEvent(fFirstEvent + nbEvents);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String Campaign::OutputName(const G4String& name, const G4String& ext) const
+{
+  if (!IsProcess()) return name;
+  
+  std::ostringstream suffix;
+  suffix << "_p" << fIndex;
+  
+  // strip the directory and the extension
+  std::string stem = name, extension = ext;
+  size_t slash = stem.rfind('/');
+  if (slash != std::string::npos) stem = stem.substr(slash+1);
+  size_t dot = stem.rfind('.');
+  if (dot != std::string::npos && dot > 0) {
+    extension = stem.substr(dot);
+    stem = stem.substr(0, dot);
+  }
+  
+  // already renamed (at a previous run)
+  G4String prefix = fDirectory + "/";
+  G4bool inDirectory = name.compare(0, prefix.size(), prefix) == 0;
+  if (inDirectory && stem.size() > suffix.str().size() &&
+      stem.compare(stem.size()-suffix.str().size(), std::string::npos,
+                   suffix.str()) == 0) return name;
+  
+  return prefix + stem + suffix.str() + extension;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
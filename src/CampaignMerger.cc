@@ -0,0 +1,497 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file CampaignMerger.cc
+/// \brief Implementation of the CampaignMerger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "CampaignMerger.hh"
+#include "RunSummary.hh"
+#include "RecordMerger.hh"
+#include "SparseMesh.hh"
+#include "SparseH2.hh"
+#include "TallySums.hh"
+
+#include "tools/rroot/file"
+#include "tools/rroot/streamers"
+#include "tools/wroot/file"
+#include "tools/wroot/to"
+#include "tools/zlib"
+
+#include <algorithm>
+#include <cctype>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+  // strip a suffix _<letter><digits>, return false if there is none
+  G4bool StripSuffix(std::string& stem, char letter)
+  {
+    size_t pos = stem.rfind('_');
+    if (pos == std::string::npos || pos+2 >= stem.size() ||
+        stem[pos+1] != letter) return false;
+    for (size_t i=pos+2; i<stem.size(); ++i) {
+      if (!std::isdigit((unsigned char)stem[i])) return false;
+    }
+    stem.erase(pos);
+    return true;
+  }
+  
+  // add a histogram to the sum of the same name, or start it
+  template <class H>
+  G4bool Accumulate(std::vector<std::pair<std::string,H*> >& sums,
+                    const std::string& name, H* histo)
+  {
+    for (size_t i=0; i<sums.size(); ++i) {
+      if (sums[i].first != name) continue;
+      G4bool ok = sums[i].second->add(*histo);
+      delete histo;
+      return ok;
+    }
+    sums.push_back(std::make_pair(name, histo));
+    return true;
+  }
+  
+  // sums of the h1 and h2 of analysis files, in the order they are read
+  class HistoSums
+  {
+    public:
+      HistoSums() : fNbTrees(0) {}
+     ~HistoSums() {
+        for (size_t i=0; i<fH1.size(); ++i) delete fH1[i].second;
+        for (size_t i=0; i<fH2.size(); ++i) delete fH2[i].second;
+      }
+      
+      G4bool Read(const G4String& fileName);
+      G4bool Add(HistoSums& other);
+      G4bool Write(const G4String& fileName) const;
+      G4int  GetNbTrees() const { return fNbTrees; };
+      
+    private:
+      HistoSums(const HistoSums&);
+      HistoSums& operator=(const HistoSums&);
+      
+      std::vector<std::pair<std::string,tools::histo::h1d*> > fH1;
+      std::vector<std::pair<std::string,tools::histo::h2d*> > fH2;
+      G4int fNbTrees;
+  };
+  
+  G4bool HistoSums::Read(const G4String& fileName)
+  {
+    tools::rroot::file file(G4cout, fileName);
+    if (!file.is_open()) return false;
+    file.add_unziper('Z', tools::decompress_buffer);
+    G4bool ok = true;
+    const std::vector<tools::rroot::key*>& keys = file.dir().keys();
+    for (size_t i=0; i<keys.size(); ++i) {
+      tools::rroot::key& key = *keys[i];
+      const std::string& type = key.object_class();
+      if (type == "TTree") { fNbTrees++; continue; }
+      if (type != "TH1D" && type != "TH2D") continue;
+      unsigned int size = 0;
+      char* data = key.get_object_buffer(file, size);
+      if (!data) { ok = false; continue; }
+      tools::rroot::buffer buffer(G4cout, file.byte_swap(), size, data,
+                                  key.key_length(), false);
+      buffer.set_map_objs(true);
+      if (type == "TH1D") {
+        tools::histo::h1d* h1 = tools::rroot::TH1D_stream(buffer);
+        ok &= (h1 != 0) && Accumulate(fH1, key.object_name(), h1);
+      }
+      else {
+        tools::histo::h2d* h2 = tools::rroot::TH2D_stream(buffer);
+        ok &= (h2 != 0) && Accumulate(fH2, key.object_name(), h2);
+      }
+    }
+    return ok;
+  }
+  
+  // takes the histograms of other, which is left empty
+  G4bool HistoSums::Add(HistoSums& other)
+  {
+    G4bool ok = true;
+    for (size_t i=0; i<other.fH1.size(); ++i) {
+      ok &= Accumulate(fH1, other.fH1[i].first, other.fH1[i].second);
+    }
+    for (size_t i=0; i<other.fH2.size(); ++i) {
+      ok &= Accumulate(fH2, other.fH2[i].first, other.fH2[i].second);
+    }
+    other.fH1.clear();
+    other.fH2.clear();
+    fNbTrees += other.fNbTrees;
+    return ok;
+  }
+  
+  G4bool HistoSums::Write(const G4String& fileName) const
+  {
+    tools::wroot::file file(G4cout, fileName);
+    if (!file.is_open()) return false;
+    file.add_ziper('Z', tools::compress_buffer);
+    file.set_compression(1);
+    G4bool ok = true;
+    for (size_t i=0; i<fH1.size(); ++i) {
+      ok &= tools::wroot::to(file.dir(), *fH1[i].second, fH1[i].first);
+    }
+    for (size_t i=0; i<fH2.size(); ++i) {
+      ok &= tools::wroot::to(file.dir(), *fH2[i].second, fH2[i].first);
+    }
+    unsigned int nbBytes = 0;
+    ok &= file.write(nbBytes);
+    file.close();
+    return ok;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CampaignMerger::CampaignMerger(const G4String& directory)
+: fDirectory(directory), fUseHadd(false)
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CampaignMerger::~CampaignMerger()
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CampaignMerger::Scan()
+{
+  fSummaries.clear();
+  fRootFiles.clear();
+  fManifests.clear();
+  fMeshes.clear();
+  fTallies.clear();
+  fSparseMaps.clear();
+  
+  DIR* dir = opendir(fDirectory.c_str());
+  if (!dir) return;
+  while (dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    size_t dot = name.rfind('.');
+    if (dot == std::string::npos) continue;
+    std::string stem = name.substr(0, dot), ext = name.substr(dot);
+    if (ext == ".root") StripSuffix(stem, 't');    // worker ntuple files
+    if (!StripSuffix(stem, 'p')) continue;         // not from a process
+    
+    G4String path = fDirectory + "/" + name;
+    if      (ext == ".summary") fSummaries[stem].push_back(path);
+    else if (ext == ".root")    fRootFiles[stem].push_back(path);
+    else if (ext == ".h04m")    fManifests[stem].push_back(path);
+    else if (ext == ".h04v")    fMeshes[stem].push_back(path);
+    else if (ext == ".h04s")    fTallies[stem].push_back(path);
+    else if (ext == ".h04h")    fSparseMaps[stem].push_back(path);
+  }
+  closedir(dir);
+  
+  // fixed order, hence fixed sums
+  std::map<G4String,std::vector<G4String> >::iterator it;
+  for (it = fSummaries.begin(); it != fSummaries.end(); ++it) {
+    std::sort(it->second.begin(), it->second.end());
+  }
+  for (it = fRootFiles.begin(); it != fRootFiles.end(); ++it) {
+    std::sort(it->second.begin(), it->second.end());
+  }
+  for (it = fManifests.begin(); it != fManifests.end(); ++it) {
+    std::sort(it->second.begin(), it->second.end());
+  }
+  for (it = fMeshes.begin(); it != fMeshes.end(); ++it) {
+    std::sort(it->second.begin(), it->second.end());
+  }
+  for (it = fTallies.begin(); it != fTallies.end(); ++it) {
+    std::sort(it->second.begin(), it->second.end());
+  }
+  for (it = fSparseMaps.begin(); it != fSparseMaps.end(); ++it) {
+    std::sort(it->second.begin(), it->second.end());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CampaignMerger::Merge(G4int nbThreads)
+{
+  if (nbThreads < 1) nbThreads = 1;
+  Scan();
+  if (fSummaries.empty() && fRootFiles.empty() && fManifests.empty() &&
+      fMeshes.empty() && fTallies.empty() && fSparseMaps.empty()) {
+    G4cout << "### CampaignMerger: no process output in " << fDirectory 
+           << G4endl;
+    return false;
+  }
+  
+  G4bool ok = true;
+  std::map<G4String,std::vector<G4String> >::const_iterator it;
+  for (it = fSummaries.begin(); it != fSummaries.end(); ++it) {
+    ok &= MergeSummaries(fDirectory + "/" + it->first + ".summary",
+                         it->second, nbThreads);
+  }
+  for (it = fRootFiles.begin(); it != fRootFiles.end(); ++it) {
+    ok &= MergeRootFiles(fDirectory + "/" + it->first + ".root",
+                         it->second, nbThreads);
+  }
+  for (it = fMeshes.begin(); it != fMeshes.end(); ++it) {
+    ok &= MergeMeshes(fDirectory + "/" + it->first + ".h04v", it->second);
+  }
+  for (it = fTallies.begin(); it != fTallies.end(); ++it) {
+    ok &= MergeTallies(fDirectory + "/" + it->first, it->second);
+  }
+  for (it = fSparseMaps.begin(); it != fSparseMaps.end(); ++it) {
+    ok &= MergeSparseMaps(fDirectory + "/" + it->first, it->second);
+  }
+  RecordMerger recordMerger(nbThreads);
+  for (it = fManifests.begin(); it != fManifests.end(); ++it) {
+    ok &= recordMerger.Merge(it->second, fDirectory + "/" + it->first);
+  }
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CampaignMerger::MergeSummaries(const G4String& output,
+                                      const std::vector<G4String>& files,
+                                      G4int nbThreads)
+{
+  // each thread reads and sums one file out of nbThreads, then the 
+  // partial sums are added in thread order
+  G4int nbFiles = (G4int)files.size();
+  if (nbThreads > nbFiles) nbThreads = nbFiles;
+  std::vector<RunSummary> partial(nbThreads);
+  std::vector<G4int> nbBad(nbThreads, 0);
+  std::vector<std::thread> threads;
+  for (G4int t=0; t<nbThreads; ++t) {
+    threads.push_back(std::thread([&, t]() {
+      for (G4int i=t; i<nbFiles; i+=nbThreads) {
+        RunSummary summary;
+        if (summary.Read(files[i])) partial[t].Add(summary);
+        else nbBad[t]++;
+      }
+    }));
+  }
+  RunSummary total;
+  G4int nbFailed = 0;
+  for (G4int t=0; t<nbThreads; ++t) {
+    threads[t].join();
+    total.Add(partial[t]);
+    nbFailed += nbBad[t];
+  }
+  
+  G4cout << "\n Merged " << nbFiles - nbFailed << " run summaries into " 
+         << output << G4endl;
+  total.Print();
+  return total.Write(output) && nbFailed == 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CampaignMerger::MergeRootFiles(const G4String& output,
+                                      const std::vector<G4String>& files,
+                                      G4int nbThreads)
+{
+  if (fUseHadd) return MergeWithHadd(output, files, nbThreads);
+  
+  // as the summaries: one file out of nbThreads per thread, then the
+  // partial sums in thread order
+  G4int nbFiles = (G4int)files.size();
+  if (nbThreads > nbFiles) nbThreads = nbFiles;
+  std::vector<HistoSums> partial(nbThreads);
+  std::vector<G4int> nbBad(nbThreads, 0);
+  std::vector<std::thread> threads;
+  for (G4int t=0; t<nbThreads; ++t) {
+    threads.push_back(std::thread([&, t]() {
+      for (G4int i=t; i<nbFiles; i+=nbThreads) {
+        if (!partial[t].Read(files[i])) nbBad[t]++;
+      }
+    }));
+  }
+  HistoSums total;
+  G4int nbFailed = 0;
+  for (G4int t=0; t<nbThreads; ++t) {
+    threads[t].join();
+    if (!total.Add(partial[t])) nbFailed++;
+    nbFailed += nbBad[t];
+  }
+  if (nbFailed > 0) {
+    G4cout << "### CampaignMerger: " << nbFailed << " analysis files not read,"
+           << " or with histograms of different binnings" << G4endl;
+  }
+  
+  G4bool ok = total.Write(output);
+  G4cout << " Merged the histograms of " << nbFiles << " analysis files into " 
+         << output << G4endl;
+  if (total.GetNbTrees() > 0) {
+    G4cout << " Ntuples stay in the process files (chain them, or merge all"
+           << " with Hadr04 -m " << fDirectory << " -hadd)" << G4endl;
+  }
+  return ok && nbFailed == 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CampaignMerger::MergeWithHadd(const G4String& output,
+                                     const std::vector<G4String>& files,
+                                     G4int nbThreads)
+{
+  std::ostringstream jobs;
+  jobs << nbThreads;
+  std::vector<G4String> args;
+  args.push_back("hadd"); args.push_back("-f"); 
+  args.push_back("-j");   args.push_back(jobs.str());
+  args.push_back(output);
+  args.insert(args.end(), files.begin(), files.end());
+  
+  std::ostringstream command;
+  for (size_t i=0; i<args.size(); ++i) command << args[i] << " ";
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    G4String log = fDirectory + "/log_merge.txt";
+    G4int fd = open(log.c_str(), O_WRONLY|O_CREAT|O_APPEND, 0644);
+    if (fd >= 0) { dup2(fd, 1); dup2(fd, 2); close(fd); }
+    std::vector<char*> argv;
+    for (size_t i=0; i<args.size(); ++i) {
+      argv.push_back(const_cast<char*>(args[i].c_str()));
+    }
+    argv.push_back(0);
+    execvp("hadd", &argv[0]);
+    _exit(127);
+  }
+  
+  G4int status = 0;
+  if (pid < 0 || waitpid(pid, &status, 0) < 0 ||
+      !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    G4cout << "### CampaignMerger: hadd failed or not found (see " 
+           << fDirectory << "/log_merge.txt); to merge by hand:\n    "
+           << command.str() << G4endl;
+    return false;
+  }
+  G4cout << " Merged " << files.size() << " analysis files into " << output 
+         << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CampaignMerger::MergeMeshes(const G4String& output,
+                                   const std::vector<G4String>& files)
+{
+  SparseMesh* total = 0;
+  G4long nbEvents = 0;
+  G4int nbFailed = 0;
+  for (size_t i=0; i<files.size(); ++i) {
+    G4long events = 0;
+    SparseMesh* mesh = SparseMesh::Read(files[i], events);
+    if (!mesh || (total && !total->Add(*mesh))) {
+      G4cout << "### CampaignMerger: " << files[i] << " not read, or of "
+             << "another binning" << G4endl;
+      nbFailed++;
+      delete mesh;
+      continue;
+    }
+    nbEvents += events;
+    if (!total) total = mesh;
+    else delete mesh;
+  }
+  if (!total) return false;
+  
+  G4bool ok = total->Write(output, nbEvents);
+  G4cout << " Merged " << files.size() - nbFailed << " meshes into " << output 
+         << " (" << total->GetNbBlocks() << " blocks)" << G4endl;
+  delete total;
+  return ok && nbFailed == 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CampaignMerger::MergeSparseMaps(const G4String& output,
+                                       const std::vector<G4String>& files)
+{
+  // raw sums added bin by bin, then the text formats of the processes
+  SparseH2* total = 0;
+  G4double unit = 1.;
+  G4String unitName;
+  G4int formats = 0, nbFailed = 0;
+  for (size_t i=0; i<files.size(); ++i) {
+    SparseH2* h2 = SparseH2::Read(files[i], unit, unitName, formats);
+    if (!h2 || (total && !total->Add(*h2))) {
+      G4cout << "### CampaignMerger: " << files[i] << " not read, or of "
+             << "another binning" << G4endl;
+      nbFailed++;
+      delete h2;
+      continue;
+    }
+    if (!total) total = h2;
+    else delete h2;
+  }
+  if (!total) return false;
+  
+  G4bool ok = total->Write(output + ".h04h", unit, unitName, formats);
+  if (formats & 1) ok &= total->WriteCoo(output + ".coo", unit, unitName);
+  if (formats & 2) ok &= total->WriteDense(output + ".dense", unit, unitName);
+  G4cout << " Merged " << files.size() - nbFailed << " sparse maps into " 
+         << output << ".h04h (" << total->GetNbOccupied() << " bins)" 
+         << G4endl;
+  delete total;
+  return ok && nbFailed == 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CampaignMerger::MergeTallies(const G4String& output,
+                                    const std::vector<G4String>& files)
+{
+  // raw sums added entry by entry, then the spectra written from them
+  TallySums* total = 0;
+  G4int nbFailed = 0;
+  for (size_t i=0; i<files.size(); ++i) {
+    TallySums* sums = TallySums::Read(files[i]);
+    if (!sums || (total && !total->Add(*sums))) {
+      G4cout << "### CampaignMerger: " << files[i] << " not read, or of "
+             << "other bins" << G4endl;
+      nbFailed++;
+      delete sums;
+      continue;
+    }
+    if (!total) total = sums;
+    else delete sums;
+  }
+  if (!total) return false;
+  
+  G4bool ok = total->Write(output + ".h04s") 
+           && total->WriteText(output + ".txt");
+  G4cout << " Merged " << files.size() - nbFailed << " spectra into " 
+         << output << ".txt (" << total->GetNbEvents() << " events)" 
+         << G4endl;
+  delete total;
+  return ok && nbFailed == 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,633 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Checkpoint.cc
+/// \brief Implementation of the Checkpoint class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "Checkpoint.hh"
+#include "CheckpointMessenger.hh"
+#include "Campaign.hh"
+#include "HistoManager.hh"
+#include "RandomStreams.hh"
+#include "Records.hh"
+#include "Run.hh"
+
+#include "G4RunManager.hh"
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace {
+  const char kMagic[8] = { 'H','0','4','C','K','P','T','1' };
+
+  // events completed by this thread since the start of the run
+  struct ThreadState {
+    ThreadState() : fSinceSave(0), fLastSave(0.) {}
+    std::vector<uint64_t> fDone;
+    G4int                 fSinceSave;
+    G4double              fLastSave;
+  };
+  G4ThreadLocal ThreadState* threadState = 0;
+  
+  // binary records
+  template <class T> void WriteValue(std::ostream& out, const T& value)
+  {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+  
+  template <class T> G4bool ReadValue(std::istream& in, T& value)
+  {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return in.good();
+  }
+  
+  template <class T> void WriteVector(std::ostream& out, 
+                                      const std::vector<T>& vect)
+  {
+    WriteValue(out, (uint64_t)vect.size());
+    if (!vect.empty()) {
+      out.write(reinterpret_cast<const char*>(&vect[0]), vect.size()*sizeof(T));
+    }
+  }
+  
+  template <class T> G4bool ReadVector(std::istream& in, std::vector<T>& vect)
+  {
+    uint64_t size = 0;
+    if (!ReadValue(in, size) || size > (1ULL << 32)) return false;
+    vect.resize(size);
+    if (size) in.read(reinterpret_cast<char*>(&vect[0]), size*sizeof(T));
+    return in.good();
+  }
+  
+  void WriteString(std::ostream& out, const std::string& str)
+  {
+    std::vector<char> chars(str.begin(), str.end());
+    WriteVector(out, chars);
+  }
+  
+  G4bool ReadString(std::istream& in, std::string& str)
+  {
+    std::vector<char> chars;
+    if (!ReadVector(in, chars)) return false;
+    str.assign(chars.begin(), chars.end());
+    return true;
+  }
+  
+  // bin contents of a histogram (h1d or h2d); a flag for missing ones
+  template <class H> void WriteHisto(std::ostream& out, const H* histo)
+  {
+    WriteValue(out, (char)(histo != 0));
+    if (!histo) return;
+    typename H::hd_t data = histo->get_histo_data();
+    WriteVector(out, data.m_bin_entries);
+    WriteVector(out, data.m_bin_Sw);
+    WriteVector(out, data.m_bin_Sw2);
+    WriteValue(out, (uint64_t)data.m_bin_Sxw.size());
+    for (size_t i=0; i<data.m_bin_Sxw.size(); ++i) {
+      WriteVector(out, data.m_bin_Sxw[i]);
+      WriteVector(out, data.m_bin_Sx2w[i]);
+    }
+    WriteVector(out, data.m_in_range_plane_Sxyw);
+  }
+  
+  // add the saved contents to histo (if not null and of same binning)
+  template <class H> G4bool ReadHisto(std::istream& in, H* histo)
+  {
+    char present = 0;
+    if (!ReadValue(in, present)) return false;
+    if (!present) return true;
+    
+    typename H::hd_t saved;
+    uint64_t nbBins = 0;
+    G4bool ok = ReadVector(in, saved.m_bin_entries) 
+             && ReadVector(in, saved.m_bin_Sw)
+             && ReadVector(in, saved.m_bin_Sw2)
+             && ReadValue(in, nbBins) && nbBins < (1ULL << 32);
+    if (!ok) return false;
+    saved.m_bin_Sxw.resize(nbBins);
+    saved.m_bin_Sx2w.resize(nbBins);
+    for (size_t i=0; i<nbBins; ++i) {
+      ok = ok && ReadVector(in, saved.m_bin_Sxw[i]) 
+              && ReadVector(in, saved.m_bin_Sx2w[i]);
+    }
+    ok = ok && ReadVector(in, saved.m_in_range_plane_Sxyw);
+    if (!ok || !histo) return ok;
+    
+    typename H::hd_t data = histo->get_histo_data();
+    if (data.m_bin_entries.size() != saved.m_bin_entries.size()) {
+      G4cout << "### Checkpoint: binning of a histogram changed, "
+             << "its saved contents are dropped" << G4endl;
+      return true;
+    }
+    data.m_bin_entries = saved.m_bin_entries;
+    data.m_bin_Sw      = saved.m_bin_Sw;
+    data.m_bin_Sw2     = saved.m_bin_Sw2;
+    data.m_bin_Sxw     = saved.m_bin_Sxw;
+    data.m_bin_Sx2w    = saved.m_bin_Sx2w;
+    data.m_in_range_plane_Sxyw = saved.m_in_range_plane_Sxyw;
+    H savedHisto(*histo);
+    savedHisto.copy_from_data(data);
+    histo->add(savedHisto);
+    return true;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Checkpoint* Checkpoint::Instance()
+{
+  static Checkpoint instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Checkpoint::Checkpoint()
+: fDirectory("checkpoint"), fEveryEvents(0), fEveryMinutes(0.),
+  fResumeRequested(false), fActive(false), fSession(0), fMessenger(0)
+{
+  fRestored.fSeed = fRestored.fFirst = fRestored.fNbEvents = 0;
+  fRestored.fGeneration = 0;
+  fMessenger = new CheckpointMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Checkpoint::~Checkpoint()
+{
+  ClearState(fRestored);
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String Checkpoint::FileName(G4int thread) const
+{
+  std::ostringstream name;
+  name << fRunDirectory << "/ckpt_";
+  if (thread < 0) name << "base.dat";
+  else            name << "t" << thread << ".dat";
+  return name.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String Checkpoint::OutputName(const G4String& name) const
+{
+  if (fSession == 0) return name;
+  
+  std::ostringstream suffix;
+  suffix << "_resume" << fSession;
+  std::string stem = name, extension;
+  size_t dot = stem.rfind('.');
+  size_t slash = stem.rfind('/');
+  if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+    extension = stem.substr(dot);
+    stem = stem.substr(0, dot);
+  }
+  // suffix of a previous session
+  size_t pos = stem.rfind("_resume");
+  if (pos != std::string::npos && 
+      stem.find_first_not_of("0123456789", pos+7) == std::string::npos) {
+    stem.erase(pos);
+  }
+  return stem + suffix.str() + extension;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Checkpoint::NewHistograms(State& state) const
+{
+  // empty copies of the histograms of this thread
+  G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+  for (G4int i=0; i<analysisManager->GetNofH1s(); ++i) {
+    G4int id = analysisManager->GetFirstH1Id() + i;
+    tools::histo::h1d* h1 = analysisManager->GetH1(id, false, false);
+    if (h1) { h1 = new tools::histo::h1d(*h1); h1->reset(); }
+    state.fH1.push_back(h1);
+  }
+  for (G4int i=0; i<analysisManager->GetNofH2s(); ++i) {
+    G4int id = analysisManager->GetFirstH2Id() + i;
+    tools::histo::h2d* h2 = analysisManager->GetH2(id, false, false);
+    if (h2) { h2 = new tools::histo::h2d(*h2); h2->reset(); }
+    state.fH2.push_back(h2);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Checkpoint::ClearState(State& state) const
+{
+  // only for states owning their histograms
+  for (size_t i=0; i<state.fH1.size(); ++i) delete state.fH1[i];
+  for (size_t i=0; i<state.fH2.size(); ++i) delete state.fH2[i];
+  state.fH1.clear();
+  state.fH2.clear();
+  state.fDone.clear();
+  state.fNtuples.clear();
+  state.fSummary = RunSummary();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Checkpoint::Write(const G4String& fileName, const State& state,
+                         G4int thread) const
+{
+  // written aside, then renamed: a file is complete or absent
+  G4String tmpName = fileName + ".tmp";
+  {
+    std::ofstream out(tmpName, std::ios::binary);
+    if (!out) {
+      G4cout << "### Checkpoint: cannot write " << tmpName << G4endl;
+      return false;
+    }
+    out.write(kMagic, sizeof(kMagic));
+    WriteValue(out, state.fSeed);
+    WriteValue(out, state.fFirst);
+    WriteValue(out, state.fNbEvents);
+    WriteValue(out, state.fGeneration);
+    WriteValue(out, (int32_t)thread);
+    WriteVector(out, state.fDone);
+    
+    std::ostringstream summary;
+    state.fSummary.Write(summary);
+    WriteString(out, summary.str());
+    
+    WriteValue(out, (uint32_t)state.fNtuples.size());
+    for (size_t i=0; i<state.fNtuples.size(); ++i) {
+      WriteString(out, state.fNtuples[i].fFile);
+      WriteValue(out, (int32_t)state.fNtuples[i].fThread);
+      WriteVector(out, state.fNtuples[i].fRows);
+    }
+    
+    WriteValue(out, (uint32_t)state.fH1.size());
+    for (size_t i=0; i<state.fH1.size(); ++i) WriteHisto(out, state.fH1[i]);
+    WriteValue(out, (uint32_t)state.fH2.size());
+    for (size_t i=0; i<state.fH2.size(); ++i) WriteHisto(out, state.fH2[i]);
+    
+    out.flush();
+    if (!out) {
+      G4cout << "### Checkpoint: error writing " << tmpName << G4endl;
+      return false;
+    }
+  }
+  return std::rename(tmpName.c_str(), fileName.c_str()) == 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Checkpoint::Read(const G4String& fileName, State& state, 
+                        G4int& thread) const
+{
+  // the contents are added to state, whose histograms must exist
+  std::ifstream in(fileName, std::ios::binary);
+  char magic[sizeof(kMagic)];
+  in.read(magic, sizeof(magic));
+  if (!in || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+    G4cout << "### Checkpoint: " << fileName << " is not a checkpoint" 
+           << G4endl;
+    return false;
+  }
+  
+  int32_t threadId = 0;
+  std::vector<uint64_t> done;
+  std::string summaryText;
+  G4bool ok = ReadValue(in, state.fSeed) && ReadValue(in, state.fFirst)
+           && ReadValue(in, state.fNbEvents) 
+           && ReadValue(in, state.fGeneration)
+           && ReadValue(in, threadId) && ReadVector(in, done)
+           && ReadString(in, summaryText);
+  thread = threadId;
+  
+  RunSummary summary;
+  std::istringstream summaryStream(summaryText);
+  ok = ok && summary.Read(summaryStream, fileName);
+  
+  uint32_t nbLogs = 0;
+  ok = ok && ReadValue(in, nbLogs);
+  std::vector<NtupleLog> logs(ok ? nbLogs : 0);
+  for (size_t i=0; ok && i<logs.size(); ++i) {
+    std::string file;
+    int32_t logThread = 0;
+    ok = ReadString(in, file) && ReadValue(in, logThread) 
+      && ReadVector(in, logs[i].fRows);
+    logs[i].fFile = file;
+    logs[i].fThread = logThread;
+  }
+  
+  uint32_t nbH1 = 0, nbH2 = 0;
+  ok = ok && ReadValue(in, nbH1);
+  for (uint32_t i=0; ok && i<nbH1; ++i) {
+    ok = ReadHisto(in, (i < state.fH1.size()) ? state.fH1[i] : 0);
+  }
+  ok = ok && ReadValue(in, nbH2);
+  for (uint32_t i=0; ok && i<nbH2; ++i) {
+    ok = ReadHisto(in, (i < state.fH2.size()) ? state.fH2[i] : 0);
+  }
+  if (!ok) {
+    G4cout << "### Checkpoint: " << fileName << " is truncated" << G4endl;
+    return false;
+  }
+  
+  state.fDone.insert(state.fDone.end(), done.begin(), done.end());
+  state.fSummary.Add(summary);
+  state.fNtuples.insert(state.fNtuples.end(), logs.begin(), logs.end());
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Checkpoint::Load(State& state)
+{
+  // the consolidated state of the previous resumption, if any
+  G4int thread = 0;
+  G4String baseName = FileName(-1);
+  uint64_t seed = state.fSeed, first = state.fFirst, nbEvents = state.fNbEvents;
+  uint64_t baseGeneration = 0, lastGeneration = 0;
+  std::ifstream test(baseName);
+  if (test) {
+    test.close();
+    if (!Read(baseName, state, thread)) return false;
+    baseGeneration = lastGeneration = state.fGeneration;
+  }
+  
+  // the latest files of the threads, from the generations since
+  DIR* dir = opendir(fRunDirectory.c_str());
+  if (!dir) {
+    G4cout << "### Checkpoint: no directory " << fRunDirectory << G4endl;
+    return false;
+  }
+  std::vector<G4String> files;
+  while (dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.compare(0, 6, "ckpt_t") == 0 && name.size() > 4 &&
+        name.compare(name.size()-4, 4, ".dat") == 0) {
+      files.push_back(fRunDirectory + "/" + name);
+    }
+  }
+  closedir(dir);
+  std::sort(files.begin(), files.end());
+  
+  for (size_t i=0; i<files.size(); ++i) {
+    State threadState;
+    threadState.fH1.assign(state.fH1.size(), 0);
+    threadState.fH2.assign(state.fH2.size(), 0);
+    // header only, to select the generation
+    if (!Read(files[i], threadState, thread)) return false;
+    if (threadState.fGeneration < baseGeneration) continue;
+    if (!Read(files[i], state, thread)) return false;
+    lastGeneration = std::max(lastGeneration, state.fGeneration);
+  }
+  
+  if (state.fSeed != seed || state.fFirst != first || 
+      state.fNbEvents != nbEvents) {
+    if (state.fDone.empty() && lastGeneration == 0) {
+      G4cout << "### Checkpoint: nothing to resume in " << fRunDirectory 
+             << G4endl;
+    }
+    else {
+      G4cout << "### Checkpoint: " << fRunDirectory << " holds a run of " 
+             << state.fNbEvents << " events from stream " << state.fFirst 
+             << " with seed " << state.fSeed << ", not this one" << G4endl;
+    }
+    return false;
+  }
+  state.fGeneration = lastGeneration;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Checkpoint::RemoveFiles() const
+{
+  DIR* dir = opendir(fRunDirectory.c_str());
+  if (!dir) return;
+  while (dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name.compare(0, 5, "ckpt_") == 0) {
+      std::remove((fRunDirectory + "/" + name).c_str());
+    }
+  }
+  closedir(dir);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int Checkpoint::BeginOfRun(G4int nbEvents)
+{
+  fActive = (fEveryEvents > 0 || fEveryMinutes > 0. || fResumeRequested);
+  if (!fActive || nbEvents <= 0) { fActive = false; return nbEvents; }
+
+  RandomStreams* streams = RandomStreams::Instance();
+  if (!streams->IsCounterBased()) {
+    G4cout << "\n Checkpoint: counter-based random streams are required,"
+           << " /testhadr/random/engine philox is set" << G4endl;
+    streams->SetCounterBased(true);
+  }
+  // one directory per process of a campaign
+  fRunDirectory = Campaign::Instance()->OutputName(fDirectory, "");
+  if (mkdir(fRunDirectory.c_str(), 0755) != 0 && errno != EEXIST) {
+    G4cout << "### Checkpoint: cannot create " << fRunDirectory << ": " 
+           << std::strerror(errno) << G4endl;
+    fActive = false;
+    return nbEvents;
+  }
+  
+  ClearState(fRestored);
+  fRestored.fSeed     = streams->GetSeed();
+  fRestored.fFirst    = streams->GetFirstEvent();
+  fRestored.fNbEvents = nbEvents;
+  NewHistograms(fRestored);
+  
+  if (!fResumeRequested) {
+    RemoveFiles();
+    fRestored.fGeneration = 1;
+    fSession = 0;
+    return nbEvents;
+  }
+  
+  // resumption: the events missing from the checkpoint
+  fResumeRequested = false;
+  if (!Load(fRestored)) {
+    G4cout << "### Checkpoint: the run is not started" << G4endl;
+    ClearState(fRestored);
+    fActive = false;
+    return 0;
+  }
+  std::vector<uint64_t>& done = fRestored.fDone;
+  std::sort(done.begin(), done.end());
+  done.erase(std::unique(done.begin(), done.end()), done.end());
+  std::vector<uint64_t> missing;
+  size_t j = 0;
+  for (uint64_t k=fRestored.fFirst; k<fRestored.fFirst+nbEvents; ++k) {
+    while (j < done.size() && done[j] < k) ++j;
+    if (j == done.size() || done[j] != k) missing.push_back(k);
+  }
+  fRestored.fSummary.fNbEvents = (G4int)done.size();
+  
+  // consolidate, the thread files of this generation supersede the others
+  fRestored.fGeneration++;
+  fSession = (G4int)fRestored.fGeneration - 1;
+  if (!Write(FileName(-1), fRestored, -1)) {
+    G4cout << "### Checkpoint: the run is not started" << G4endl;
+    fActive = false;
+    return 0;
+  }
+  
+  G4cout << "\n Checkpoint: resuming from " << fRunDirectory << ", " 
+         << done.size() << " of " << nbEvents << " events done, " 
+         << missing.size() << " to go" << G4endl;
+  if (missing.empty()) {
+    G4cout << "### Checkpoint: all events of the run were completed;"
+           << " their results are in " << FileName(-1) << G4endl;
+    return 0;
+  }
+  streams->SetStreamList(missing, fRestored.fFirst + nbEvents);
+  return (G4int)missing.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Checkpoint::EndOfRun(Run* run)
+{
+  if (!fActive) return;
+  fActive = false;
+  
+  if (fRestored.fSummary.fNbEvents > 0) {
+    run->AddSummary(fRestored.fSummary);
+    
+    G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+    for (size_t i=0; i<fRestored.fH1.size(); ++i) {
+      tools::histo::h1d* h1 = analysisManager->GetH1(
+                     analysisManager->GetFirstH1Id() + (G4int)i, false, false);
+      if (h1 && fRestored.fH1[i]) h1->add(*fRestored.fH1[i]);
+    }
+    for (size_t i=0; i<fRestored.fH2.size(); ++i) {
+      tools::histo::h2d* h2 = analysisManager->GetH2(
+                     analysisManager->GetFirstH2Id() + (G4int)i, false, false);
+      if (h2 && fRestored.fH2[i]) h2->add(*fRestored.fH2[i]);
+    }
+    
+    G4cout << "\n Checkpoint: " << fRestored.fSummary.fNbEvents 
+           << " events restored from earlier sessions; their ntuple rows"
+           << " are the first rows of:" << G4endl;
+    for (size_t i=0; i<fRestored.fNtuples.size(); ++i) {
+      const NtupleLog& log = fRestored.fNtuples[i];
+      G4cout << "   " << log.fFile << " thread " << log.fThread << ":";
+      for (size_t k=0; k<log.fRows.size(); ++k) {
+        G4cout << " ntuple " << k << " " << log.fRows[k] << " rows";
+      }
+      G4cout << G4endl;
+    }
+  }
+  
+  ClearState(fRestored);
+  RemoveFiles();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Checkpoint::BeginOfThreadRun()
+{
+  if (!threadState) threadState = new ThreadState;
+  threadState->fDone.clear();
+  threadState->fSinceSave = 0;
+  threadState->fLastSave = Run::WallClock();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Checkpoint::EndOfEvent(G4int eventID)
+{
+  if (!fActive || !threadState) return;
+  
+  threadState->fDone.push_back(
+                 RandomStreams::Instance()->GetStreamIndex(eventID));
+  threadState->fSinceSave++;
+  
+  G4bool due = (fEveryEvents > 0 && threadState->fSinceSave >= fEveryEvents)
+    || (fEveryMinutes > 0. && 
+        Run::WallClock() - threadState->fLastSave >= 60.*fEveryMinutes);
+  if (!due) return;
+  
+  Run* run = static_cast<Run*>(
+        G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  SaveThread(run);
+  threadState->fSinceSave = 0;
+  threadState->fLastSave = Run::WallClock();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Checkpoint::SaveThread(Run* run)
+{
+  G4int thread = std::max(0, G4Threading::G4GetThreadId());
+  G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+  
+  // the histograms of this thread are referenced, not copied
+  State state;
+  state.fSeed       = fRestored.fSeed;
+  state.fFirst      = fRestored.fFirst;
+  state.fNbEvents   = fRestored.fNbEvents;
+  state.fGeneration = fRestored.fGeneration;
+  state.fDone       = threadState->fDone;
+  run->FillSummary(state.fSummary);
+  state.fSummary.fNbEvents = (G4int)state.fDone.size();
+  
+  NtupleLog log;
+  log.fFile   = analysisManager->GetFileName();
+  log.fThread = thread;
+  log.fRows   = run->GetNtupleRows();
+  state.fNtuples.push_back(log);
+  
+  // fills of the log binned H1s, see HistoManager
+  HistoManager::FlushThread();
+  for (G4int i=0; i<analysisManager->GetNofH1s(); ++i) {
+    state.fH1.push_back(analysisManager->GetH1(
+                 analysisManager->GetFirstH1Id() + i, false, false));
+  }
+  for (G4int i=0; i<analysisManager->GetNofH2s(); ++i) {
+    state.fH2.push_back(analysisManager->GetH2(
+                 analysisManager->GetFirstH2Id() + i, false, false));
+  }
+  
+  // records of the checkpointed events out of the queues, in the files
+  Records::Instance()->FlushThread();
+  
+  return Write(FileName(thread), state, thread);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,113 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file CheckpointMessenger.cc
+/// \brief Implementation of the CheckpointMessenger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "CheckpointMessenger.hh"
+
+#include "Checkpoint.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CheckpointMessenger::CheckpointMessenger(Checkpoint* checkpoint)
+:G4UImessenger(),fCheckpoint(checkpoint),
+ fCheckpointDir(0), fDirectoryCmd(0), fEveryEventsCmd(0), fEveryMinutesCmd(0),
+ fResumeCmd(0)
+{ 
+  G4bool broadcast = false;
+  fCheckpointDir = new G4UIdirectory("/testhadr/checkpoint/",broadcast);
+  fCheckpointDir->SetGuidance("checkpoints of long runs");
+  
+  fDirectoryCmd = new G4UIcmdWithAString("/testhadr/checkpoint/directory",this);
+  fDirectoryCmd->SetGuidance("directory of the checkpoint files");
+  fDirectoryCmd->SetParameterName("dir",false);
+  fDirectoryCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fDirectoryCmd->SetToBeBroadcasted(false);
+  
+  fEveryEventsCmd = 
+    new G4UIcmdWithAnInteger("/testhadr/checkpoint/everyEvents",this);
+  fEveryEventsCmd->SetGuidance("each thread saves its state every n events;");
+  fEveryEventsCmd->SetGuidance("  0 to disable");
+  fEveryEventsCmd->SetParameterName("n",false);
+  fEveryEventsCmd->SetRange("n>=0");
+  fEveryEventsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fEveryEventsCmd->SetToBeBroadcasted(false);
+  
+  fEveryMinutesCmd = 
+    new G4UIcmdWithADouble("/testhadr/checkpoint/everyMinutes",this);
+  fEveryMinutesCmd->SetGuidance("each thread saves its state every t minutes");
+  fEveryMinutesCmd->SetGuidance("  (checked at the end of events); 0 to disable");
+  fEveryMinutesCmd->SetParameterName("t",false);
+  fEveryMinutesCmd->SetRange("t>=0.");
+  fEveryMinutesCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fEveryMinutesCmd->SetToBeBroadcasted(false);
+  
+  fResumeCmd = new G4UIcmdWithoutParameter("/testhadr/checkpoint/resume",this);
+  fResumeCmd->SetGuidance("next beamOn resumes the run of the checkpoint:");
+  fResumeCmd->SetGuidance("  same number of events, seed and first stream");
+  fResumeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fResumeCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CheckpointMessenger::~CheckpointMessenger()
+{
+  delete fDirectoryCmd;
+  delete fEveryEventsCmd;
+  delete fEveryMinutesCmd;
+  delete fResumeCmd;
+  delete fCheckpointDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{   
+  if (command == fDirectoryCmd)
+   {fCheckpoint->SetDirectory(newValue);}
+   
+  if (command == fEveryEventsCmd)
+   {fCheckpoint->SetEveryEvents(fEveryEventsCmd->GetNewIntValue(newValue));}
+   
+  if (command == fEveryMinutesCmd)
+   {fCheckpoint->SetEveryMinutes(fEveryMinutesCmd->GetNewDoubleValue(newValue));}
+   
+  if (command == fResumeCmd)
+   {fCheckpoint->RequestResume();}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,237 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ColumnarReader.cc
+/// \brief Implementation of the ColumnarReader class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ColumnarReader.hh"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef HADR04_USE_ZLIB
+#include <zlib.h>
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarReader::ColumnarReader()
+: fData(0), fSize(0), fNbRows(0)
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarReader::~ColumnarReader()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarReader::Close()
+{
+  if (fData) munmap((void*)fData, fSize);
+  fData = 0;
+  fSize = 0;
+  fColumnNames.clear();
+  fColumnTypes.clear();
+  fBlocks.clear();
+  fNbRows = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ColumnarReader::Open(const G4String& fileName)
+{
+  Close();
+  fFileName = fileName;
+  int fd = open(fileName.c_str(), O_RDONLY);
+  struct stat info;
+  if (fd < 0 || fstat(fd, &info) != 0) {
+    if (fd >= 0) close(fd);
+    G4cout << "### ColumnarReader: cannot read " << fileName << G4endl;
+    return false;
+  }
+  fSize = info.st_size;
+  void* map = (fSize > 0) ? mmap(0, fSize, PROT_READ, MAP_PRIVATE, fd, 0)
+                          : MAP_FAILED;
+  close(fd);
+  if (map == MAP_FAILED) {
+    fSize = 0;
+    G4cout << "### ColumnarReader: cannot map " << fileName << G4endl;
+    return false;
+  }
+  fData = (const char*)map;
+  
+  // trailer, then index
+  G4bool ok = fSize >= 16 + 24 && 
+              std::memcmp(fData, ColumnarWriter::kMagic, 8) == 0 &&
+              std::memcmp(fData + fSize - 8, ColumnarWriter::kIndexMagic, 8) 
+                == 0;
+  uint64_t footerOffset = 0, nbBlocks = 0;
+  if (ok) {
+    std::memcpy(&fNbRows, fData + fSize - 24, 8);
+    std::memcpy(&footerOffset, fData + fSize - 16, 8);
+    ok = footerOffset + 8 <= fSize - 24;
+  }
+  if (ok) {
+    std::memcpy(&nbBlocks, fData + footerOffset, 8);
+    ok = footerOffset + 8 + nbBlocks*48 <= fSize - 24;
+  }
+  const char* entry = fData + footerOffset + 8;
+  for (uint64_t i=0; ok && i<nbBlocks; ++i, entry += 48) {
+    Block block;
+    std::memcpy(&block.fColumn, entry, 4);
+    std::memcpy(&block.fCodec, entry + 4, 4);
+    std::memcpy(&block.fFirstRow, entry + 8, 8);
+    std::memcpy(&block.fNbRows, entry + 16, 8);
+    std::memcpy(&block.fOffset, entry + 24, 8);
+    std::memcpy(&block.fStoredSize, entry + 32, 8);
+    std::memcpy(&block.fRawSize, entry + 40, 8);
+    ok = block.fOffset + block.fStoredSize <= footerOffset;
+    fBlocks.push_back(block);
+  }
+  
+  // header
+  uint32_t headerSize = 0, nameLength = 0, nbColumns = 0;
+  if (ok) {
+    std::memcpy(&headerSize, fData + 8, 4);
+    std::memcpy(&nameLength, fData + 12, 4);
+    ok = headerSize <= footerOffset && 16 + nameLength + 4 <= headerSize;
+  }
+  if (ok) {
+    fTableName.assign(fData + 16, nameLength);
+    std::memcpy(&nbColumns, fData + 16 + nameLength, 4);
+  }
+  size_t position = 16 + nameLength + 4;
+  for (uint32_t i=0; ok && i<nbColumns; ++i) {
+    ok = position + 2 <= headerSize;
+    if (!ok) break;
+    G4int type = (unsigned char)fData[position];
+    size_t length = (unsigned char)fData[position+1];
+    ok = position + 2 + length <= headerSize;
+    if (!ok) break;
+    fColumnTypes.push_back(type);
+    fColumnNames.push_back(G4String(fData + position + 2, length));
+    position += 2 + length;
+  }
+  for (size_t i=0; ok && i<fBlocks.size(); ++i) {
+    ok = fBlocks[i].fColumn < nbColumns;
+  }
+  
+  if (!ok) {
+    G4cout << "### ColumnarReader: " << fileName 
+           << " is not a complete columnar file" << G4endl;
+    Close();
+  }
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ColumnarReader::FindColumn(const G4String& name) const
+{
+  for (size_t i=0; i<fColumnNames.size(); ++i) {
+    if (fColumnNames[i] == name) return i;
+  }
+  return -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ColumnarReader::DecodeBlock(const Block& block, char* values) const
+{
+  const char* data = GetBlockData(block);
+  if (block.fCodec == ColumnarWriter::kStored) {
+    std::memcpy(values, data, block.fRawSize);
+    return true;
+  }
+#ifdef HADR04_USE_ZLIB
+  if (block.fCodec != ColumnarWriter::kZlib) return false;
+  size_t typeSize = RecordSchema::TypeSize(fColumnTypes[block.fColumn]);
+  std::vector<char> shuffled(block.fRawSize);
+  uLongf rawSize = block.fRawSize;
+  if (uncompress((Bytef*)&shuffled[0], &rawSize, (const Bytef*)data,
+                 block.fStoredSize) != Z_OK || rawSize != block.fRawSize) {
+    return false;
+  }
+  size_t nbValues = block.fRawSize/typeSize;
+  for (size_t i=0; i<nbValues; ++i) {
+    for (size_t b=0; b<typeSize; ++b) {
+      values[i*typeSize + b] = shuffled[b*nbValues + i];
+    }
+  }
+  return true;
+#else
+  G4cout << "### ColumnarReader: " << fFileName << " has deflated blocks,"
+         << " the application is built without zlib" << G4endl;
+  return false;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const char* ColumnarReader::ReadBlock(const Block& block, 
+                                      std::vector<char>& buffer) const
+{
+  if (block.fCodec == ColumnarWriter::kStored) return GetBlockData(block);
+  buffer.resize(block.fRawSize);
+  if (buffer.empty()) return "";
+  return DecodeBlock(block, &buffer[0]) ? &buffer[0] : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const char* ColumnarReader::ReadColumn(G4int column, 
+                                       std::vector<char>& buffer) const
+{
+  std::vector<const Block*> blocks;
+  size_t size = 0;
+  for (size_t i=0; i<fBlocks.size(); ++i) {
+    if ((G4int)fBlocks[i].fColumn != column) continue;
+    blocks.push_back(&fBlocks[i]);
+    size += fBlocks[i].fRawSize;
+  }
+  if (blocks.size() == 1 && blocks[0]->fCodec == ColumnarWriter::kStored) {
+    return GetBlockData(*blocks[0]);
+  }
+  
+  buffer.resize(size);
+  size_t position = 0;
+  for (size_t i=0; i<blocks.size(); ++i) {
+    if (!DecodeBlock(*blocks[i], &buffer[position])) return 0;
+    position += blocks[i]->fRawSize;
+  }
+  return buffer.empty() ? "" : &buffer[0];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,258 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ColumnarWriter.cc
+/// \brief Implementation of the ColumnarWriter class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ColumnarWriter.hh"
+
+#include <cstdio>
+
+#ifdef HADR04_USE_ZLIB
+#include <zlib.h>
+#endif
+
+const char ColumnarWriter::kMagic[9]      = "H04COL01";
+const char ColumnarWriter::kIndexMagic[9] = "H04COLIX";
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ColumnarWriter::HasZlib()
+{
+#ifdef HADR04_USE_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarWriter::ColumnarWriter()
+: fFile(0), fTable(0), fCodec(kStored), fOffset(0), fNbRows(0)
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarWriter::~ColumnarWriter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ColumnarWriter::WriteBytes(const void* data, size_t size)
+{
+  if (size == 0) return true;
+  if (std::fwrite(data, 1, size, fFile) != size) return false;
+  fOffset += size;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ColumnarWriter::Pad()
+{
+  static const char zeros[kAlignment] = { 0 };
+  return WriteBytes(zeros, (kAlignment - fOffset%kAlignment)%kAlignment);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ColumnarWriter::Open(const G4String& fileName, G4int table, 
+                            G4int codec)
+{
+  Close();
+  fFile = std::fopen(fileName.c_str(), "wb");
+  if (!fFile) {
+    G4cout << "### ColumnarWriter: cannot write " << fileName << G4endl;
+    return false;
+  }
+  fFileName = fileName;
+  fTable = table;
+  fCodec = HasZlib() ? codec : kStored;
+  fOffset = fNbRows = 0;
+  fBlocks.clear();
+  
+  // header
+  const RecordSchema::Table& schema = RecordSchema::GetTable(table);
+  std::vector<char> header;
+  uint32_t nameLength = std::strlen(schema.fName);
+  uint32_t nbColumns = schema.fNbColumns;
+  header.insert(header.end(), kMagic, kMagic+8);
+  header.resize(header.size() + 4);   // header size, set below
+  header.insert(header.end(), (char*)&nameLength, (char*)&nameLength + 4);
+  header.insert(header.end(), schema.fName, schema.fName + nameLength);
+  header.insert(header.end(), (char*)&nbColumns, (char*)&nbColumns + 4);
+  for (G4int i=0; i<schema.fNbColumns; ++i) {
+    const char* name = schema.fColumns[i].fName;
+    header.push_back((char)schema.fColumns[i].fType);
+    header.push_back((char)std::strlen(name));
+    header.insert(header.end(), name, name + std::strlen(name));
+  }
+  uint32_t headerSize = header.size();
+  std::memcpy(&header[8], &headerSize, 4);
+  return WriteBytes(&header[0], header.size()) && Pad();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+size_t ColumnarWriter::Encode(const std::vector<char>& raw, size_t typeSize)
+{
+  // size of fEncoded, 0 if the block is to be stored as such
+#ifdef HADR04_USE_ZLIB
+  if (fCodec != kZlib || raw.empty()) return 0;
+  
+  size_t nbValues = raw.size()/typeSize;
+  const char* source = &raw[0];
+  if (typeSize > 1) {
+    fShuffled.resize(raw.size());
+    for (size_t i=0; i<nbValues; ++i) {
+      for (size_t b=0; b<typeSize; ++b) {
+        fShuffled[b*nbValues + i] = raw[i*typeSize + b];
+      }
+    }
+    source = &fShuffled[0];
+  }
+  
+  uLongf encodedSize = compressBound(raw.size());
+  fEncoded.resize(encodedSize);
+  if (compress2((Bytef*)&fEncoded[0], &encodedSize, (const Bytef*)source,
+                raw.size(), Z_BEST_SPEED) != Z_OK) return 0;
+  return (encodedSize < raw.size()) ? encodedSize : 0;
+#else
+  (void)raw; (void)typeSize;
+  return 0;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ColumnarWriter::Write(const RecordChunk& chunk)
+{
+  if (!fFile || chunk.GetNbRows() == 0) return fFile != 0;
+  
+  const RecordSchema::Table& schema = RecordSchema::GetTable(fTable);
+  for (G4int i=0; i<schema.fNbColumns; ++i) {
+    const std::vector<char>& raw = chunk.GetColumn(i);
+    size_t encodedSize = 
+      Encode(raw, RecordSchema::TypeSize(schema.fColumns[i].fType));
+    
+    Block block;
+    block.fColumn     = i;
+    block.fCodec      = encodedSize ? kZlib : kStored;
+    block.fFirstRow   = fNbRows;
+    block.fNbRows     = chunk.GetNbRows();
+    block.fOffset     = fOffset;
+    block.fStoredSize = encodedSize ? encodedSize : raw.size();
+    block.fRawSize    = raw.size();
+    const char* data  = encodedSize ? &fEncoded[0] : &raw[0];
+    if (!WriteBytes(data, block.fStoredSize) || !Pad()) return false;
+    fBlocks.push_back(block);
+  }
+  fNbRows += chunk.GetNbRows();
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ColumnarWriter::WriteBlock(const Block& source, const char* data)
+{
+  // blocks of a chunk are given column after column
+  if (!fFile) return false;
+  Block block = source;
+  block.fFirstRow = fNbRows;
+  block.fOffset = fOffset;
+  if (!WriteBytes(data, block.fStoredSize) || !Pad()) return false;
+  fBlocks.push_back(block);
+  
+  const RecordSchema::Table& schema = RecordSchema::GetTable(fTable);
+  if ((G4int)block.fColumn == schema.fNbColumns-1) fNbRows += block.fNbRows;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ColumnarWriter::Reserve(const Block& source, uint64_t& offset)
+{
+  if (!fFile) return false;
+  Block block = source;
+  block.fFirstRow = fNbRows;
+  block.fOffset = offset = fOffset;
+  fOffset += block.fStoredSize;
+  fOffset += (kAlignment - fOffset%kAlignment)%kAlignment;
+  if (fseeko(fFile, (off_t)fOffset, SEEK_SET) != 0) return false;
+  fBlocks.push_back(block);
+  
+  const RecordSchema::Table& schema = RecordSchema::GetTable(fTable);
+  if ((G4int)block.fColumn == schema.fNbColumns-1) fNbRows += block.fNbRows;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ColumnarWriter::GetDescriptor() const
+{
+  return fFile ? fileno(fFile) : -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ColumnarWriter::Flush()
+{
+  return !fFile || std::fflush(fFile) == 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ColumnarWriter::Close()
+{
+  if (!fFile) return true;
+  
+  // footer
+  uint64_t footerOffset = fOffset;
+  uint64_t nbBlocks = fBlocks.size();
+  G4bool ok = WriteBytes(&nbBlocks, 8);
+  for (size_t i=0; ok && i<fBlocks.size(); ++i) {
+    const Block& block = fBlocks[i];
+    ok = WriteBytes(&block.fColumn, 4) && WriteBytes(&block.fCodec, 4)
+      && WriteBytes(&block.fFirstRow, 8) && WriteBytes(&block.fNbRows, 8)
+      && WriteBytes(&block.fOffset, 8) && WriteBytes(&block.fStoredSize, 8)
+      && WriteBytes(&block.fRawSize, 8);
+  }
+  ok = ok && WriteBytes(&fNbRows, 8) && WriteBytes(&footerOffset, 8)
+          && WriteBytes(kIndexMagic, 8);
+  ok = (std::fclose(fFile) == 0) && ok;
+  fFile = 0;
+  if (!ok) G4cout << "### ColumnarWriter: error writing " << fFileName 
+                  << G4endl;
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,280 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Convergence.cc
+/// \brief Implementation of the Convergence class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "Convergence.hh"
+#include "ConvergenceMessenger.hh"
+#include "Run.hh"
+
+#include "G4AutoLock.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace {
+  const char* kTallyNames[Convergence::kNbTallies] = 
+    { "collimatorExit", "shieldExit", "argonEntry", "cryostatExit", 
+      "argonCapture" };
+  
+  // events of this thread not yet added to the run sums
+  struct ThreadSums {
+    ThreadSums() : fNbEvents(0) { Clear(); }
+    void Clear() {
+      fNbEvents = 0;
+      for (G4int k=0; k<Convergence::kNbTallies; ++k) {
+        fSum[k] = fSum2[k] = 0.;
+      }
+    }
+    G4int    fNbEvents;
+    G4double fSum[Convergence::kNbTallies];
+    G4double fSum2[Convergence::kNbTallies];
+  };
+  G4ThreadLocal ThreadSums* threadSums = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Convergence* Convergence::Instance()
+{
+  static Convergence instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Convergence::Convergence()
+: fTimeBudget(0.), fBatchSize(100), fNbEvents(0), fNbBatches(0), fStart(0.),
+  fOverTime(false), fDone(false), fMessenger(0)
+{
+  ClearTargets();
+  fMessenger = new ConvergenceMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Convergence::~Convergence()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const char* Convergence::GetTallyName(G4int tally)
+{
+  return (tally >= 0 && tally < kNbTallies) ? kTallyNames[tally] : "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int Convergence::FindTally(const G4String& name)
+{
+  for (G4int k=0; k<kNbTallies; ++k) {
+    if (name == kTallyNames[k]) return k;
+  }
+  return -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Convergence::ClearTargets()
+{
+  for (G4int k=0; k<kNbTallies; ++k) fTarget[k] = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Convergence::BeginOfRun()
+{
+  G4AutoLock lock(&fMutex);
+  for (G4int k=0; k<kNbTallies; ++k) fSums[k] = Sums();
+  fNbEvents = fNbBatches = 0;
+  fStart = Run::WallClock();
+  fOverTime = false;
+  fDone = false;
+  
+  G4bool adaptive = (fTimeBudget > 0.);
+  for (G4int k=0; k<kNbTallies; ++k) adaptive |= (fTarget[k] > 0.);
+  if (!adaptive) return;
+  
+  G4cout << "\n Adaptive run: stops when";
+  for (G4int k=0; k<kNbTallies; ++k) {
+    if (fTarget[k] > 0.) G4cout << " R(" << kTallyNames[k] << ") <= " 
+                                << fTarget[k];
+  }
+  if (fTimeBudget > 0.) G4cout << " or after " << fTimeBudget << " min";
+  G4cout << " (batches of " << fBatchSize << " events)" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Convergence::EndOfEvent(const G4double scores[kNbTallies])
+{
+  if (!threadSums) threadSums = new ThreadSums;
+  ThreadSums& sums = *threadSums;
+  for (G4int k=0; k<kNbTallies; ++k) {
+    sums.fSum[k]  += scores[k];
+    sums.fSum2[k] += scores[k]*scores[k];
+  }
+  if (++sums.fNbEvents >= fBatchSize) Flush(true);
+  
+  if (fTimeBudget > 0. && !IsDone() &&
+      Run::WallClock() - fStart > 60.*fTimeBudget) {
+    G4AutoLock lock(&fMutex);
+    fOverTime = true;
+    fDone = true;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Convergence::EndOfThreadRun()
+{
+  // an incomplete batch counts in the event sums only
+  if (threadSums && threadSums->fNbEvents > 0) Flush(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Convergence::Flush(G4bool batchDone)
+{
+  ThreadSums& sums = *threadSums;
+  G4AutoLock lock(&fMutex);
+  fNbEvents += sums.fNbEvents;
+  for (G4int k=0; k<kNbTallies; ++k) {
+    fSums[k].fSum  += sums.fSum[k];
+    fSums[k].fSum2 += sums.fSum2[k];
+    if (batchDone) {
+      G4double mean = sums.fSum[k]/sums.fNbEvents;
+      fSums[k].fBatchSum  += mean;
+      fSums[k].fBatchSum2 += mean*mean;
+    }
+  }
+  if (batchDone) fNbBatches++;
+  sums.Clear();
+  
+  if (batchDone && !fDone && CheckDone()) fDone = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Convergence::CheckDone() const
+{
+  // under fMutex
+  if (fNbBatches < kMinBatches) return false;
+  G4bool selected = false;
+  for (G4int k=0; k<kNbTallies; ++k) {
+    if (fTarget[k] <= 0.) continue;
+    selected = true;
+    G4double relError = BatchRelError(fSums[k]);
+    if (relError <= 0. || relError > fTarget[k]) return false;
+  }
+  return selected;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double Convergence::EventRelError(const Sums& sums) const
+{
+  // -1 if undefined (no score, or a single event)
+  if (fNbEvents < 2 || sums.fSum <= 0.) return -1.;
+  G4double n = (G4double)fNbEvents;
+  G4double mean = sums.fSum/n;
+  G4double variance = std::max(0., sums.fSum2/n - mean*mean)*n/(n-1.);
+  return std::sqrt(variance/n)/mean;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double Convergence::BatchRelError(const Sums& sums) const
+{
+  if (fNbBatches < 2 || sums.fBatchSum <= 0.) return -1.;
+  G4double n = (G4double)fNbBatches;
+  G4double mean = sums.fBatchSum/n;
+  G4double variance = std::max(0., sums.fBatchSum2/n - mean*mean)*n/(n-1.);
+  return std::sqrt(variance/n)/mean;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double Convergence::GetRelError(G4int tally)
+{
+  G4AutoLock lock(&fMutex);
+  return BatchRelError(fSums[tally]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Convergence::EndOfRun()
+{
+  G4AutoLock lock(&fMutex);
+  if (fNbEvents == 0) return;
+  G4double time = Run::WallClock() - fStart;
+  
+  G4int prec = G4cout.precision(3);
+  G4cout << "\n Tallies per event: " << fNbEvents << " events, " 
+         << fNbBatches << " batches of " << fBatchSize << ", wall time " 
+         << time << " s";
+  if (fDone) {
+    if (fOverTime) G4cout << " (stopped by the time budget)";
+    else           G4cout << " (stopped at the target errors)";
+  }
+  G4cout << "\n   R(evt): from the event scores;"
+         << " R(batch): from the batch means; FOM = 1/(R(batch)^2 T)\n"
+         << G4endl;
+  
+  G4cout << "  " << std::setw(16) << std::left << "tally" << std::right 
+         << std::setw(12) << "mean" << std::setw(10) << "R(evt)" 
+         << std::setw(10) << "R(batch)" << std::setw(10) << "target"
+         << std::setw(12) << "FOM (1/s)" << G4endl;
+  for (G4int k=0; k<kNbTallies; ++k) {
+    G4double eventError = EventRelError(fSums[k]);
+    G4double batchError = BatchRelError(fSums[k]);
+    G4cout << "  " << std::setw(16) << std::left << kTallyNames[k] 
+           << std::right << std::setw(12) << fSums[k].fSum/fNbEvents;
+    if (eventError > 0.) G4cout << std::setw(10) << eventError;
+    else                 G4cout << std::setw(10) << "-";
+    if (batchError > 0.) G4cout << std::setw(10) << batchError;
+    else                 G4cout << std::setw(10) << "-";
+    if (fTarget[k] > 0.) G4cout << std::setw(10) << fTarget[k];
+    else                 G4cout << std::setw(10) << "-";
+    if (batchError > 0. && time > 0.) {
+      G4cout << std::setw(12) << 1./(batchError*batchError*time);
+    }
+    else G4cout << std::setw(12) << "-";
+    G4cout << G4endl;
+  }
+  G4cout.precision(prec);
+  
+  fDone = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
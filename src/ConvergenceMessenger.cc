@@ -0,0 +1,131 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ConvergenceMessenger.cc
+/// \brief Implementation of the ConvergenceMessenger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ConvergenceMessenger.hh"
+
+#include "Convergence.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ConvergenceMessenger::ConvergenceMessenger(Convergence* convergence)
+:G4UImessenger(),fConvergence(convergence),
+ fConvergenceDir(0), fTargetCmd(0), fClearCmd(0), fTimeBudgetCmd(0),
+ fBatchSizeCmd(0)
+{ 
+  G4bool broadcast = false;
+  fConvergenceDir = new G4UIdirectory("/testhadr/convergence/",broadcast);
+  fConvergenceDir->SetGuidance("tally statistics and adaptive runs");
+  
+  G4String tallies;
+  for (G4int k=0; k<Convergence::kNbTallies; ++k) {
+    if (k > 0) tallies += " ";
+    tallies += Convergence::GetTallyName(k);
+  }
+  
+  fTargetCmd = new G4UIcommand("/testhadr/convergence/target",this);
+  fTargetCmd->SetGuidance("target relative error of a tally: beamOn n then");
+  fTargetCmd->SetGuidance("  stops before n events once all targets are met");
+  G4UIparameter* tallyPrm = new G4UIparameter("tally",'s',false);
+  tallyPrm->SetParameterCandidates(tallies);
+  fTargetCmd->SetParameter(tallyPrm);
+  G4UIparameter* errorPrm = new G4UIparameter("relError",'d',false);
+  errorPrm->SetParameterRange("relError>=0.");
+  fTargetCmd->SetParameter(errorPrm);
+  fTargetCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fTargetCmd->SetToBeBroadcasted(false);
+  
+  fClearCmd = new G4UIcmdWithoutParameter("/testhadr/convergence/clear",this);
+  fClearCmd->SetGuidance("remove all the target errors");
+  fClearCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fClearCmd->SetToBeBroadcasted(false);
+  
+  fTimeBudgetCmd = 
+    new G4UIcmdWithADouble("/testhadr/convergence/timeBudget",this);
+  fTimeBudgetCmd->SetGuidance("stop dispatching events after t minutes;");
+  fTimeBudgetCmd->SetGuidance("  0 for no limit");
+  fTimeBudgetCmd->SetParameterName("t",false);
+  fTimeBudgetCmd->SetRange("t>=0.");
+  fTimeBudgetCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fTimeBudgetCmd->SetToBeBroadcasted(false);
+  
+  fBatchSizeCmd = 
+    new G4UIcmdWithAnInteger("/testhadr/convergence/batchSize",this);
+  fBatchSizeCmd->SetGuidance("events per batch (consecutive events of a thread)");
+  fBatchSizeCmd->SetParameterName("n",false);
+  fBatchSizeCmd->SetRange("n>0");
+  fBatchSizeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fBatchSizeCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ConvergenceMessenger::~ConvergenceMessenger()
+{
+  delete fTargetCmd;
+  delete fClearCmd;
+  delete fTimeBudgetCmd;
+  delete fBatchSizeCmd;
+  delete fConvergenceDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ConvergenceMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{   
+  if (command == fTargetCmd)
+   { G4String name; G4double relError = 0.;
+     std::istringstream is(newValue);
+     is >> name >> relError;
+     G4int tally = Convergence::FindTally(name);
+     if (tally >= 0) fConvergence->SetTarget(tally, relError);
+   }
+   
+  if (command == fClearCmd)
+   {fConvergence->ClearTargets();}
+   
+  if (command == fTimeBudgetCmd)
+   {fConvergence->SetTimeBudget(fTimeBudgetCmd->GetNewDoubleValue(newValue));}
+   
+  if (command == fBatchSizeCmd)
+   {fConvergence->SetBatchSize(fBatchSizeCmd->GetNewIntValue(newValue));}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -46,6 +46,8 @@
 #include "G4PhysicalVolumeStore.hh"
 #include "G4LogicalVolumeStore.hh"
 #include "G4SolidStore.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
 #include "G4RunManager.hh"
 
 #include "G4UnitsTable.hh"
@@ -55,7 +57,8 @@
 
 DetectorConstruction::DetectorConstruction()
 :G4VUserDetectorConstruction(),
- fWorld_p(0), fWorld_l(0), fDetectorMessenger(0)
+ fWorld_p(0), fWorld_l(0), fFoam_l(0), fNeutronShield_l(0),
+ fShieldRegion(0), fDetectorMessenger(0)
 {
 	// Dimensions
   fWorldSize_x = 60*m;
@@ -202,6 +205,17 @@ void DetectorConstruction::DefineMaterials()
   fBPolyethylene->AddMaterial (Boron, 5*perCent);
   fBPolyethylene->AddMaterial (fPolyethylene, 95*perCent);
   
+  // Polyethylene with bound hydrogen, for the thermal scattering model
+  G4Element* H_PE = new G4Element("TS_H_of_Polyethylene", "H_PE", 1., 1.0079*g/mole);
+  fTSPolyethylene = new G4Material("TS_Polyethylene", 0.94*g/cm3, 2, kStateSolid);
+  fTSPolyethylene->AddElement(H_PE, 2);
+  fTSPolyethylene->AddElement(C, 1);
+  
+  // Borated Polyethylene with bound hydrogen
+  fTSBPolyethylene = new G4Material("TS_BPolyethylene", 0.92*g/cm3, 2);
+  fTSBPolyethylene->AddMaterial (Boron, 5*perCent);
+  fTSBPolyethylene->AddMaterial (fTSPolyethylene, 95*perCent);
+  
   // Polyurethane (foam Foam)
   fPolyurethane = new G4Material("Polyurethane", 0.088*g/cm3, 4);
   fPolyurethane->AddElement(C, 17);
@@ -222,6 +236,13 @@ void DetectorConstruction::DefineMaterials()
   fProtoduneFoam->AddElement(H, 16);
   fProtoduneFoam->AddElement(N, 2);
   fProtoduneFoam->AddElement(O, 4); 
+  
+  // protodune foam, hydrogen bound as in polyethylene (approximation)
+  fTSProtoduneFoam = new G4Material("TS_ProtoduneFoam", 0.135*g/cm3, 4);
+  fTSProtoduneFoam->AddElement(C, 17);
+  fTSProtoduneFoam->AddElement(H_PE, 16);
+  fTSProtoduneFoam->AddElement(N, 2);
+  fTSProtoduneFoam->AddElement(O, 4); 
 
 //  from protodune_v5.gdml  
 
@@ -249,14 +270,19 @@ void DetectorConstruction::DefineMaterials()
 //   <composite n="4" ref="oxygen"/>
 //  </material>
   
-  // Liquid argon
-  fLiquidArgon = man->FindOrBuildMaterial("G4_lAr"); 
+  // Liquid argon, at its operating temperature (Doppler broadening of HP data)
+  G4Material* lAr = man->FindOrBuildMaterial("G4_lAr");
+  fLiquidArgon = new G4Material("LiquidArgon", lAr->GetDensity(), lAr,
+                                kStateLiquid, 87.*kelvin);
    
   // Stainless steel
   fStainlessSteel= man->FindOrBuildMaterial("G4_STAINLESS-STEEL");
   
   // Neutron shield 
-  fNeutronShield_mat = man->FindOrBuildMaterial("G4_POLYETHYLENE");  
+  fNeutronShield_mat = fTSPolyethylene;
+  
+  // Cryostat insulation
+  fFoam_mat = fProtoduneFoam;
   
   //G4cout << *(G4Material::GetMaterialTable()) << G4endl;
 }
@@ -267,6 +293,8 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
 {
   // Cleanup old geometry
   G4GeometryManager::GetInstance()->OpenGeometry();
+  if (fShieldRegion && fNeutronShield_l)
+    fShieldRegion->RemoveRootLogicalVolume(fNeutronShield_l);
   G4PhysicalVolumeStore::GetInstance()->Clean();
   G4LogicalVolumeStore::GetInstance()->Clean();
   G4SolidStore::GetInstance()->Clean();
@@ -304,6 +332,40 @@ void DetectorConstruction::SetWorldSize(G4double value)
   G4RunManager::GetRunManager()->ReinitializeGeometry();
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetNeutronShieldMaterial(G4String value)
+{
+  G4Material* material = G4Material::GetMaterial(value, false);
+  if (!material) {
+    G4cout << "\n--> warning from DetectorConstruction::SetNeutronShieldMaterial : "
+           << value << " not found" << G4endl;
+    return;
+  }
+  fNeutronShield_mat = material;
+  if (fNeutronShield_l) {
+    fNeutronShield_l->SetMaterial(material);
+    G4RunManager::GetRunManager()->PhysicsHasBeenModified();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetFoamMaterial(G4String value)
+{
+  G4Material* material = G4Material::GetMaterial(value, false);
+  if (!material) {
+    G4cout << "\n--> warning from DetectorConstruction::SetFoamMaterial : "
+           << value << " not found" << G4endl;
+    return;
+  }
+  fFoam_mat = material;
+  if (fFoam_l) {
+    fFoam_l->SetMaterial(material);
+    G4RunManager::GetRunManager()->PhysicsHasBeenModified();
+  }
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void DetectorConstruction::ConstructWall()
 {
@@ -363,7 +425,7 @@ void DetectorConstruction::ConstructCryostat()
   G4Tubs* sNitrogen_BW = new G4Tubs("Nitrogen_BW",0, fBeamPlugRadius, fFoamThickness/4, 0.,CLHEP::twopi );  
   G4ThreeVector zTransFoam(0, 0, -fFoam_z/2 + fFoamThickness/4); 
   G4SubtractionSolid* sFoam = new G4SubtractionSolid("Foam", sFoam_block, sNitrogen_BW, 0, zTransFoam); 
-  fFoam_l = new G4LogicalVolume(sFoam, fProtoduneFoam, "Foam_l"); 
+  fFoam_l = new G4LogicalVolume(sFoam, fFoam_mat, "Foam_l"); 
   new G4PVPlacement(0,G4ThreeVector(0, 0, 0), fFoam_l, "Foam_p", fWorld_l, false, 0); 
   fFoam_l->SetVisAttributes(cyan_);
   
@@ -452,10 +514,8 @@ void DetectorConstruction::ConstructGammaShield()
 
 void DetectorConstruction::ConstructNeutronShield()
 {
-	// set default material
-	//fNeutronShield_mat = fBPolyethylene;
-	fNeutronShield_mat = fPolyethylene;
-	//fNeutronShield_mat = fAir;
+	// material: fNeutronShield_mat, see DefineMaterials()
+	// and /testhadr/det/setNeutronShieldMat
 	
 	// position
   G4double pos_x, pos_y, pos_z;
@@ -483,6 +543,13 @@ void DetectorConstruction::ConstructNeutronShield()
   fNeutronShield_l = new G4LogicalVolume(nshield_s2, fNeutronShield_mat, "NeutronShield_l");
   fNeutronShield_p = new G4PVPlacement(0, G4ThreeVector(0,0,0), fNeutronShield_l, "NeutronShield_p", fSourceVolume_l, false, 0);
   fNeutronShield_l->SetVisAttributes(grey_);
+  
+  // region, to restrict the thermal scattering model to the shield
+  if (!fShieldRegion) {
+    fShieldRegion = G4RegionStore::GetInstance()->GetRegion("ShieldRegion", false);
+    if (!fShieldRegion) fShieldRegion = new G4Region("ShieldRegion");
+  }
+  fShieldRegion->AddRootLogicalVolume(fNeutronShield_l);
 }
 
 
@@ -44,7 +44,8 @@
 
 DetectorMessenger::DetectorMessenger(DetectorConstruction * Det)
 :G4UImessenger(), 
- fDetector(Det), fTestemDir(0), fDetDir(0),  fWorldSizeCmd(0)
+ fDetector(Det), fTestemDir(0), fDetDir(0),  fWorldSizeCmd(0),
+ fShieldMatCmd(0), fFoamMatCmd(0)
 { 
   fTestemDir = new G4UIdirectory("/testhadr/");
   fTestemDir->SetGuidance("commands specific to this example");
@@ -59,6 +60,18 @@ DetectorMessenger::DetectorMessenger(DetectorConstruction * Det)
   fWorldSizeCmd->SetRange("WorldSize>0.");
   fWorldSizeCmd->SetUnitCategory("Length");
   fWorldSizeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  
+  fShieldMatCmd = new G4UIcmdWithAString("/testhadr/det/setNeutronShieldMat",this);
+  fShieldMatCmd->SetGuidance("Set material of the neutron shield");
+  fShieldMatCmd->SetGuidance("  (e.g. TS_Polyethylene, TS_BPolyethylene, G4_POLYETHYLENE)");
+  fShieldMatCmd->SetParameterName("material",false);
+  fShieldMatCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  
+  fFoamMatCmd = new G4UIcmdWithAString("/testhadr/det/setFoamMat",this);
+  fFoamMatCmd->SetGuidance("Set material of the cryostat insulation");
+  fFoamMatCmd->SetGuidance("  (ProtoduneFoam or TS_ProtoduneFoam)");
+  fFoamMatCmd->SetParameterName("material",false);
+  fFoamMatCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -66,6 +79,8 @@ DetectorMessenger::DetectorMessenger(DetectorConstruction * Det)
 DetectorMessenger::~DetectorMessenger()
 {
   delete fWorldSizeCmd;
+  delete fShieldMatCmd;
+  delete fFoamMatCmd;
   delete fDetDir;
   delete fTestemDir;
 }
@@ -77,6 +92,12 @@ void DetectorMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
    
   if( command == fWorldSizeCmd )
    { fDetector->SetWorldSize(fWorldSizeCmd->GetNewDoubleValue(newValue));}
+   
+  if( command == fShieldMatCmd )
+   { fDetector->SetNeutronShieldMaterial(newValue);}
+   
+  if( command == fFoamMatCmd )
+   { fDetector->SetFoamMaterial(newValue);}
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
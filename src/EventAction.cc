@@ -35,6 +35,15 @@
 #include "EventAction.hh"
 
 #include "Run.hh"
+#include "Checkpoint.hh"
+#include "Convergence.hh"
+#include "Watchdog.hh"
+#include "Telemetry.hh"
+#include "Records.hh"
+#include "StreamSink.hh"
+#include "FluenceTally.hh"
+#include "MeshTally.hh"
+#include "PointDetector.hh"
 #include "HistoManager.hh"
 
 #include "G4Event.hh"
@@ -42,12 +51,22 @@
 #include "G4SystemOfUnits.hh"
 #include "G4UnitsTable.hh"
 #include "G4ParticleGun.hh"
+#include "G4Step.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4ParticleDefinition.hh"
 #include "PrimaryGeneratorAction.hh"
+#include "RandomStreams.hh"
+#include "SlowEvents.hh"
+
+#include <algorithm>
+#include <sstream>
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 EventAction::EventAction(RunAction* run)
-:G4UserEventAction()
+:G4UserEventAction(), fEventStart(0.), fNbSteps(0), fNbSecondaries(0),
+ fDetailed(false)
 {  
   fRun = run;            
 } 
@@ -59,8 +78,19 @@ EventAction::~EventAction()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void EventAction::BeginOfEventAction(const G4Event*)
+void EventAction::BeginOfEventAction(const G4Event* evt)
 {
+  fEventStart = Run::WallClock();
+  fNbSteps = fNbSecondaries = 0;
+  fDetailed = SlowEvents::Instance()->GetNbSlowest() > 0;
+  if (fDetailed) {
+    fVolumeSteps.assign(G4LogicalVolumeStore::GetInstance()->size(), 0);
+    fParticleTime.clear();
+  }
+  Watchdog::Instance()->BeginOfEvent();
+  Records::Instance()->BeginOfEvent(evt->GetEventID());
+  StreamSink::Instance()->BeginOfEvent(evt->GetEventID());
+  
   // reset event parameters:
   neutronEnergy_gen = 0.;
   neutronEnergy_exitshield = 0.;    
@@ -72,6 +102,7 @@ void EventAction::BeginOfEventAction(const G4Event*)
   fCount_neutron_all2argon = 0;
   fCount_neutron_cryostat2world = 0;
   fCount_neutron_all2world = 0;
+  fCount_neutron_argonCapture = 0;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -86,7 +117,109 @@ void EventAction::EndOfEventAction(const G4Event* evt)
      (G4RunManager::GetRunManager()->GetUserPrimaryGeneratorAction());
   const G4ParticleGun* particleGun = generator->GetParticleGun();
   neutronEnergy_gen = particleGun->GetParticleEnergy();
-  G4AnalysisManager::Instance()->FillH1(0,neutronEnergy_gen);
+  HistoManager::FillH1(0,neutronEnergy_gen);
+  
+  Run* run = static_cast<Run*>(
+        G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  G4double eventEnd = Run::WallClock();
+  run->AddEventTime(fEventStart, eventEnd);
+  
+  // among the slowest events: keep it with its random stream
+  if (run->AddEventCost(eventEnd - fEventStart, fNbSteps, fNbSecondaries)) {
+    RandomStreams* streams = RandomStreams::Instance();
+    Run::EventCost cost;
+    cost.fEventID = evt->GetEventID();
+    cost.fThread  = G4Threading::G4GetThreadId();
+    if (streams->IsCounterBased()) {
+      cost.fStream = (G4long)streams->GetStreamIndex(cost.fEventID);
+    }
+    cost.fTime = eventEnd - fEventStart;
+    cost.fNbSteps = fNbSteps;
+    cost.fNbSecondaries = fNbSecondaries;
+    cost.fWhere = Where();
+    run->AddSlowEvent(cost);
+  }
+  
+  // key tallies, for their relative errors
+  G4double scores[Convergence::kNbTallies];
+  scores[Convergence::kCollimatorExit] = fCount_neutron_source2nitrogenBW;
+  scores[Convergence::kShieldExit]     = fCount_neutron_shield2world;
+  scores[Convergence::kArgonEntry]     = fCount_neutron_all2argon;
+  scores[Convergence::kCryostatExit]   = fCount_neutron_cryostat2world;
+  scores[Convergence::kArgonCapture]   = fCount_neutron_argonCapture;
+  Convergence* convergence = Convergence::Instance();
+  convergence->EndOfEvent(scores);
+  Telemetry::Instance()->EndOfEvent(fNbSteps, scores);
+  StreamSink::Instance()->EndOfEvent();
+  FluenceTally::Instance()->EndOfEvent();
+  MeshTally::Instance()->EndOfEvent();
+  PointDetector::Instance()->EndOfEvent();
+  // the MT run managers stop dispatching events (see RunManager)
+  if (convergence->IsDone() && !G4Threading::IsMultithreadedApplication()) {
+    G4RunManager::GetRunManager()->AbortRun(true);
+  }
+  
+  Checkpoint::Instance()->EndOfEvent(evt->GetEventID());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::CountStep(const G4Step* step)
+{
+  fNbSteps++;
+  fNbSecondaries += step->GetSecondaryInCurrentStep()->size();
+  if (!fDetailed) return;
+  size_t id = step->GetPreStepPoint()->GetTouchableHandle()
+                ->GetVolume()->GetLogicalVolume()->GetInstanceID();
+  if (id >= fVolumeSteps.size()) fVolumeSteps.resize(id+1, 0);
+  fVolumeSteps[id]++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::AddTrackTime(const G4ParticleDefinition* particle, 
+                               G4double time)
+{
+  if (fDetailed) fParticleTime[particle] += time;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String EventAction::Where() const
+{
+  // the 3 first particles by tracking time, volumes by number of steps
+  const size_t nbShown = 3;
+  std::ostringstream where;
+  where.precision(2);
+  
+  std::vector<std::pair<G4double,const G4ParticleDefinition*> > particles;
+  G4double totalTime = 0.;
+  std::map<const G4ParticleDefinition*,G4double>::const_iterator itp;
+  for (itp = fParticleTime.begin(); itp != fParticleTime.end(); ++itp) {
+    particles.push_back(std::make_pair(itp->second, itp->first));
+    totalTime += itp->second;
+  }
+  std::sort(particles.rbegin(), particles.rend());
+  for (size_t i=0; i<particles.size() && i<nbShown; ++i) {
+    where << particles[i].second->GetParticleName() << " " 
+          << (G4int)(100.*particles[i].first/totalTime + 0.5) << "% ";
+  }
+  where << "|";
+  
+  std::vector<std::pair<G4long,const G4LogicalVolume*> > volumes;
+  G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+  for (size_t i=0; i<store->size(); ++i) {
+    size_t id = (*store)[i]->GetInstanceID();
+    if (id < fVolumeSteps.size() && fVolumeSteps[id] > 0) {
+      volumes.push_back(std::make_pair(fVolumeSteps[id], (*store)[i]));
+    }
+  }
+  std::sort(volumes.rbegin(), volumes.rend());
+  for (size_t i=0; i<volumes.size() && i<nbShown; ++i) {
+    where << " " << volumes[i].second->GetName() << " " 
+          << (G4int)(100.*volumes[i].first/fNbSteps + 0.5) << "%";
+  }
+  return where.str();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,85 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EventChunkMessenger.cc
+/// \brief Implementation of the EventChunkMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "EventChunkMessenger.hh"
+
+#include "EventChunkPolicy.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventChunkMessenger::EventChunkMessenger(EventChunkPolicy* policy)
+:G4UImessenger(),fPolicy(policy),
+ fRunDir(0), fChunksCmd(0), fAdaptiveCmd(0)
+{ 
+  G4bool broadcast = false;
+  fRunDir = new G4UIdirectory("/testhadr/run/",broadcast);
+  fRunDir->SetGuidance("run manager commands");
+  
+  fChunksCmd = new G4UIcmdWithAnInteger("/testhadr/run/chunksPerThread",this);
+  fChunksCmd->SetGuidance("number of event chunks per thread and per run;");
+  fChunksCmd->SetGuidance("  ignored when /run/eventModulo is set");
+  fChunksCmd->SetParameterName("n",false);
+  fChunksCmd->SetRange("n>0");
+  fChunksCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  
+  fAdaptiveCmd = new G4UIcmdWithABool("/testhadr/run/adaptiveChunks",this);
+  fAdaptiveCmd->SetGuidance("shrink the event chunks as the run nears its end");
+  fAdaptiveCmd->SetParameterName("flag",true);
+  fAdaptiveCmd->SetDefaultValue(true);
+  fAdaptiveCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventChunkMessenger::~EventChunkMessenger()
+{
+  delete fChunksCmd;
+  delete fAdaptiveCmd;
+  delete fRunDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventChunkMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{   
+  if (command == fChunksCmd)
+   {fPolicy->SetChunksPerThread(fChunksCmd->GetNewIntValue(newValue));}
+   
+  if (command == fAdaptiveCmd)
+   {fPolicy->SetAdaptive(fAdaptiveCmd->GetNewBoolValue(newValue));}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,74 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EventChunkPolicy.cc
+/// \brief Implementation of the EventChunkPolicy class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "EventChunkPolicy.hh"
+#include "EventChunkMessenger.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventChunkPolicy::EventChunkPolicy()
+: fChunksPerThread(10), fAdaptive(true), fMessenger(0)
+{
+  fMessenger = new EventChunkMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventChunkPolicy::~EventChunkPolicy()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int EventChunkPolicy::ComputeModulo(G4int nEvents, G4int nThreads) const
+{
+  if (nThreads < 1) nThreads = 1;
+  G4int modulo = nEvents/(nThreads*fChunksPerThread);
+  return (modulo < 1) ? 1 : modulo;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int EventChunkPolicy::NextChunk(G4int nRemaining, G4int nThreads,
+                                  G4int modulo) const
+{
+  // guided scheduling: a chunk never exceeds half the fair share of the
+  // remaining events, down to single events at the very end of the run
+  if (!fAdaptive) return modulo;
+  if (nThreads < 1) nThreads = 1;
+  G4int chunk = nRemaining/(2*nThreads);
+  if (chunk > modulo) chunk = modulo;
+  return (chunk < 1) ? 1 : chunk;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
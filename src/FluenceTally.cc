@@ -0,0 +1,338 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file FluenceTally.cc
+/// \brief Implementation of the FluenceTally class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "FluenceTally.hh"
+#include "FluenceTallyMessenger.hh"
+#include "Campaign.hh"
+#include "Checkpoint.hh"
+#include "Run.hh"
+#include "TallySums.hh"
+
+#include "G4Step.hh"
+#include "G4Neutron.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4VSolid.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4AutoLock.hh"
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  // score of the current event, sums over the events, for the run fRun
+  struct ThreadSums {
+    ThreadSums() : fNbEvents(0), fRun(-1) {}
+    void Reset(size_t size, G4int run)
+    {
+      fEvent.assign(size, 0.);
+      fSum.assign(size, 0.);
+      fSum2.assign(size, 0.);
+      fTouched.clear();
+      fNbEvents = 0;
+      fRun = run;
+    }
+    std::vector<G4double> fEvent, fSum, fSum2;
+    std::vector<size_t>   fTouched;     // bins of fEvent not zero
+    G4long                fNbEvents;
+    G4int                 fRun;
+  };
+  G4ThreadLocal ThreadSums* threadSums = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FluenceTally* FluenceTally::Instance()
+{
+  static FluenceTally instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FluenceTally::FluenceTally()
+: fEnabled(false), fFileName("Hadr04"), fNbBins(600), 
+  fEmin(1.e-5*eV), fEmax(10.*MeV), fActive(false), fRunCount(0), 
+  fStride(0), fStart(0.), fNbEvents(0), fMessenger(0)
+{
+  fCellNames.push_back("LarPool_l");
+  fCellNames.push_back("Foam_l");
+  fCellNames.push_back("NeutronShield_l");
+  fMessenger = new FluenceTallyMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FluenceTally::~FluenceTally()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FluenceTally::AddCell(const G4String& volume)
+{
+  for (size_t i=0; i<fCellNames.size(); ++i) {
+    if (fCellNames[i] == volume) return;
+  }
+  fCellNames.push_back(volume);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FluenceTally::SetBinning(G4int nbins, G4double emin, G4double emax)
+{
+  if (nbins < 1 || !(emin > 0.) || !(emax > emin)) {
+    G4cout << "### FluenceTally: bad binning, unchanged" << G4endl;
+    return;
+  }
+  fNbBins = nbins;
+  fEmin = emin;
+  fEmax = emax;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FluenceTally::BeginOfRun()
+{
+  fActive = false;
+  if (!fEnabled) return;
+  
+  // cells: logical volumes by name, volume of all their placements
+  fCells.clear();
+  fVolumes.clear();
+  G4LogicalVolumeStore* logicalStore = G4LogicalVolumeStore::GetInstance();
+  G4PhysicalVolumeStore* physicalStore = G4PhysicalVolumeStore::GetInstance();
+  for (size_t i=0; i<fCellNames.size(); ++i) {
+    G4LogicalVolume* volume = 0;
+    for (size_t k=0; k<logicalStore->size() && !volume; ++k) {
+      if ((*logicalStore)[k]->GetName() == fCellNames[i]) {
+        volume = (*logicalStore)[k];
+      }
+    }
+    G4int nbPlacements = 0;
+    for (size_t k=0; k<physicalStore->size(); ++k) {
+      if ((*physicalStore)[k]->GetLogicalVolume() == volume) nbPlacements++;
+    }
+    if (!volume || nbPlacements == 0) {
+      G4cout << "### FluenceTally: no volume " << fCellNames[i] 
+             << " in the geometry, not scored" << G4endl;
+      fCells.push_back(0);
+      fVolumes.push_back(0.);
+      continue;
+    }
+    // the daughters are not part of the cell
+    G4double cubicVolume = volume->GetSolid()->GetCubicVolume();
+    for (G4int k=0; k<(G4int)volume->GetNoDaughters(); ++k) {
+      cubicVolume -= 
+        volume->GetDaughter(k)->GetLogicalVolume()->GetSolid()->GetCubicVolume();
+    }
+    fCells.push_back(volume);
+    fVolumes.push_back(nbPlacements*cubicVolume);
+  }
+  
+  // energy bins, evenly spaced in log(E)
+  std::vector<G4double> edges;
+  for (G4int i=0; i<=fNbBins; ++i) {
+    edges.push_back(fEmin*std::pow(fEmax/fEmin, G4double(i)/fNbBins));
+  }
+  if (!fBinning.Set(edges)) {
+    G4cout << "### FluenceTally: bins too narrow, no fluence scored" 
+           << G4endl;
+    return;
+  }
+  fStride = fNbBins + 3;
+  
+  G4AutoLock lock(&fMutex);
+  fSum.assign(fCells.size()*fStride, 0.);
+  fSum2.assign(fCells.size()*fStride, 0.);
+  fNbEvents = 0;
+  fStart = Run::WallClock();
+  fRunCount++;
+  fActive = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FluenceTally::PrepareThread()
+{
+  // arrays of this thread, reset at its first use in the run
+  if (!threadSums) threadSums = new ThreadSums;
+  if (threadSums->fRun != fRunCount) {
+    threadSums->Reset(fCells.size()*fStride, fRunCount);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FluenceTally::Score(const G4Step* step)
+{
+  if (step->GetTrack()->GetDefinition() != G4Neutron::Definition()) return;
+  const G4StepPoint* pre = step->GetPreStepPoint();
+  const G4LogicalVolume* volume = pre->GetPhysicalVolume()->GetLogicalVolume();
+  size_t cell = 0;
+  while (cell < fCells.size() && fCells[cell] != volume) ++cell;
+  if (cell == fCells.size()) return;
+  
+  // neutrons fly at the energy of the start of the step
+  G4double score = pre->GetWeight()*step->GetStepLength();
+  if (!(score > 0.)) return;
+  PrepareThread();
+  ThreadSums* sums = threadSums;
+  size_t first = cell*fStride;
+  size_t bins[2] = { first + fBinning.Index(pre->GetKineticEnergy()),
+                     first + fStride - 1 };
+  for (G4int k=0; k<2; ++k) {
+    G4double& event = sums->fEvent[bins[k]];
+    if (event == 0.) sums->fTouched.push_back(bins[k]);
+    event += score;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FluenceTally::EndOfEvent()
+{
+  if (!fActive) return;
+  PrepareThread();
+  ThreadSums* sums = threadSums;
+  for (size_t k=0; k<sums->fTouched.size(); ++k) {
+    size_t i = sums->fTouched[k];
+    G4double score = sums->fEvent[i];
+    sums->fSum[i]  += score;
+    sums->fSum2[i] += score*score;
+    sums->fEvent[i] = 0.;
+  }
+  sums->fTouched.clear();
+  sums->fNbEvents++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FluenceTally::EndOfThreadRun()
+{
+  if (!fActive || !threadSums || threadSums->fRun != fRunCount) return;
+  
+  G4AutoLock lock(&fMutex);
+  for (size_t i=0; i<fSum.size(); ++i) {
+    fSum[i]  += threadSums->fSum[i];
+    fSum2[i] += threadSums->fSum2[i];
+  }
+  fNbEvents += threadSums->fNbEvents;
+  threadSums->fRun = -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  // relative error of the mean of the event scores, -1 if undefined
+  G4double RelError(G4double sum, G4double sum2, G4double n)
+  {
+    if (n < 2. || sum <= 0.) return -1.;
+    G4double mean = sum/n;
+    G4double variance = std::max(0., sum2/n - mean*mean)*n/(n-1.);
+    return std::sqrt(variance/n)/mean;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FluenceTally::EndOfRun()
+{
+  if (!fActive) return;
+  fActive = false;
+  
+  G4AutoLock lock(&fMutex);
+  if (fNbEvents == 0) return;
+  G4double n = (G4double)fNbEvents;
+  G4double time = Run::WallClock() - fStart;
+  
+  G4int prec = G4cout.precision(3);
+  G4cout << "\n Track length fluence per source neutron (" << fNbEvents 
+         << " events):\n"
+         << "  cell                volume (cm3)  fluence (/cm2)  rel.error"
+         << "    FOM (/s)" << G4endl;
+  for (size_t c=0; c<fCells.size(); ++c) {
+    if (!fCells[c]) continue;
+    size_t total = c*fStride + fStride - 1;
+    G4double fluence = fSum[total]/n/fVolumes[c];
+    G4double error = RelError(fSum[total], fSum2[total], n);
+    G4cout << "  " << std::setw(18) << std::left << fCellNames[c] 
+           << std::right << std::setw(14) << fVolumes[c]/cm3
+           << std::setw(16) << fluence*cm2 << std::setw(11) << error;
+    if (error > 0. && time > 0.) G4cout << std::setw(12) << 1./(error*error*time);
+    G4cout << G4endl;
+  }
+  G4cout.precision(prec);
+  
+  WriteSpectra(fNbEvents);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FluenceTally::WriteSpectra(G4long nbEvents) const
+{
+  // raw sums (.h04s), summed as such over a campaign, and their text
+  TallySums sums(
+    "track length fluence per source neutron and per unit lethargy",
+    "cell Elow(MeV) Ehigh(MeV) fluence(/cm2) relError");
+  sums.SetNbEvents(nbEvents);
+  
+  // per unit lethargy: bins of ln(Emax/Emin)/nbins
+  G4double lethargy = std::log(fEmax/fEmin)/fNbBins;
+  for (size_t c=0; c<fCells.size(); ++c) {
+    if (!fCells[c]) continue;
+    for (G4int b=1; b<=fNbBins; ++b) {
+      size_t i = c*fStride + b;
+      std::ostringstream key;
+      key << fCellNames[c] << " " << fBinning.GetEdge(b-1)/MeV << " " 
+          << fBinning.GetEdge(b)/MeV;
+      sums.AddEntry(key.str(), cm2/fVolumes[c]/lethargy, fSum[i], fSum2[i]);
+    }
+  }
+  
+  Campaign* campaign = Campaign::Instance();
+  Checkpoint* checkpoint = Checkpoint::Instance();
+  G4String names[2] = { fFileName + "_fluence.txt", fFileName + "_fluence.h04s" };
+  names[0] = checkpoint->OutputName(campaign->OutputName(names[0], ".txt"));
+  names[1] = checkpoint->OutputName(campaign->OutputName(names[1], ".h04s"));
+  if (!sums.WriteText(names[0]) || !sums.Write(names[1])) {
+    G4cout << "### FluenceTally: cannot write " << names[0] << " or " 
+           << names[1] << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
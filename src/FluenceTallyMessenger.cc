@@ -0,0 +1,138 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file FluenceTallyMessenger.cc
+/// \brief Implementation of the FluenceTallyMessenger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "FluenceTallyMessenger.hh"
+
+#include "FluenceTally.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FluenceTallyMessenger::FluenceTallyMessenger(FluenceTally* tally)
+:G4UImessenger(),fTally(tally),
+ fFluenceDir(0), fEnableCmd(0), fCellCmd(0), fClearCellsCmd(0), 
+ fBinningCmd(0), fFileCmd(0)
+{ 
+  G4bool broadcast = false;
+  fFluenceDir = new G4UIdirectory("/testhadr/fluence/",broadcast);
+  fFluenceDir->SetGuidance("track length fluence of the neutrons in cells");
+  
+  fEnableCmd = new G4UIcmdWithABool("/testhadr/fluence/enable",this);
+  fEnableCmd->SetGuidance("score the fluence in the next runs");
+  fEnableCmd->SetParameterName("flag",true);
+  fEnableCmd->SetDefaultValue(true);
+  fEnableCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fEnableCmd->SetToBeBroadcasted(false);
+  
+  fCellCmd = new G4UIcmdWithAString("/testhadr/fluence/cell",this);
+  fCellCmd->SetGuidance("add a cell, by the name of its logical volume;");
+  fCellCmd->SetGuidance("  LarPool_l, Foam_l and NeutronShield_l by default");
+  fCellCmd->SetParameterName("volume",false);
+  fCellCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fCellCmd->SetToBeBroadcasted(false);
+  
+  fClearCellsCmd = new G4UIcmdWithoutParameter("/testhadr/fluence/clearCells",this);
+  fClearCellsCmd->SetGuidance("remove all the cells");
+  fClearCellsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fClearCellsCmd->SetToBeBroadcasted(false);
+  
+  fBinningCmd = new G4UIcommand("/testhadr/fluence/binning",this);
+  fBinningCmd->SetGuidance("energy bins, equal in lethargy");
+  fBinningCmd->SetGuidance("  (default: 600 bins from 1e-5 eV to 10 MeV)");
+  G4UIparameter* nbPrm = new G4UIparameter("nbins",'i',false);
+  nbPrm->SetParameterRange("nbins>0");
+  fBinningCmd->SetParameter(nbPrm);
+  G4UIparameter* minPrm = new G4UIparameter("emin",'d',false);
+  minPrm->SetParameterRange("emin>0.");
+  fBinningCmd->SetParameter(minPrm);
+  G4UIparameter* maxPrm = new G4UIparameter("emax",'d',false);
+  maxPrm->SetParameterRange("emax>0.");
+  fBinningCmd->SetParameter(maxPrm);
+  G4UIparameter* unitPrm = new G4UIparameter("unit",'s',true);
+  unitPrm->SetDefaultUnit("MeV");
+  fBinningCmd->SetParameter(unitPrm);
+  fBinningCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fBinningCmd->SetToBeBroadcasted(false);
+  
+  fFileCmd = new G4UIcmdWithAString("/testhadr/fluence/file",this);
+  fFileCmd->SetGuidance("stem of the file of spectra, <file>_fluence.txt");
+  fFileCmd->SetParameterName("file",false);
+  fFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fFileCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FluenceTallyMessenger::~FluenceTallyMessenger()
+{
+  delete fEnableCmd;
+  delete fCellCmd;
+  delete fClearCellsCmd;
+  delete fBinningCmd;
+  delete fFileCmd;
+  delete fFluenceDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FluenceTallyMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{   
+  if (command == fEnableCmd)
+   {fTally->SetEnabled(fEnableCmd->GetNewBoolValue(newValue));}
+   
+  if (command == fCellCmd)
+   {fTally->AddCell(newValue);}
+   
+  if (command == fClearCellsCmd)
+   {fTally->ClearCells();}
+   
+  if (command == fBinningCmd)
+   { G4int nbins; G4double emin, emax; G4String unit;
+     std::istringstream is(newValue);
+     is >> nbins >> emin >> emax >> unit;
+     G4double u = G4UIcommand::ValueOf(unit);
+     fTally->SetBinning(nbins, emin*u, emax*u);
+   }
+   
+  if (command == fFileCmd)
+   {fTally->SetFileName(newValue);}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -31,20 +31,44 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #include "HistoManager.hh"
+#include "HistoManagerMessenger.hh"
 #include "G4UnitsTable.hh"
+#include "G4Threading.hh"
+
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreadLocal uint64_t HistoManager::fH1Mask = 0;
+G4ThreadLocal uint64_t HistoManager::fH2Mask = 0;
+G4ThreadLocal uint64_t HistoManager::fSparseMask = 0;
+G4ThreadLocal uint64_t HistoManager::fNtupleMask = 0;
+G4ThreadLocal uint64_t HistoManager::fLogMask = 0;
+G4ThreadLocal std::vector<LogHisto*>* HistoManager::fLogH1s = 0;
+uint64_t HistoManager::fLethargyMask = 0;
+G4bool   HistoManager::fFastLogBinning = true;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 HistoManager::HistoManager()
-  : fFileName("Hadr04")
+  : fFileName("Hadr04"), fMessenger(0)
 {
   Book();
+  // commands of the master, not broadcast
+  if (G4Threading::IsMasterThread()) fMessenger = new HistoManagerMessenger(this);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 HistoManager::~HistoManager()
 {
+  if (fLogH1s) {
+    for (size_t i=0; i<fLogH1s->size(); ++i) delete (*fLogH1s)[i];
+    delete fLogH1s;
+    fLogH1s = 0;
+  }
+  fLogMask = 0;
+  delete fMessenger;
   delete G4AnalysisManager::Instance();
 }
 
@@ -61,8 +85,11 @@ void HistoManager::Book()
   analysisManager->SetActivation(true);     //enable inactivation of histograms
    
 
-  // Default values (to be reset via /analysis/h1/set command)               
-  G4int nbins = 100;
+  // Default values (to be reset via /analysis/h1/set command)
+  // An inactive histogram keeps a single bin: /analysis/h1/set (h2/set)
+  // gives it its binning when activating it, so that only the histograms
+  // used by the macro take memory in each thread               
+  G4int nbins = 1;
   G4double vmin = 0.;
   G4double vmax = 100.;
 
@@ -118,6 +145,14 @@ void HistoManager::Book()
   ih = analysisManager->CreateH1("capture_time", "neutron capture time",nbins,vmin,vmax);
   analysisManager->SetH1Activation(ih, false);
   
+  // ID=12
+  ih = analysisManager->CreateH1("gammaEnergy_captureArgon", "capture gammas emitted in argon", nbins, vmin, vmax); 
+  analysisManager->SetH1Activation(ih, false);
+  
+  // ID=13
+  ih = analysisManager->CreateH1("gammaSum_captureArgon", "summed capture gamma energy per capture in argon", nbins, vmin, vmax); 
+  analysisManager->SetH1Activation(ih, false);
+  
   // 2D histograms
   
   // ID=0
@@ -220,6 +255,70 @@ void HistoManager::Book()
   analysisManager->FinishNtuple();  
   
   analysisManager->SetNtupleActivation(true); 
+  
+  // flux ntuples: not filled, booked inactive (/analysis/ntuple/setActivation)
+  analysisManager->SetNtupleActivation(3, false);
+  analysisManager->SetNtupleActivation(4, false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::UpdateActivation()
+{
+  G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+  fH1Mask = fH2Mask = fNtupleMask = fLogMask = 0;
+  fSparseMask = SparseScoring::Instance()->GetH2Mask();
+  if (!analysisManager->IsActive()) return;
+  
+  G4int nbH1 = std::min(analysisManager->GetNofH1s(), 64);
+  if (!fLogH1s) fLogH1s = new std::vector<LogHisto*>;
+  fLogH1s->resize(nbH1, 0);
+  for (G4int id=0; id<nbH1; ++id) {
+    if (!analysisManager->GetH1Activation(id)) continue;
+    fH1Mask |= uint64_t(1) << id;
+    
+    // log binning, as given by /analysis/h1/set ... log
+    G4bool lethargy = IsActive(fLethargyMask, id);
+    if (!fFastLogBinning && !lethargy) continue;
+    tools::histo::h1d* h1 = analysisManager->GetH1(id, false, false);
+    if (!h1) continue;
+    if (!(*fLogH1s)[id]) (*fLogH1s)[id] = new LogHisto;
+    if ((*fLogH1s)[id]->Set(*h1, analysisManager->GetH1Unit(id), lethargy)) {
+      fLogMask |= uint64_t(1) << id;
+    }
+    else if (lethargy && G4Threading::IsMasterThread()) {
+      G4cout << "### HistoManager: H1 " << id << " has no log binning, "
+             << "it is not filled in lethargy form" << G4endl;
+    }
+  }
+  G4int nbH2 = std::min(analysisManager->GetNofH2s(), 64);
+  for (G4int id=0; id<nbH2; ++id) {
+    if (analysisManager->GetH2Activation(id)) fH2Mask |= uint64_t(1) << id;
+  }
+  G4int nbNtuples = std::min(analysisManager->GetNofNtuples(), 64);
+  for (G4int id=0; id<nbNtuples; ++id) {
+    if (analysisManager->GetNtupleActivation(id)) 
+      fNtupleMask |= uint64_t(1) << id;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::FlushThread()
+{
+  if (!fLogH1s) return;
+  G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+  for (size_t id=0; id<fLogH1s->size(); ++id) {
+    if (!IsActive(fLogMask, id)) continue;
+    (*fLogH1s)[id]->Flush(analysisManager->GetH1(id, false, false));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::SetLethargy(G4int id)
+{
+  if (id >= 0 && id < 64) fLethargyMask |= uint64_t(1) << id;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
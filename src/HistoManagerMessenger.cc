@@ -0,0 +1,98 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file HistoManagerMessenger.cc
+/// \brief Implementation of the HistoManagerMessenger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "HistoManagerMessenger.hh"
+
+#include "HistoManager.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HistoManagerMessenger::HistoManagerMessenger(HistoManager* manager)
+:G4UImessenger(),fHistoManager(manager),
+ fHistoDir(0), fLethargyCmd(0), fClearLethargyCmd(0), fFastLogCmd(0)
+{ 
+  G4bool broadcast = false;
+  fHistoDir = new G4UIdirectory("/testhadr/histo/",broadcast);
+  fHistoDir->SetGuidance("filling of the histograms");
+  
+  fLethargyCmd = new G4UIcmdWithAnInteger("/testhadr/histo/lethargy",this);
+  fLethargyCmd->SetGuidance("fill an H1 in lethargy form, E dN/dE;");
+  fLethargyCmd->SetGuidance("  its binning must be log (/analysis/h1/set ... log)");
+  fLethargyCmd->SetParameterName("id",false);
+  fLethargyCmd->SetRange("id>=0 && id<64");
+  fLethargyCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fLethargyCmd->SetToBeBroadcasted(false);
+  
+  fClearLethargyCmd = new G4UIcmdWithoutParameter("/testhadr/histo/clearLethargy",this);
+  fClearLethargyCmd->SetGuidance("no H1 in lethargy form");
+  fClearLethargyCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fClearLethargyCmd->SetToBeBroadcasted(false);
+  
+  fFastLogCmd = new G4UIcmdWithABool("/testhadr/histo/fastLogBinning",this);
+  fFastLogCmd->SetGuidance("bin of the H1s of log binning from the bits of the value,");
+  fFastLogCmd->SetGuidance("  instead of a search of the edges (default: true)");
+  fFastLogCmd->SetParameterName("flag",true);
+  fFastLogCmd->SetDefaultValue(true);
+  fFastLogCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fFastLogCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HistoManagerMessenger::~HistoManagerMessenger()
+{
+  delete fLethargyCmd;
+  delete fClearLethargyCmd;
+  delete fFastLogCmd;
+  delete fHistoDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManagerMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{   
+  if (command == fLethargyCmd)
+   {fHistoManager->SetLethargy(fLethargyCmd->GetNewIntValue(newValue));}
+   
+  if (command == fClearLethargyCmd)
+   {fHistoManager->ClearLethargy();}
+   
+  if (command == fFastLogCmd)
+   {fHistoManager->SetFastLogBinning(fFastLogCmd->GetNewBoolValue(newValue));}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,108 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file LogBinning.cc
+/// \brief Implementation of the LogBinning class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "LogBinning.hh"
+
+#include <cmath>
+#include <limits>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// the table is filled at load time, before any run
+G4double     LogBinning::fLog2Table[LogBinning::kTableSize];
+const G4bool LogBinning::fTableReady = LogBinning::InitTable();
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool LogBinning::InitTable()
+{
+  // log2 at the middle of each interval of the mantissa
+  for (G4int i=0; i<kTableSize; ++i) {
+    fLog2Table[i] = std::log2(1. + (i + 0.5)/kTableSize);
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+LogBinning::LogBinning()
+: fNbins(0), fScale(0.), fOffset(0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+LogBinning::~LogBinning()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool LogBinning::Set(const std::vector<G4double>& edges)
+{
+  fNbins = 0;
+  fEdges.clear();
+  G4int nbins = (G4int)edges.size() - 1;
+  if (nbins < 1 || !(edges[0] > 0.) || !(edges[nbins] > edges[0])) {
+    return false;
+  }
+  
+  // evenly spaced in log(x), up to the rounding of the edges
+  G4double width = std::log2(edges[nbins]/edges[0])/nbins;
+  for (G4int i=0; i<nbins; ++i) {
+    G4double step = std::log2(edges[i+1]/edges[i]);
+    if (std::fabs(step - width) > 1.e-6*width) return false;
+  }
+  
+  // the log2 of the table is good to 0.7e-3 of an octave: the estimate
+  // stays within one bin up to about 1500 bins per decade
+  fScale = 1./width;
+  if (fScale > 512.) return false;
+  fOffset = 1. - fScale*std::log2(edges[0]);
+  
+  fNbins = nbins;
+  fEdges.reserve(nbins + 3);
+  fEdges.push_back(-std::numeric_limits<G4double>::infinity());
+  fEdges.insert(fEdges.end(), edges.begin(), edges.end());
+  fEdges.push_back(std::numeric_limits<G4double>::infinity());
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int LogBinning::SearchIndex(G4double x) const
+{
+  // first edge above x, among the n+1 edges of the bins
+  std::vector<G4double>::const_iterator it 
+    = std::upper_bound(fEdges.begin() + 1, fEdges.end() - 1, x);
+  return G4int(it - fEdges.begin()) - 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
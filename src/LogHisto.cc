@@ -0,0 +1,94 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file LogHisto.cc
+/// \brief Implementation of the LogHisto class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "LogHisto.hh"
+
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+LogHisto::LogHisto()
+: fInverseUnit(1.), fWeightScale(1.), fEmpty(true)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+LogHisto::~LogHisto()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool LogHisto::Set(const tools::histo::h1d& h1, G4double unit, 
+                     G4bool lethargy)
+{
+  const tools::histo::axis1& axis = h1.axis();
+  std::vector<G4double> edges;
+  for (unsigned int i=0; i<axis.bins(); ++i) {
+    edges.push_back(axis.bin_lower_edge(i));
+  }
+  edges.push_back(axis.upper_edge());
+  if (!fBinning.Set(edges) || !(unit > 0.)) return false;
+  
+  fInverseUnit = 1./unit;
+  // bins of ln(2)/(bins per octave) in lethargy
+  fWeightScale = lethargy ? fBinning.GetBinsPerOctave()/std::log(2.) : 1.;
+  fBins.assign(fBinning.GetNbins() + 2, Bin());
+  fEmpty = true;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void LogHisto::Flush(tools::histo::h1d* h1)
+{
+  if (fEmpty || !h1) return;
+  
+  // the sums in an empty copy of the H1, then added to it
+  tools::histo::h1d sums(*h1);
+  sums.reset();
+  tools::histo::h1d::hd_t data = sums.get_histo_data();
+  if (data.m_bin_entries.size() != fBins.size()) return;
+  for (size_t i=0; i<fBins.size(); ++i) {
+    data.m_bin_entries[i] = fBins[i].fEntries;
+    data.m_bin_Sw[i]      = fBins[i].fSw;
+    data.m_bin_Sw2[i]     = fBins[i].fSw2;
+    data.m_bin_Sxw[i][0]  = fBins[i].fSxw;
+    data.m_bin_Sx2w[i][0] = fBins[i].fSx2w;
+  }
+  sums.copy_from_data(data);
+  h1->add(sums);
+  
+  fBins.assign(fBins.size(), Bin());
+  fEmpty = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
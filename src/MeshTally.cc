@@ -0,0 +1,372 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file MeshTally.cc
+/// \brief Implementation of the MeshTally class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "MeshTally.hh"
+#include "MeshTallyMessenger.hh"
+#include "Campaign.hh"
+#include "Checkpoint.hh"
+
+#include "G4Step.hh"
+#include "G4Neutron.hh"
+#include "G4VProcess.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4AutoLock.hh"
+
+#include <cmath>
+#include <iomanip>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  const uint64_t kEmpty = ~uint64_t(0);
+  
+  // scores of the current event by voxel: open addressing hash table,
+  // at most half full, and its used slots
+  class EventMap {
+    public:
+      EventMap() : fShift(64 - 8) { fSlots.assign(256, Empty()); }
+      
+      void Add(uint64_t key, G4double score)
+      {
+        size_t mask = fSlots.size() - 1;
+        size_t i = Hash(key);
+        while (fSlots[i].fKey != key) {
+          if (fSlots[i].fKey == kEmpty) {
+            if (2*(fUsed.size() + 1) > fSlots.size()) {
+              Grow();
+              Add(key, score);
+              return;
+            }
+            fSlots[i].fKey = key;
+            fUsed.push_back(i);
+            break;
+          }
+          i = (i + 1) & mask;
+        }
+        fSlots[i].fScore += score;
+      }
+      
+      // gives the scores to the mesh and clears the table
+      void Flush(SparseMesh* mesh)
+      {
+        for (size_t k=0; k<fUsed.size(); ++k) {
+          Slot& slot = fSlots[fUsed[k]];
+          mesh->AddEventScore(slot.fKey, slot.fScore);
+          slot = Empty();
+        }
+        fUsed.clear();
+      }
+      
+    private:
+      struct Slot {
+        uint64_t fKey;
+        G4double fScore;
+      };
+      static Slot Empty() { Slot slot = { kEmpty, 0. }; return slot; }
+      size_t Hash(uint64_t key) const
+        { return (key*0x9E3779B97F4A7C15ULL) >> fShift; }
+      
+      void Grow()
+      {
+        std::vector<Slot> slots(2*fSlots.size(), Empty());
+        slots.swap(fSlots);
+        fShift--;
+        size_t mask = fSlots.size() - 1;
+        for (size_t k=0; k<fUsed.size(); ++k) {
+          const Slot& slot = slots[fUsed[k]];
+          size_t i = Hash(slot.fKey);
+          while (fSlots[i].fKey != kEmpty) i = (i + 1) & mask;
+          fSlots[i] = slot;
+          fUsed[k] = i;
+        }
+      }
+      
+      std::vector<Slot>   fSlots;        // a power of 2
+      std::vector<size_t> fUsed;
+      G4int               fShift;
+  };
+  
+  // weighted track length, in the event map, of each voxel crossed
+  struct TrackLength {
+    TrackLength(EventMap& event, G4double weight) 
+    : fEvent(event), fWeight(weight) {}
+    void operator()(uint64_t key, G4double length) 
+      { fEvent.Add(key, fWeight*length); }
+    EventMap& fEvent;
+    G4double  fWeight;
+  };
+  
+  // meshes of this thread and scores of its current event, for the run fRun
+  struct ThreadMeshes {
+    ThreadMeshes() : fNbEvents(0), fRun(-1) {}
+   ~ThreadMeshes() { Delete(); }
+    void Delete()
+    {
+      for (size_t i=0; i<fMeshes.size(); ++i) delete fMeshes[i];
+      fMeshes.clear();
+      fEvents.clear();
+      fNbEvents = 0;
+      fRun = -1;
+    }
+    std::vector<SparseMesh*> fMeshes;
+    std::vector<EventMap>    fEvents;
+    G4long                   fNbEvents;
+    G4int                    fRun;
+  };
+  G4ThreadLocal ThreadMeshes* threadMeshes = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MeshTally* MeshTally::Instance()
+{
+  static MeshTally instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MeshTally::MeshTally()
+: fFileName("Hadr04"), fActive(false), fRunCount(0), fNbEvents(0), 
+  fMessenger(0)
+{
+  fMessenger = new MeshTallyMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MeshTally::~MeshTally()
+{
+  Clear();
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MeshTally::Create(const G4String& name, G4int quantity,
+                       const G4ThreeVector& lower, const G4ThreeVector& upper,
+                       G4double voxel, const G4String& volume)
+{
+  // cubic voxels; the upper corner is moved to a whole number of them
+  Definition definition;
+  for (G4int k=0; k<3; ++k) {
+    G4double n = std::ceil((upper[k] - lower[k])/voxel - 1.e-9);
+    if (!(voxel > 0.) || !(n >= 1.) || n > (1 << 21)) {
+      G4cout << "### MeshTally: bad limits or voxel size of " << name 
+             << ", not created" << G4endl;
+      return;
+    }
+    definition.fN[k] = G4int(n);
+  }
+  definition.fName = name;
+  definition.fQuantity = quantity;
+  definition.fLower = lower;
+  definition.fUpper = lower + voxel*G4ThreeVector(definition.fN[0], 
+                                      definition.fN[1], definition.fN[2]);
+  definition.fVolumeName = (volume == "all") ? G4String("") : volume;
+  definition.fVolume = 0;
+  definition.fSum = 0;
+  
+  // a mesh of same name is replaced
+  for (size_t i=0; i<fDefinitions.size(); ++i) {
+    if (fDefinitions[i].fName == name) {
+      delete fDefinitions[i].fSum;
+      fDefinitions[i] = definition;
+      return;
+    }
+  }
+  fDefinitions.push_back(definition);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MeshTally::Clear()
+{
+  for (size_t i=0; i<fDefinitions.size(); ++i) delete fDefinitions[i].fSum;
+  fDefinitions.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MeshTally::BeginOfRun()
+{
+  fActive = false;
+  if (fDefinitions.empty()) return;
+  
+  G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+  G4AutoLock lock(&fMutex);
+  for (size_t i=0; i<fDefinitions.size(); ++i) {
+    Definition& definition = fDefinitions[i];
+    definition.fVolume = 0;
+    if (!definition.fVolumeName.empty()) {
+      for (size_t k=0; k<store->size() && !definition.fVolume; ++k) {
+        if ((*store)[k]->GetName() == definition.fVolumeName) {
+          definition.fVolume = (*store)[k];
+        }
+      }
+      if (!definition.fVolume) {
+        G4cout << "### MeshTally: no volume " << definition.fVolumeName
+               << " in the geometry, mesh " << definition.fName 
+               << " scores in all volumes" << G4endl;
+      }
+    }
+    delete definition.fSum;
+    definition.fSum = new SparseMesh(definition.fN[0], definition.fN[1], 
+                       definition.fN[2], definition.fLower, definition.fUpper);
+  }
+  fNbEvents = 0;
+  fRunCount++;
+  fActive = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MeshTally::PrepareThread()
+{
+  // meshes of this thread, made at its first use in the run
+  if (!threadMeshes) threadMeshes = new ThreadMeshes;
+  if (threadMeshes->fRun == fRunCount) return;
+  threadMeshes->Delete();
+  for (size_t i=0; i<fDefinitions.size(); ++i) {
+    const Definition& definition = fDefinitions[i];
+    threadMeshes->fMeshes.push_back(new SparseMesh(definition.fN[0], 
+      definition.fN[1], definition.fN[2], definition.fLower, definition.fUpper));
+  }
+  threadMeshes->fEvents.resize(fDefinitions.size());
+  threadMeshes->fRun = fRunCount;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MeshTally::Score(const G4Step* step)
+{
+  if (step->GetTrack()->GetDefinition() != G4Neutron::Definition()) return;
+  const G4StepPoint* pre = step->GetPreStepPoint();
+  const G4StepPoint* post = step->GetPostStepPoint();
+  const G4LogicalVolume* volume = pre->GetPhysicalVolume()->GetLogicalVolume();
+  const G4VProcess* process = post->GetProcessDefinedStep();
+  G4bool capture = process && process->GetProcessName() == "nCapture";
+  G4double weight = pre->GetWeight();
+  
+  PrepareThread();
+  ThreadMeshes* meshes = threadMeshes;
+  for (size_t i=0; i<fDefinitions.size(); ++i) {
+    const Definition& definition = fDefinitions[i];
+    if (definition.fVolume && definition.fVolume != volume) continue;
+    EventMap& event = meshes->fEvents[i];
+    if (definition.fQuantity == kFluence) {
+      TrackLength trackLength(event, weight);
+      meshes->fMeshes[i]->Traverse(pre->GetPosition(), post->GetPosition(), 
+                                   trackLength);
+    }
+    else if (capture) {
+      uint64_t key;
+      if (meshes->fMeshes[i]->Find(post->GetPosition(), key)) {
+        event.Add(key, weight);
+      }
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MeshTally::EndOfEvent()
+{
+  if (!fActive) return;
+  PrepareThread();
+  ThreadMeshes* meshes = threadMeshes;
+  for (size_t i=0; i<meshes->fMeshes.size(); ++i) {
+    meshes->fEvents[i].Flush(meshes->fMeshes[i]);
+  }
+  meshes->fNbEvents++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MeshTally::EndOfThreadRun()
+{
+  if (!fActive || !threadMeshes || threadMeshes->fRun != fRunCount) return;
+  
+  {
+    G4AutoLock lock(&fMutex);
+    for (size_t i=0; i<fDefinitions.size(); ++i) {
+      fDefinitions[i].fSum->Add(*threadMeshes->fMeshes[i]);
+    }
+    fNbEvents += threadMeshes->fNbEvents;
+  }
+  
+  // the blocks of this thread are not kept between the runs
+  threadMeshes->Delete();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MeshTally::EndOfRun()
+{
+  if (!fActive) return;
+  fActive = false;
+  
+  G4AutoLock lock(&fMutex);
+  if (fNbEvents == 0) return;
+  
+  Campaign* campaign = Campaign::Instance();
+  G4int prec = G4cout.precision(3);
+  G4cout << "\n Mesh tallies (" << fNbEvents << " events):\n"
+         << "  mesh          quantity        voxels    blocks  memory (MB)"
+         << "  dense (MB)   total per event" << G4endl;
+  for (size_t i=0; i<fDefinitions.size(); ++i) {
+    const Definition& definition = fDefinitions[i];
+    const SparseMesh* mesh = definition.fSum;
+    G4double total = mesh->GetTotal()/fNbEvents;
+    G4cout << "  " << std::setw(14) << std::left << definition.fName
+           << std::setw(9) << (definition.fQuantity == kFluence ? 
+                               "fluence" : "capture") << std::right
+           << std::setw(14) << G4double(mesh->GetNx())*mesh->GetNy()*mesh->GetNz()
+           << std::setw(10) << mesh->GetNbBlocks()
+           << std::setw(13) << mesh->GetMemory()/1.e6
+           << std::setw(12) << mesh->GetDenseMemory()/1.e6;
+    if (definition.fQuantity == kFluence) G4cout << std::setw(13) << total/m << " m";
+    else                                  G4cout << std::setw(13) << total;
+    G4cout << G4endl;
+    
+    G4String name = Checkpoint::Instance()->OutputName(campaign->OutputName(
+                      fFileName + "_mesh_" + definition.fName + ".h04v", ".h04v"));
+    if (!mesh->Write(name, fNbEvents)) {
+      G4cout << "### MeshTally: cannot write " << name << G4endl;
+    }
+  }
+  G4cout.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,128 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file MeshTallyMessenger.cc
+/// \brief Implementation of the MeshTallyMessenger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "MeshTallyMessenger.hh"
+
+#include "MeshTally.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MeshTallyMessenger::MeshTallyMessenger(MeshTally* tally)
+:G4UImessenger(),fTally(tally),
+ fMeshDir(0), fCreateCmd(0), fClearCmd(0), fFileCmd(0)
+{ 
+  G4bool broadcast = false;
+  fMeshDir = new G4UIdirectory("/testhadr/mesh/",broadcast);
+  fMeshDir->SetGuidance("cartesian mesh tallies of the neutrons");
+  
+  fCreateCmd = new G4UIcommand("/testhadr/mesh/create",this);
+  fCreateCmd->SetGuidance("create a mesh, or replace the mesh of same name:");
+  fCreateCmd->SetGuidance("  name, fluence or capture, limits along x, y, z,");
+  fCreateCmd->SetGuidance("  size of the cubic voxels, unit, and the logical");
+  fCreateCmd->SetGuidance("  volume where to score (all by default)");
+  G4UIparameter* namePrm = new G4UIparameter("name",'s',false);
+  fCreateCmd->SetParameter(namePrm);
+  G4UIparameter* quantityPrm = new G4UIparameter("quantity",'s',false);
+  quantityPrm->SetParameterCandidates("fluence capture");
+  fCreateCmd->SetParameter(quantityPrm);
+  const char* limits[6] = { "xmin", "xmax", "ymin", "ymax", "zmin", "zmax" };
+  for (G4int k=0; k<6; ++k) {
+    fCreateCmd->SetParameter(new G4UIparameter(limits[k],'d',false));
+  }
+  G4UIparameter* voxelPrm = new G4UIparameter("voxel",'d',false);
+  voxelPrm->SetParameterRange("voxel>0.");
+  fCreateCmd->SetParameter(voxelPrm);
+  G4UIparameter* unitPrm = new G4UIparameter("unit",'s',false);
+  fCreateCmd->SetParameter(unitPrm);
+  G4UIparameter* volumePrm = new G4UIparameter("volume",'s',true);
+  volumePrm->SetDefaultValue("all");
+  fCreateCmd->SetParameter(volumePrm);
+  fCreateCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fCreateCmd->SetToBeBroadcasted(false);
+  
+  fClearCmd = new G4UIcmdWithoutParameter("/testhadr/mesh/clear",this);
+  fClearCmd->SetGuidance("remove all the meshes");
+  fClearCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fClearCmd->SetToBeBroadcasted(false);
+  
+  fFileCmd = new G4UIcmdWithAString("/testhadr/mesh/file",this);
+  fFileCmd->SetGuidance("stem of the mesh files, <file>_mesh_<name>.h04v");
+  fFileCmd->SetParameterName("file",false);
+  fFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fFileCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MeshTallyMessenger::~MeshTallyMessenger()
+{
+  delete fCreateCmd;
+  delete fClearCmd;
+  delete fFileCmd;
+  delete fMeshDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MeshTallyMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{   
+  if (command == fCreateCmd)
+   { G4String name, quantity, unit, volume;
+     G4double limits[6], voxel;
+     std::istringstream is(newValue);
+     is >> name >> quantity;
+     for (G4int k=0; k<6; ++k) is >> limits[k];
+     is >> voxel >> unit >> volume;
+     G4double u = G4UIcommand::ValueOf(unit);
+     G4ThreeVector lower(limits[0]*u, limits[2]*u, limits[4]*u);
+     G4ThreeVector upper(limits[1]*u, limits[3]*u, limits[5]*u);
+     G4int type = (quantity == "capture") ? MeshTally::kCapture 
+                                          : MeshTally::kFluence;
+     fTally->Create(name, type, lower, upper, voxel*u, volume);
+   }
+   
+  if (command == fClearCmd)
+   {fTally->Clear();}
+   
+  if (command == fFileCmd)
+   {fTally->SetFileName(newValue);}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
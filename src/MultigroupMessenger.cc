@@ -0,0 +1,144 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file MultigroupMessenger.cc
+/// \brief Implementation of the MultigroupMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "MultigroupMessenger.hh"
+
+#include "MultigroupXSLibrary.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+#include <sstream>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MultigroupMessenger::MultigroupMessenger()
+:G4UImessenger(),
+ fMGDir(0), fLogGroupsCmd(0), fBoundariesCmd(0), fPointsCmd(0),
+ fThermalCmd(0)
+{ 
+  fMGDir = new G4UIdirectory("/testhadr/phys/mg/");
+  fMGDir->SetGuidance("multigroup neutron transport");
+  
+  fLogGroupsCmd = new G4UIcommand("/testhadr/phys/mg/logGroups",this);
+  fLogGroupsCmd->SetGuidance("groups equally spaced in lethargy");
+  G4UIparameter* nbPrm = new G4UIparameter("nbGroups",'i',false);
+  nbPrm->SetParameterRange("nbGroups>0");
+  fLogGroupsCmd->SetParameter(nbPrm);
+  G4UIparameter* minPrm = new G4UIparameter("emin",'d',false);
+  minPrm->SetParameterRange("emin>0.");
+  fLogGroupsCmd->SetParameter(minPrm);
+  G4UIparameter* maxPrm = new G4UIparameter("emax",'d',false);
+  maxPrm->SetParameterRange("emax>0.");
+  fLogGroupsCmd->SetParameter(maxPrm);
+  G4UIparameter* unitPrm = new G4UIparameter("unit",'s',true);
+  unitPrm->SetDefaultUnit("MeV");
+  fLogGroupsCmd->SetParameter(unitPrm);
+  fLogGroupsCmd->AvailableForStates(G4State_PreInit);
+  fLogGroupsCmd->SetToBeBroadcasted(false);
+  
+  fBoundariesCmd = new G4UIcommand("/testhadr/phys/mg/boundaries",this);
+  fBoundariesCmd->SetGuidance("explicit group boundaries followed by a unit,");
+  fBoundariesCmd->SetGuidance("  e.g. 1.e-11 4.e-7 1.e-4 0.1 1. 20. MeV");
+  G4UIparameter* listPrm = new G4UIparameter("list",'s',false);
+  fBoundariesCmd->SetParameter(listPrm);
+  fBoundariesCmd->AvailableForStates(G4State_PreInit);
+  fBoundariesCmd->SetToBeBroadcasted(false);
+  
+  fPointsCmd = new G4UIcmdWithAnInteger("/testhadr/phys/mg/pointsPerGroup",this);
+  fPointsCmd->SetGuidance("fine points per group for the collapsing");
+  fPointsCmd->SetParameterName("n",false);
+  fPointsCmd->SetRange("n>0");
+  fPointsCmd->AvailableForStates(G4State_PreInit);
+  fPointsCmd->SetToBeBroadcasted(false);
+  
+  fThermalCmd = new G4UIcmdWithADoubleAndUnit("/testhadr/phys/mg/thermalCutoff",this);
+  fThermalCmd->SetGuidance("free gas scattering, with upscattering, below");
+  fThermalCmd->SetParameterName("energy",false);
+  fThermalCmd->SetRange("energy>=0.");
+  fThermalCmd->SetUnitCategory("Energy");
+  fThermalCmd->AvailableForStates(G4State_PreInit);
+  fThermalCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MultigroupMessenger::~MultigroupMessenger()
+{
+  delete fLogGroupsCmd;
+  delete fBoundariesCmd;
+  delete fPointsCmd;
+  delete fThermalCmd;
+  delete fMGDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MultigroupMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{   
+  MultigroupXSLibrary* library = MultigroupXSLibrary::Instance();
+  
+  if (command == fLogGroupsCmd)
+   { G4int nbGroups; G4double emin, emax; G4String unit;
+     std::istringstream is(newValue);
+     is >> nbGroups >> emin >> emax >> unit;
+     G4double u = G4UIcommand::ValueOf(unit);
+     library->SetLogGroups(nbGroups, emin*u, emax*u);
+   }
+   
+  if (command == fBoundariesCmd)
+   { // the last token is the unit
+     std::vector<G4String> tokens;
+     std::istringstream is(newValue);
+     G4String token;
+     while (is >> token) tokens.push_back(token);
+     if (tokens.size() < 3) return;
+     G4double u = G4UIcommand::ValueOf(tokens.back());
+     std::vector<G4double> bounds;
+     for (size_t i=0; i<tokens.size()-1; ++i) {
+       bounds.push_back(G4UIcommand::ConvertToDouble(tokens[i])*u);
+     }
+     library->SetGroupBoundaries(bounds);
+   }
+   
+  if (command == fPointsCmd)
+   {library->SetPointsPerGroup(fPointsCmd->GetNewIntValue(newValue));}
+   
+  if (command == fThermalCmd)
+   {library->SetThermalCutoff(fThermalCmd->GetNewDoubleValue(newValue));}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
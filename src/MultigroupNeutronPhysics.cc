@@ -0,0 +1,89 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file MultigroupNeutronPhysics.cc
+/// \brief Implementation of the MultigroupNeutronPhysics class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "MultigroupNeutronPhysics.hh"
+
+#include "MultigroupMessenger.hh"
+#include "MultigroupNeutronProcess.hh"
+
+#include "G4Neutron.hh"
+#include "G4ProcessManager.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MultigroupNeutronPhysics::MultigroupNeutronPhysics(const G4String& name)
+:  G4VPhysicsConstructor(name), fMultigroupMessenger(0)
+{
+  fMultigroupMessenger = new MultigroupMessenger();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MultigroupNeutronPhysics::~MultigroupNeutronPhysics()
+{
+  delete fMultigroupMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MultigroupNeutronPhysics::ConstructProcess()
+{
+  G4ParticleDefinition* neutron = G4Neutron::Neutron();
+  G4ProcessManager* pManager = neutron->GetProcessManager();
+   
+  // delete all neutron processes if already registered
+  //
+  G4VProcess* process = 0;
+  process = pManager->GetProcess("hadElastic");
+  if (process) pManager->RemoveProcess(process);
+  //
+  process = pManager->GetProcess("neutronInelastic");
+  if (process) pManager->RemoveProcess(process);
+  //
+  process = pManager->GetProcess("nCapture");      
+  if (process) pManager->RemoveProcess(process);
+  //
+  process = pManager->GetProcess("nFission");      
+  if (process) pManager->RemoveProcess(process);      
+
+  // multigroup processes; the absorption keeps the name of the capture
+  // process, which is scored in SteppingAction
+  //
+  pManager->AddDiscreteProcess(
+    new MultigroupNeutronProcess(MultigroupNeutronProcess::kScatter,
+                                 "mgScatter"));
+  pManager->AddDiscreteProcess(
+    new MultigroupNeutronProcess(MultigroupNeutronProcess::kAbsorption,
+                                 "nCapture"));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
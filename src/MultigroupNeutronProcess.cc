@@ -0,0 +1,125 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file MultigroupNeutronProcess.cc
+/// \brief Implementation of the MultigroupNeutronProcess class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "MultigroupNeutronProcess.hh"
+#include "MultigroupXSLibrary.hh"
+
+#include "G4Neutron.hh"
+#include "G4Track.hh"
+#include "G4HadronicProcessType.hh"
+#include "G4RandomDirection.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MultigroupNeutronProcess::MultigroupNeutronProcess(Kind kind,
+                                                   const G4String& name)
+: G4VDiscreteProcess(name, fHadronic), fKind(kind), fLibrary(0)
+{
+  SetProcessSubType(kind == kScatter ? fHadronElastic : fCapture);
+  fLibrary = MultigroupXSLibrary::Instance();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MultigroupNeutronProcess::~MultigroupNeutronProcess()
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool MultigroupNeutronProcess::IsApplicable(const G4ParticleDefinition& part)
+{
+  return (&part == G4Neutron::Neutron());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MultigroupNeutronProcess::BuildPhysicsTable(const G4ParticleDefinition&)
+{
+  // the first caller collapses the data, the others find it ready
+  fLibrary->Generate();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double MultigroupNeutronProcess::GetMeanFreePath(const G4Track& track,
+                                                   G4double,
+                                                   G4ForceCondition* condition)
+{
+  *condition = NotForced;
+  const MultigroupXSLibrary::MaterialData* data
+    = fLibrary->GetData(track.GetMaterial());
+  if (!data) return DBL_MAX;
+
+  G4int g = fLibrary->FindGroup(track.GetKineticEnergy());
+  G4double xs = (fKind == kScatter) ? data->fScatter[g] : data->fAbsorption[g];
+  return (xs > 0.) ? 1./xs : DBL_MAX;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VParticleChange* MultigroupNeutronProcess::PostStepDoIt(const G4Track& track,
+                                                          const G4Step&)
+{
+  aParticleChange.Initialize(track);
+
+  if (fKind == kAbsorption) {
+    aParticleChange.ProposeEnergy(0.);
+    aParticleChange.ProposeTrackStatus(fStopAndKill);
+    return &aParticleChange;
+  }
+
+  const MultigroupXSLibrary::MaterialData* data
+    = fLibrary->GetData(track.GetMaterial());
+  const G4int nbGroups = fLibrary->GetNbGroups();
+  G4int g = fLibrary->FindGroup(track.GetKineticEnergy());
+
+  // outgoing group from the cumulative row of the transfer matrix, 
+  // upscattering included
+  const G4double* row = &data->fTransferCDF[g*nbGroups];
+  G4int h = (G4int)(std::lower_bound(row, row+nbGroups, G4UniformRand()) - row);
+  if (h > nbGroups-1) h = nbGroups-1;
+
+  G4double elow = fLibrary->GetLowerEdge(h);
+  G4double ehigh = fLibrary->GetUpperEdge(h);
+  G4double energy = elow*std::exp(G4UniformRand()*std::log(ehigh/elow));
+
+  aParticleChange.ProposeEnergy(energy);
+  aParticleChange.ProposeMomentumDirection(G4RandomDirection());
+  return &aParticleChange;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,349 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file MultigroupXSLibrary.cc
+/// \brief Implementation of the MultigroupXSLibrary class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "MultigroupXSLibrary.hh"
+
+#include "NeutronXSTable.hh"
+#include "NeutronXSTableBuilder.hh"
+
+#include "G4Element.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4AutoLock.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iomanip>
+
+namespace {
+  G4Mutex libraryMutex = G4MUTEX_INITIALIZER;
+  
+  // below, inelastic channels open at thermal energies emit no neutron
+  const G4double kChargedParticleLimit = 10.*keV;
+  
+  // exp(x^2) erfc(x), x >= 0
+  G4double Erfcx(G4double x)
+  {
+    if (x < 20.) return std::exp(x*x)*std::erfc(x);
+    G4double x2 = 1./(x*x);
+    return (1. - 0.5*x2*(1. - 1.5*x2*(1. - 2.5*x2)))/(x*std::sqrt(pi));
+  }
+  
+  // free gas kernel, per unit of e', for a unit free atom cross section;
+  // energies in units of kT, A the mass ratio of the target
+  G4double FreeGasKernel(G4double e, G4double ep, G4double A)
+  {
+    G4double eta = (A + 1.)/(2.*std::sqrt(A)), rho = (A - 1.)/(2.*std::sqrt(A));
+    G4double se = std::sqrt(e), sp = std::sqrt(ep);
+    G4double value;
+    if (ep < e) {
+      // exp(e-ep) (erf(a) - erf(b)) as erfc, 0 <= a <= b, without overflow
+      G4double a = eta*se - rho*sp, b = eta*se + rho*sp;
+      value = std::erf(eta*sp - rho*se) + std::erf(eta*sp + rho*se)
+            + std::exp(e - ep - b*b)*Erfcx(b) - std::exp(e - ep - a*a)*Erfcx(a);
+    }
+    else {
+      value = std::erf(eta*sp - rho*se) - std::erf(eta*sp + rho*se)
+            + std::exp(e - ep)*(std::erf(eta*se - rho*sp) + std::erf(eta*se + rho*sp));
+    }
+    return std::max(0., eta*eta/(2.*e)*value);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MultigroupXSLibrary* MultigroupXSLibrary::Instance()
+{
+  static MultigroupXSLibrary instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MultigroupXSLibrary::MultigroupXSLibrary()
+: fPointsPerGroup(32), fThermalCutoff(4.*eV), fGenerated(false)
+{
+  SetLogGroups(40, 1.e-5*eV, 20*MeV);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MultigroupXSLibrary::~MultigroupXSLibrary()
+{
+  for (size_t i=0; i<fData.size(); ++i) delete fData[i];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MultigroupXSLibrary::SetGroupBoundaries(const std::vector<G4double>& bounds)
+{
+  if (bounds.size() < 2) return;
+  fBoundaries = bounds;
+  std::sort(fBoundaries.begin(), fBoundaries.end());
+  fBoundaries.erase(std::unique(fBoundaries.begin(), fBoundaries.end()),
+                    fBoundaries.end());
+  fGenerated = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MultigroupXSLibrary::SetLogGroups(G4int nbGroups, G4double emin,
+                                       G4double emax)
+{
+  if (nbGroups < 1 || emin <= 0. || emax <= emin) return;
+  std::vector<G4double> bounds(nbGroups+1);
+  G4double dlog = std::log(emax/emin)/nbGroups;
+  for (G4int g=0; g<=nbGroups; ++g) bounds[g] = emin*std::exp(g*dlog);
+  bounds[nbGroups] = emax;
+  SetGroupBoundaries(bounds);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int MultigroupXSLibrary::FindGroup(G4double energy) const
+{
+  G4int g = (G4int)(std::upper_bound(fBoundaries.begin(), fBoundaries.end(),
+                                     energy) - fBoundaries.begin()) - 1;
+  if (g < 0) g = 0;
+  if (g > GetNbGroups()-1) g = GetNbGroups()-1;
+  return g;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MultigroupXSLibrary::Generate()
+{
+  G4AutoLock lock(&libraryMutex);
+  const G4MaterialTable* materials = G4Material::GetMaterialTable();
+  if (fGenerated && fData.size() == materials->size()) return;
+
+  for (size_t i=0; i<fData.size(); ++i) delete fData[i];
+  fData.assign(materials->size(), 0);
+
+  // only the materials placed in the geometry
+  std::vector<G4bool> used(materials->size(), false);
+  G4LogicalVolumeStore* volumes = G4LogicalVolumeStore::GetInstance();
+  for (size_t i=0; i<volumes->size(); ++i) {
+    G4Material* material = (*volumes)[i]->GetMaterial();
+    if (material) used[material->GetIndex()] = true;
+  }
+
+  NeutronXSTableBuilder builder;
+  for (size_t i=0; i<materials->size(); ++i) {
+    if (!used[i]) continue;
+    fData[i] = Collapse((*materials)[i], &builder);
+  }
+  fGenerated = true;
+  Print();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MultigroupXSLibrary::MaterialData*
+MultigroupXSLibrary::Collapse(const G4Material* material,
+                              NeutronXSTableBuilder* builder)
+{
+  const G4int nbGroups = GetNbGroups();
+  const G4int nbElements = material->GetNumberOfElements();
+  const G4double* nbAtoms = material->GetVecNbOfAtomsPerVolume();
+  const G4double temperature = material->GetTemperature();
+
+  MaterialData* data = new MaterialData();
+  data->fTotal.assign(nbGroups, 0.);
+  data->fAbsorption.assign(nbGroups, 0.);
+  data->fScatter.assign(nbGroups, 0.);
+  std::vector<G4double> transfer(nbGroups*nbGroups, 0.);
+  std::vector<G4double> correction(nbGroups, 0.);
+  std::vector<G4double> fractions;
+  const G4double kT = k_Boltzmann*temperature;
+  
+  // mass ratios, and |Q| of inelastic scattering from its threshold
+  std::vector<G4double> massRatio(nbElements), qValue(nbElements);
+  for (G4int j=0; j<nbElements; ++j) {
+    const G4Element* element = material->GetElement(j);
+    massRatio[j] = element->GetN()*amu_c2/neutron_mass_c2;
+    G4double threshold = builder->GetThreshold(NeutronXSTable::kInelastic, element);
+    qValue[j] = (threshold < DBL_MAX) ? 
+                threshold*massRatio[j]/(massRatio[j] + 1.) : 0.;
+  }
+
+  // fine points uniform in lethargy: with a 1/E spectrum all the points
+  // of a group carry the same weight
+  const G4double weight = 1./fPointsPerGroup;
+  for (G4int g=0; g<nbGroups; ++g) {
+    G4double du = std::log(fBoundaries[g+1]/fBoundaries[g])/fPointsPerGroup;
+    for (G4int k=0; k<fPointsPerGroup; ++k) {
+      G4double energy = fBoundaries[g]*std::exp((k+0.5)*du);
+      for (G4int j=0; j<nbElements; ++j) {
+        const G4Element* element = material->GetElement(j);
+        G4double n = nbAtoms[j]*weight;
+        G4double elastic = n*builder->GetCrossSection(NeutronXSTable::kElastic,
+                                         element, energy, temperature);
+        G4double inelastic = n*builder->GetCrossSection(NeutronXSTable::kInelastic,
+                                         element, energy, temperature);
+        G4double absorption = n*(
+          builder->GetCrossSection(NeutronXSTable::kCapture,
+                                   element, energy, temperature)
+        + builder->GetCrossSection(NeutronXSTable::kFission,
+                                   element, energy, temperature));
+        data->fAbsorption[g] += absorption;
+
+        // elastic: outgoing energy uniform in [alpha E, E]; the lowest
+        // group keeps what falls below its edge. Thermal: free gas
+        G4double A = massRatio[j];
+        if (energy < fThermalCutoff && kT > 0.) {
+          FreeGasTransfer(energy, A, kT, fractions);
+          for (G4int h=0; h<nbGroups; ++h) {
+            transfer[g*nbGroups+h] += elastic*fractions[h];
+          }
+        }
+        else {
+          G4double alpha = (A-1.)*(A-1.)/((A+1.)*(A+1.));
+          G4double elow = alpha*energy;
+          for (G4int h=g; h>=0 && fBoundaries[h+1]>elow; --h) {
+            G4double lo = (h == 0) ? elow : std::max(fBoundaries[h], elow);
+            G4double hi = std::min(fBoundaries[h+1], energy);
+            if (hi > lo) transfer[g*nbGroups+h] += elastic*(hi-lo)/(energy-elow);
+          }
+        }
+        correction[g] += elastic*2./(3.*A);
+
+        // inelastic: one neutron, uniform in [0, E - |Q|]
+        G4double outMax = energy - qValue[j];
+        if (outMax <= 0. || 
+            (qValue[j] == 0. && energy < kChargedParticleLimit)) {
+          data->fAbsorption[g] += inelastic;
+          continue;
+        }
+        for (G4int h=g; h>=0; --h) {
+          G4double hi = std::min(fBoundaries[h+1], outMax);
+          G4double lo = (h == 0) ? 0. : fBoundaries[h];
+          if (hi > lo) transfer[g*nbGroups+h] += inelastic*(hi-lo)/outMax;
+        }
+      }
+    }
+  }
+
+  // transport correction of the in-group term, then row cumulatives
+  data->fTransferCDF.assign(nbGroups*nbGroups, 0.);
+  for (G4int g=0; g<nbGroups; ++g) {
+    G4double& diagonal = transfer[g*nbGroups+g];
+    diagonal = std::max(0., diagonal - correction[g]);
+    G4double sum = 0.;
+    for (G4int h=0; h<nbGroups; ++h) {
+      sum += transfer[g*nbGroups+h];
+      data->fTransferCDF[g*nbGroups+h] = sum;
+    }
+    if (sum > 0.) {
+      for (G4int h=0; h<nbGroups; ++h) data->fTransferCDF[g*nbGroups+h] /= sum;
+    }
+    data->fScatter[g] = sum;
+    data->fTotal[g] = sum + data->fAbsorption[g];
+  }
+  return data;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MultigroupXSLibrary::FreeGasTransfer(G4double energy, G4double massRatio,
+                                          G4double kT,
+                                          std::vector<G4double>& fractions) const
+{
+  // Simpson over each group, split at the kinks of the kernel, alpha E 
+  // and E; upscattering beyond E + 50 kT is neglected
+  const G4int nbGroups = GetNbGroups();
+  const G4int nbSteps = 64;
+  fractions.assign(nbGroups, 0.);
+  G4double e = energy/kT;
+  G4double alpha = (massRatio-1.)*(massRatio-1.)/((massRatio+1.)*(massRatio+1.));
+  G4double top = e + 50.;
+  G4double total = 0.;
+  for (G4int h=0; h<nbGroups; ++h) {
+    G4double lo = (h == 0) ? 0. : fBoundaries[h]/kT;
+    G4double hi = std::min(fBoundaries[h+1]/kT, top);
+    if (lo >= hi) break;
+    G4double cuts[4] = { lo, alpha*e, e, hi };
+    std::sort(cuts, cuts + 4);
+    G4double sum = 0.;
+    for (G4int k=0; k<3; ++k) {
+      G4double a = std::max(cuts[k], lo), b = std::min(cuts[k+1], hi);
+      if (!(b > a)) continue;
+      G4double step = (b - a)/nbSteps;
+      G4double piece = FreeGasKernel(e, a, massRatio) 
+                     + FreeGasKernel(e, b, massRatio);
+      for (G4int i=1; i<nbSteps; ++i) {
+        piece += ((i % 2) ? 4. : 2.)*FreeGasKernel(e, a + i*step, massRatio);
+      }
+      sum += piece*step/3.;
+    }
+    fractions[h] = sum;
+    total += sum;
+  }
+  if (total > 0.) {
+    for (G4int h=0; h<nbGroups; ++h) fractions[h] /= total;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MultigroupXSLibrary::Print() const
+{
+  const G4MaterialTable* materials = G4Material::GetMaterialTable();
+  G4cout << "\n MultigroupXSLibrary: " << GetNbGroups() << " groups from "
+         << G4BestUnit(fBoundaries.front(), "Energy") << " to "
+         << G4BestUnit(fBoundaries.back(), "Energy") << G4endl;
+  for (size_t i=0; i<fData.size(); ++i) {
+    if (!fData[i]) continue;
+    const MaterialData* data = fData[i];
+    G4int g = FindGroup(2.*MeV);
+    G4double upscatter = 
+      (data->fScatter[0] > 0.) ? 1. - data->fTransferCDF[0] : 0.;
+    G4cout << "  " << std::setw(20) << (*materials)[i]->GetName()
+           << "  sigma_t(2 MeV) = " << data->fTotal[g]*cm << " /cm"
+           << "  sigma_a(thermal) = " << data->fAbsorption[0]*cm << " /cm"
+           << "  upscatter(thermal) = " << upscatter << G4endl;
+    
+    // free gas below the cutoff: the lowest group must scatter upward
+    if (fBoundaries[1] < fThermalCutoff && data->fScatter[0] > 0. &&
+        (*materials)[i]->GetTemperature() > 0. && !(upscatter > 0.)) {
+      G4cout << "### MultigroupXSLibrary: no upscattering from the lowest "
+             << "group in " << (*materials)[i]->GetName() << G4endl;
+    }
+  }
+  G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -36,12 +36,21 @@
 
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 NeutronHPMessenger::NeutronHPMessenger(NeutronHPphysics* phys)
 :G4UImessenger(),fNeutronPhysics(phys),
- fPhysDir(0), fThermalCmd(0)
+ fPhysDir(0), fThermalCmd(0), fThermalRegionCmd(0),
+ fArgonCascadeCmd(0), fArgonCascadeFileCmd(0),
+ fXSDir(0), fXSUseCmd(0), fXSDirectoryCmd(0), fXSToleranceCmd(0), fXSBuildCmd(0)
 { 
   fPhysDir = new G4UIdirectory("/testhadr/phys/");
   fPhysDir->SetGuidance("physics list commands");
@@ -50,6 +59,54 @@ NeutronHPMessenger::NeutronHPMessenger(NeutronHPphysics* phys)
   fThermalCmd->SetGuidance("set thermal scattering model");
   fThermalCmd->SetParameterName("thermal",false);
   fThermalCmd->AvailableForStates(G4State_PreInit);  
+  
+  fThermalRegionCmd = new G4UIcmdWithAString("/testhadr/phys/thermalRegion",this);
+  fThermalRegionCmd->SetGuidance("region where thermal scattering is applied;");
+  fThermalRegionCmd->SetGuidance("  free gas elsewhere. 'all' = every material");
+  fThermalRegionCmd->SetParameterName("region",false);
+  fThermalRegionCmd->AvailableForStates(G4State_PreInit);  
+  
+  fArgonCascadeCmd = new G4UIcmdWithABool("/testhadr/phys/argonCascade",this);
+  fArgonCascadeCmd->SetGuidance("Ar-40 capture gammas from the cascade library");
+  fArgonCascadeCmd->SetParameterName("cascade",false);
+  fArgonCascadeCmd->AvailableForStates(G4State_PreInit);  
+  
+  fArgonCascadeFileCmd = new G4UIcmdWithAString("/testhadr/phys/argonCascadeFile",this);
+  fArgonCascadeFileCmd->SetGuidance("level-scheme file of the Ar-41 cascades");
+  fArgonCascadeFileCmd->SetParameterName("file",false);
+  fArgonCascadeFileCmd->AvailableForStates(G4State_PreInit);  
+  
+  fXSDir = new G4UIdirectory("/testhadr/phys/xsTables/");
+  fXSDir->SetGuidance("pre-broadened cross section tables");
+  
+  fXSUseCmd = new G4UIcmdWithABool("/testhadr/phys/xsTables/use",this);
+  fXSUseCmd->SetGuidance("use the tabulated cross sections when available");
+  fXSUseCmd->SetParameterName("use",false);
+  fXSUseCmd->AvailableForStates(G4State_PreInit);
+  
+  fXSDirectoryCmd = new G4UIcmdWithAString("/testhadr/phys/xsTables/directory",this);
+  fXSDirectoryCmd->SetGuidance("directory of the cross section tables");
+  fXSDirectoryCmd->SetParameterName("dir",false);
+  fXSDirectoryCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  
+  fXSToleranceCmd = new G4UIcmdWithADouble("/testhadr/phys/xsTables/tolerance",this);
+  fXSToleranceCmd->SetGuidance("relative tolerance of the grid reconstruction");
+  fXSToleranceCmd->SetParameterName("tol",false);
+  fXSToleranceCmd->SetRange("tol>0.");
+  fXSToleranceCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  
+  fXSBuildCmd = new G4UIcommand("/testhadr/phys/xsTables/build",this);
+  fXSBuildCmd->SetGuidance("tabulate the broadened ParticleHP cross sections");
+  fXSBuildCmd->SetGuidance("  of a material (after /run/initialize).");
+  fXSBuildCmd->SetGuidance("  temperature in kelvin, 0 = material temperature");
+  G4UIparameter* matPrm = new G4UIparameter("material",'s',false);
+  fXSBuildCmd->SetParameter(matPrm);
+  G4UIparameter* tempPrm = new G4UIparameter("temperature",'d',true);
+  tempPrm->SetDefaultValue(0.);
+  tempPrm->SetParameterRange("temperature>=0.");
+  fXSBuildCmd->SetParameter(tempPrm);
+  fXSBuildCmd->AvailableForStates(G4State_Idle);
+  fXSBuildCmd->SetToBeBroadcasted(false);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -57,6 +114,14 @@ NeutronHPMessenger::NeutronHPMessenger(NeutronHPphysics* phys)
 NeutronHPMessenger::~NeutronHPMessenger()
 {
   delete fThermalCmd;
+  delete fThermalRegionCmd;
+  delete fArgonCascadeCmd;
+  delete fArgonCascadeFileCmd;
+  delete fXSUseCmd;
+  delete fXSDirectoryCmd;
+  delete fXSToleranceCmd;
+  delete fXSBuildCmd;
+  delete fXSDir;
   delete fPhysDir;
 }
 
@@ -66,6 +131,32 @@ void NeutronHPMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
 {   
   if (command == fThermalCmd)
    {fNeutronPhysics->SetThermalPhysics(fThermalCmd->GetNewBoolValue(newValue));}
+   
+  if (command == fThermalRegionCmd)
+   {fNeutronPhysics->SetThermalRegion(newValue);}
+   
+  if (command == fArgonCascadeCmd)
+   {fNeutronPhysics->SetArgonCascade(fArgonCascadeCmd->GetNewBoolValue(newValue));}
+   
+  if (command == fArgonCascadeFileCmd)
+   {fNeutronPhysics->SetArgonCascadeFile(newValue);}
+   
+  if (command == fXSUseCmd)
+   {fNeutronPhysics->SetUseXSTables(fXSUseCmd->GetNewBoolValue(newValue));}
+   
+  if (command == fXSDirectoryCmd)
+   {fNeutronPhysics->SetXSTableDirectory(newValue);}
+   
+  if (command == fXSToleranceCmd)
+   {fNeutronPhysics->SetXSTableTolerance(fXSToleranceCmd->GetNewDoubleValue(newValue));}
+   
+  if (command == fXSBuildCmd)
+   { G4String material;
+     G4double temperature = 0.;
+     std::istringstream is(newValue);
+     is >> material >> temperature;
+     fNeutronPhysics->BuildXSTable(material, temperature*kelvin);
+   }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -33,6 +33,14 @@
 #include "NeutronHPphysics.hh"
 
 #include "NeutronHPMessenger.hh"
+#include "NeutronXSTable.hh"
+#include "NeutronXSTableData.hh"
+#include "NeutronXSTableStore.hh"
+#include "NeutronXSTableBuilder.hh"
+#include "NeutronMacroXS.hh"
+#include "NeutronTabulatedProcess.hh"
+#include "RegionThermalScatteringData.hh"
+#include "ArgonCaptureModel.hh"
 
 #include "G4ParticleDefinition.hh"
 #include "G4ProcessManager.hh"
@@ -58,12 +66,18 @@
 #include "G4ParticleHPFissionData.hh"
 #include "G4ParticleHPFission.hh"
 
+#include "G4Material.hh"
 #include "G4SystemOfUnits.hh"
 
+#include <sys/stat.h>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 NeutronHPphysics::NeutronHPphysics(const G4String& name)
-:  G4VPhysicsConstructor(name), fThermal(true), fNeutronMessenger(0)
+:  G4VPhysicsConstructor(name), fThermal(true), fThermalRegion("ShieldRegion"),
+   fUseXSTables(false),
+   fXSTolerance(1.e-3), fArgonCascade(true), fArgonCascadeFile("argon41.cascade"),
+   fNeutronMessenger(0)
 {
   fNeutronMessenger = new NeutronHPMessenger(this);
 }
@@ -97,32 +111,53 @@ void NeutronHPphysics::ConstructProcess()
   process = pManager->GetProcess("nFission");      
   if (process) pManager->RemoveProcess(process);      
          
+  // with tables, the mean free paths come from the unionized-grid
+  // macroscopic cross sections (see NeutronTabulatedProcess)
+  G4double thermalLimit = fThermal ? 4*eV : 0.;
+  
   // (re) create process: elastic
   //
-  G4HadronElasticProcess* process1 = new G4HadronElasticProcess();
+  G4HadronElasticProcess* process1 = 0;
+  if (fUseXSTables)
+    process1 = new NeutronTabulatedProcess<G4HadronElasticProcess>
+                     (NeutronMacroXS::kElastic, thermalLimit);
+  else process1 = new G4HadronElasticProcess();
   pManager->AddDiscreteProcess(process1);
   //
   // model1a
   G4ParticleHPElastic*  model1a = new G4ParticleHPElastic();
   process1->RegisterMe(model1a);
   process1->AddDataSet(new G4ParticleHPElasticData());
+  if (fUseXSTables)
+    process1->AddDataSet(new NeutronXSTableData(NeutronXSTable::kElastic));
   //
-  // model1b
+  // model1b: in all materials, or restricted to the materials of a region
+  // (free gas elsewhere)
   if (fThermal) {
     model1a->SetMinEnergy(4*eV);   
    G4ParticleHPThermalScattering* model1b = new G4ParticleHPThermalScattering();
     process1->RegisterMe(model1b);
-    process1->AddDataSet(new G4ParticleHPThermalScatteringData());
+    if (fThermalRegion == "all")
+      process1->AddDataSet(new G4ParticleHPThermalScatteringData());
+    else
+      process1->AddDataSet(
+        new RegionThermalScatteringData(fThermalRegion, model1a, model1b));
   }
    
   // (re) create process: inelastic
   //
-  G4NeutronInelasticProcess* process2 = new G4NeutronInelasticProcess();
+  G4NeutronInelasticProcess* process2 = 0;
+  if (fUseXSTables)
+    process2 = new NeutronTabulatedProcess<G4NeutronInelasticProcess>
+                     (NeutronMacroXS::kInelastic);
+  else process2 = new G4NeutronInelasticProcess();
   pManager->AddDiscreteProcess(process2);   
   //
   // cross section data set
   G4ParticleHPInelasticData* dataSet2 = new G4ParticleHPInelasticData();
   process2->AddDataSet(dataSet2);                               
+  if (fUseXSTables)
+    process2->AddDataSet(new NeutronXSTableData(NeutronXSTable::kInelastic));
   //
   // models
   G4ParticleHPInelastic* model2 = new G4ParticleHPInelastic();
@@ -130,25 +165,42 @@ void NeutronHPphysics::ConstructProcess()
 
   // (re) create process: nCapture   
   //
-  G4HadronCaptureProcess* process3 = new G4HadronCaptureProcess();
+  G4HadronCaptureProcess* process3 = 0;
+  if (fUseXSTables)
+    process3 = new NeutronTabulatedProcess<G4HadronCaptureProcess>
+                     (NeutronMacroXS::kCapture);
+  else process3 = new G4HadronCaptureProcess();
   pManager->AddDiscreteProcess(process3);    
   //
   // cross section data set
   G4ParticleHPCaptureData* dataSet3 = new G4ParticleHPCaptureData();
   process3->AddDataSet(dataSet3);
-  //
-  // models
-  G4ParticleHPCapture* model3 = new G4ParticleHPCapture();
-  process3->RegisterMe(model3);
+  if (fUseXSTables)
+    process3->AddDataSet(new NeutronXSTableData(NeutronXSTable::kCapture));
+  //
+  // models: Ar-40 cascades from the level-scheme library, ParticleHP otherwise
+  if (fArgonCascade) {
+    ArgonCaptureModel* model3 = new ArgonCaptureModel(fArgonCascadeFile);
+    process3->RegisterMe(model3);
+  } else {
+    G4ParticleHPCapture* model3 = new G4ParticleHPCapture();
+    process3->RegisterMe(model3);
+  }
    
   // (re) create process: nFission   
   //
-  G4HadronFissionProcess* process4 = new G4HadronFissionProcess();
+  G4HadronFissionProcess* process4 = 0;
+  if (fUseXSTables)
+    process4 = new NeutronTabulatedProcess<G4HadronFissionProcess>
+                     (NeutronMacroXS::kFission);
+  else process4 = new G4HadronFissionProcess();
   pManager->AddDiscreteProcess(process4);
   //
   // cross section data set
   G4ParticleHPFissionData* dataSet4 = new G4ParticleHPFissionData();
   process4->AddDataSet(dataSet4);                               
+  if (fUseXSTables)
+    process4->AddDataSet(new NeutronXSTableData(NeutronXSTable::kFission));
   //
   // models
   G4ParticleHPFission* model4 = new G4ParticleHPFission();
@@ -156,3 +208,27 @@ void NeutronHPphysics::ConstructProcess()
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NeutronHPphysics::SetXSTableDirectory(const G4String& dir)
+{
+  NeutronXSTableStore::Instance()->SetDirectory(dir);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NeutronHPphysics::BuildXSTable(const G4String& name, G4double temperature)
+{
+  // preprocessing step: run in Idle state, after /run/initialize
+  G4Material* material = G4Material::GetMaterial(name);
+  if (!material) return;
+  if (temperature <= 0.) temperature = material->GetTemperature();
+  
+  const G4String& dir = NeutronXSTableStore::Instance()->GetDirectory();
+  mkdir(dir.c_str(), 0755);
+  
+  NeutronXSTableBuilder builder;
+  builder.SetTolerance(fXSTolerance);
+  builder.BuildAndWrite(material, temperature, dir);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
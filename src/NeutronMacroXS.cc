@@ -0,0 +1,135 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NeutronMacroXS.cc
+/// \brief Implementation of the NeutronMacroXS class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NeutronMacroXS.hh"
+#include "NeutronXSTable.hh"
+
+#include "G4Material.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronMacroXS::NeutronMacroXS(const NeutronXSTable* table,
+                               const G4Material* material)
+: fData(0), fBuffer(0), fLogMinEnergy(0.), fInvBucketWidth(0.),
+  fMinEnergy(table->GetMinEnergy()), fMaxEnergy(table->GetMaxEnergy()),
+  fThermalElements(false)
+{
+  size_t nbBins = table->GetNbEnergies();
+  fEnergy.resize(nbBins);
+  for (size_t i=0; i<nbBins; ++i) fEnergy[i] = table->GetEnergy(i);
+
+  // one 64-byte line per energy point
+  const size_t align = 64;
+  fBuffer = new char[nbBins*kNbLanes*sizeof(G4double) + align];
+  std::uintptr_t address = reinterpret_cast<std::uintptr_t>(fBuffer);
+  fData = reinterpret_cast<G4double*>((address + align - 1) & ~(align - 1));
+  std::fill(fData, fData + nbBins*kNbLanes, 0.);
+
+  // sum the elements once, weighted by their atom densities
+  const G4double* nbAtoms = material->GetVecNbOfAtomsPerVolume();
+  for (G4int j=0; j<table->GetNbElements(); ++j) {
+    if (material->GetElement(j)->GetName().compare(0, 3, "TS_") == 0) {
+      fThermalElements = true;
+    }
+    for (size_t i=0; i<nbBins; ++i) {
+      G4double* line = fData + i*kNbLanes;
+      for (G4int r=0; r<NeutronXSTable::kNbReactions; ++r) {
+        G4double xs = nbAtoms[j]*table->GetCrossSection(r, j, i, fEnergy[i]);
+        line[kElastic + r] += xs;
+        line[kTotal]       += xs;
+      }
+    }
+  }
+
+  // hashed index: about one grid point per log(E) bucket
+  size_t nbBuckets = std::max(nbBins, size_t(64));
+  fLogMinEnergy = std::log(fMinEnergy);
+  fInvBucketWidth = nbBuckets/(std::log(fMaxEnergy) - fLogMinEnergy);
+  fBucket.resize(nbBuckets + 1);
+  size_t bin = 0;
+  for (size_t k=0; k<=nbBuckets; ++k) {
+    G4double edge = std::exp(fLogMinEnergy + k/fInvBucketWidth);
+    while (bin + 2 < nbBins && fEnergy[bin+1] <= edge) ++bin;
+    fBucket[k] = (G4int)bin;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronMacroXS::~NeutronMacroXS()
+{
+  delete [] fBuffer;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+size_t NeutronMacroXS::FindBin(G4double energy) const
+{
+  G4double u = (std::log(energy) - fLogMinEnergy)*fInvBucketWidth;
+  size_t k = (u > 0.) ? size_t(u) : 0;
+  if (k >= fBucket.size() - 1) k = fBucket.size() - 2;
+
+  // the interval lies between the first bins of this and the next bucket
+  size_t low = fBucket[k], high = fBucket[k+1] + 1;
+  if (high > fEnergy.size() - 1) high = fEnergy.size() - 1;
+  std::vector<G4double>::const_iterator it
+    = std::upper_bound(fEnergy.begin() + low, fEnergy.begin() + high, energy);
+  size_t bin = (it - fEnergy.begin());
+  return (bin > 0) ? std::min(bin - 1, fEnergy.size() - 2) : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NeutronMacroXS::GetCrossSection(G4int lane, G4double energy) const
+{
+  size_t bin = FindBin(energy);
+  G4double f = (energy - fEnergy[bin])/(fEnergy[bin+1] - fEnergy[bin]);
+  G4double x1 = Line(bin)[lane], x2 = Line(bin+1)[lane];
+  return x1 + f*(x2 - x1);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NeutronMacroXS::GetCrossSections(G4double energy, G4double* values) const
+{
+  size_t bin = FindBin(energy);
+  G4double f = (energy - fEnergy[bin])/(fEnergy[bin+1] - fEnergy[bin]);
+  const G4double* x1 = Line(bin);
+  const G4double* x2 = Line(bin+1);
+  for (G4int l=0; l<kNbLanes; ++l) values[l] = x1[l] + f*(x2[l] - x1[l]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,181 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NeutronXSTable.cc
+/// \brief Implementation of the NeutronXSTable class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NeutronXSTable.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace {
+  const char     kMagic[4] = {'H','4','X','S'};
+  const G4int    kVersion  = 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronXSTable::NeutronXSTable(const G4String& material, G4double temperature,
+                               const std::vector<G4int>& elementZ)
+: fMaterial(material), fTemperature(temperature), fElementZ(elementZ)
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronXSTable::~NeutronXSTable()
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String NeutronXSTable::FileName(const G4String& directory,
+                                  const G4String& material,
+                                  G4double temperature)
+{
+  std::ostringstream name;
+  name << directory << "/" << material << "_"
+       << G4lrint(temperature/kelvin) << "K.xs";
+  return name.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NeutronXSTable::SetGrid(const std::vector<G4double>& energies)
+{
+  fEnergy = energies;
+  fXS.assign(kNbReactions*fElementZ.size()*fEnergy.size(), 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+size_t NeutronXSTable::FindBin(G4double energy) const
+{
+  // index of the lower edge of the interval containing energy
+  if (energy <= fEnergy.front()) return 0;
+  if (energy >= fEnergy.back())  return fEnergy.size() - 2;
+  std::vector<G4double>::const_iterator it
+    = std::upper_bound(fEnergy.begin(), fEnergy.end(), energy);
+  return (it - fEnergy.begin()) - 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NeutronXSTable::GetCrossSection(G4int reaction, G4int element,
+                                         size_t bin, G4double energy) const
+{
+  // lin-lin interpolation, as in the ENDF reconstruction of the tables
+  const G4double* xs = &fXS[Index(reaction, element, bin)];
+  G4double e1 = fEnergy[bin], e2 = fEnergy[bin+1];
+  G4double f  = (energy - e1)/(e2 - e1);
+  if (f < 0.) f = 0.;
+  if (f > 1.) f = 1.;
+  return xs[0] + f*(xs[1] - xs[0]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int NeutronXSTable::ElementIndex(G4int Z) const
+{
+  for (size_t i=0; i<fElementZ.size(); ++i) {
+    if (fElementZ[i] == Z) return (G4int)i;
+  }
+  return -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NeutronXSTable::Write(const G4String& fileName) const
+{
+  std::ofstream out(fileName, std::ios::binary);
+  if (!out) return false;
+
+  G4int nameLength = (G4int)fMaterial.size();
+  G4int nElements  = (G4int)fElementZ.size();
+  G4int nReactions = kNbReactions;
+  G4long nEnergies = (G4long)fEnergy.size();
+
+  out.write(kMagic, sizeof(kMagic));
+  out.write((const char*)&kVersion,    sizeof(G4int));
+  out.write((const char*)&nameLength,  sizeof(G4int));
+  out.write(fMaterial.data(), nameLength);
+  out.write((const char*)&fTemperature, sizeof(G4double));
+  out.write((const char*)&nElements,   sizeof(G4int));
+  out.write((const char*)fElementZ.data(), nElements*sizeof(G4int));
+  out.write((const char*)&nReactions,  sizeof(G4int));
+  out.write((const char*)&nEnergies,   sizeof(G4long));
+  out.write((const char*)fEnergy.data(), nEnergies*sizeof(G4double));
+  out.write((const char*)fXS.data(), fXS.size()*sizeof(G4double));
+  return out.good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronXSTable* NeutronXSTable::Read(const G4String& fileName)
+{
+  std::ifstream in(fileName, std::ios::binary);
+  if (!in) return 0;
+
+  char magic[4];
+  G4int version = 0, nameLength = 0, nElements = 0, nReactions = 0;
+  G4long nEnergies = 0;
+  in.read(magic, sizeof(magic));
+  in.read((char*)&version, sizeof(G4int));
+  if (!in || !std::equal(magic, magic+4, kMagic) || version != kVersion) {
+    G4cout << "### NeutronXSTable: " << fileName
+           << " is not a cross section table (version " << kVersion << ")"
+           << G4endl;
+    return 0;
+  }
+
+  in.read((char*)&nameLength, sizeof(G4int));
+  std::string material(nameLength, ' ');
+  in.read(&material[0], nameLength);
+  G4double temperature = 0.;
+  in.read((char*)&temperature, sizeof(G4double));
+  in.read((char*)&nElements, sizeof(G4int));
+  std::vector<G4int> elementZ(nElements);
+  in.read((char*)elementZ.data(), nElements*sizeof(G4int));
+  in.read((char*)&nReactions, sizeof(G4int));
+  in.read((char*)&nEnergies, sizeof(G4long));
+  if (!in || nReactions != kNbReactions || nEnergies < 2) return 0;
+
+  std::vector<G4double> energies(nEnergies);
+  in.read((char*)energies.data(), nEnergies*sizeof(G4double));
+
+  NeutronXSTable* table = new NeutronXSTable(material, temperature, elementZ);
+  table->SetGrid(energies);
+  in.read((char*)table->fXS.data(), table->fXS.size()*sizeof(G4double));
+  if (!in) { delete table; return 0; }
+  return table;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
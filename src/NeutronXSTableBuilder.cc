@@ -0,0 +1,364 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NeutronXSTableBuilder.cc
+/// \brief Implementation of the NeutronXSTableBuilder class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NeutronXSTableBuilder.hh"
+#include "NeutronXSTable.hh"
+
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4Neutron.hh"
+#include "G4DynamicParticle.hh"
+#include "G4ParticleHPElasticData.hh"
+#include "G4ParticleHPInelasticData.hh"
+#include "G4ParticleHPCaptureData.hh"
+#include "G4ParticleHPFissionData.hh"
+#include "G4ParticleHPManager.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronXSTableBuilder::NeutronXSTableBuilder()
+: fElastic(0), fInelastic(0), fCapture(0), fFission(0), fNeutron(0),
+  fTolerance(1.e-3), fMinEnergy(1.e-5*eV), fMaxEnergy(20.*MeV),
+  fPointsPerDecade(20), fMaxPoints(2000000)
+{
+  G4ParticleDefinition* neutron = G4Neutron::Neutron();
+  fNeutron = new G4DynamicParticle(neutron, G4ThreeVector(0.,0.,1.), 0.);
+
+  // ParticleHP data of every element known at this point
+  fElastic   = new G4ParticleHPElasticData();
+  fInelastic = new G4ParticleHPInelasticData();
+  fCapture   = new G4ParticleHPCaptureData();
+  fFission   = new G4ParticleHPFissionData();
+  fElastic->BuildPhysicsTable(*neutron);
+  fInelastic->BuildPhysicsTable(*neutron);
+  fCapture->BuildPhysicsTable(*neutron);
+  fFission->BuildPhysicsTable(*neutron);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronXSTableBuilder::~NeutronXSTableBuilder()
+{
+  delete fElastic;
+  delete fInelastic;
+  delete fCapture;
+  delete fFission;
+  delete fNeutron;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NeutronXSTableBuilder::Evaluate(G4int reaction,
+                                         const G4Element* element,
+                                         G4double energy)
+{
+  // point-wise data, without the Monte Carlo Doppler integral of ParticleHP;
+  // the flag of the manager is shared, restored at once (Idle state)
+  G4ParticleHPManager* manager = G4ParticleHPManager::GetInstance();
+  G4bool neglectDoppler = manager->GetNeglectDoppler();
+  manager->SetNeglectDoppler(true);
+  fNeutron->SetKineticEnergy(energy);
+  G4double value = 0.;
+  switch (reaction) {
+    case NeutronXSTable::kElastic:
+      value = fElastic->GetCrossSection(fNeutron, element, 0.);   break;
+    case NeutronXSTable::kInelastic:
+      value = fInelastic->GetCrossSection(fNeutron, element, 0.); break;
+    case NeutronXSTable::kCapture:
+      value = fCapture->GetCrossSection(fNeutron, element, 0.);   break;
+    case NeutronXSTable::kFission:
+      value = fFission->GetCrossSection(fNeutron, element, 0.);   break;
+  }
+  manager->SetNeglectDoppler(neglectDoppler);
+  return value;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const NeutronXSTableBuilder::Curve& 
+NeutronXSTableBuilder::GetCurve(G4int reaction, const G4Element* element)
+{
+  Curve& curve = fCurves[std::make_pair(reaction, element)];
+  if (!curve.fEnergy.empty()) return curve;
+
+  // coarse logarithmic grid, refined by bisection where lin-lin
+  // interpolation does not reproduce the data
+  struct Interval {
+    G4double eLow, eHigh;
+    G4double vLow, vHigh;
+  };
+
+  G4double decades = std::log10(fMaxEnergy/fMinEnergy);
+  G4int nCoarse = std::max(2, G4int(decades*fPointsPerDecade) + 1);
+  std::vector<G4double> coarse(nCoarse);
+  for (G4int i=0; i<nCoarse; ++i) {
+    coarse[i] = fMinEnergy*std::pow(fMaxEnergy/fMinEnergy, G4double(i)/(nCoarse-1));
+  }
+
+  std::vector<Interval> stack;
+  G4double vNext = Evaluate(reaction, element, coarse.back());
+  for (G4int i=nCoarse-1; i>0; --i) {
+    Interval interval;
+    interval.eLow = coarse[i-1];  interval.eHigh = coarse[i];
+    interval.vHigh = vNext;
+    interval.vLow = Evaluate(reaction, element, coarse[i-1]);
+    vNext = interval.vLow;
+    stack.push_back(interval);
+  }
+
+  const G4double floor = 1.e-6*barn;
+  while (!stack.empty()) {
+    Interval interval = stack.back();
+    stack.pop_back();
+
+    G4double eMid = 0.5*(interval.eLow + interval.eHigh);
+    G4double vMid = 0.;
+    G4bool converged = (interval.eHigh - interval.eLow) < 1.e-9*interval.eHigh
+                    || (G4int)(curve.fEnergy.size() + stack.size()) >= fMaxPoints;
+    if (!converged) {
+      vMid = Evaluate(reaction, element, eMid);
+      G4double linear = 0.5*(interval.vLow + interval.vHigh);
+      converged = std::fabs(vMid - linear) <= fTolerance*std::fabs(vMid) + floor;
+    }
+    if (converged) {
+      curve.fEnergy.push_back(interval.eLow);
+      curve.fValue.push_back(interval.vLow);
+      if (stack.empty()) {
+        curve.fEnergy.push_back(interval.eHigh);
+        curve.fValue.push_back(interval.vHigh);
+      }
+      continue;
+    }
+    Interval upper = { eMid, interval.eHigh, vMid, interval.vHigh };
+    Interval lower = { interval.eLow, eMid, interval.vLow, vMid };
+    stack.push_back(upper);
+    stack.push_back(lower);
+  }
+  return curve;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NeutronXSTableBuilder::Interpolate(const Curve& curve, 
+                                            G4double energy) const
+{
+  const std::vector<G4double>& e = curve.fEnergy;
+  if (energy <= e.front()) {
+    return curve.fValue.front()*std::sqrt(e.front()/energy);
+  }
+  if (energy >= e.back()) return curve.fValue.back();
+  size_t i = std::upper_bound(e.begin(), e.end(), energy) - e.begin() - 1;
+  G4double f = (energy - e[i])/(e[i+1] - e[i]);
+  return (1. - f)*curve.fValue[i] + f*curve.fValue[i+1];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  // beyond this distance in reduced speed, the kernel is neglected
+  const G4double kWindow = 6.;
+  
+  // integrals of z^n exp(-z^2) from z1 to z2, n = 0..4
+  void Moments(G4double z1, G4double z2, G4double f[5])
+  {
+    const G4double halfSqrtPi = 0.5*std::sqrt(pi);
+    if (z1 >= 0.)      f[0] = halfSqrtPi*(std::erfc(z1) - std::erfc(z2));
+    else if (z2 <= 0.) f[0] = halfSqrtPi*(std::erfc(-z2) - std::erfc(-z1));
+    else               f[0] = halfSqrtPi*(std::erf(z2) - std::erf(z1));
+    G4double e1 = std::exp(-z1*z1), e2 = std::exp(-z2*z2);
+    f[1] = 0.5*(e1 - e2);
+    G4double p1 = z1, p2 = z2;
+    for (G4int n=2; n<5; ++n) {
+      f[n] = 0.5*(n-1)*f[n-2] + 0.5*(p1*e1 - p2*e2);
+      p1 *= z1;
+      p2 *= z2;
+    }
+  }
+  
+  // integral over [z1,z2] of p(z + c) exp(-z^2), p of degree 4
+  G4double Integral(const G4double p[5], G4double c, G4double z1, G4double z2)
+  {
+    static const G4double binomial[5][5] = 
+      { {1,0,0,0,0}, {1,1,0,0,0}, {1,2,1,0,0}, {1,3,3,1,0}, {1,4,6,4,1} };
+    G4double f[5];
+    Moments(z1, z2, f);
+    G4double sum = 0.;
+    for (G4int n=0; n<5; ++n) {
+      G4double q = 0., power = 1.;
+      for (G4int m=n; m<5; ++m) {
+        q += p[m]*binomial[m][n]*power;
+        power *= c;
+      }
+      sum += q*f[n];
+    }
+    return sum;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NeutronXSTableBuilder::Broaden(const Curve& curve, G4double massRatio,
+                                        G4double temperature,
+                                        G4double energy) const
+{
+  // free gas kernel, in reduced speeds x = sqrt(alpha E'), y = sqrt(alpha E):
+  // sigma(y) = 1/(sqrt(pi) y^2) Int x^2 sigma(x) 
+  //                              [exp(-(x-y)^2) - exp(-(x+y)^2)] dx
+  G4double alpha = massRatio/(k_Boltzmann*temperature);
+  G4double y = std::sqrt(alpha*energy);
+  const std::vector<G4double>& e = curve.fEnergy;
+  const std::vector<G4double>& v = curve.fValue;
+  size_t n = e.size();
+  
+  // segment k, from x_k to x_k+1: x^2 sigma as a polynomial of u = x - x_k;
+  // k = 0 below the first point (1/v), n above the last one (constant)
+  G4double minus = 0., plus = 0.;
+  G4double xMin = std::max(0., y - kWindow), xMax = y + kWindow;
+  size_t first = std::upper_bound(e.begin(), e.end(), xMin*xMin/alpha) - e.begin();
+  if (first > 0) first--;
+  if (y < kWindow) first = 0;
+  for (size_t k=first; k<=n; ++k) {
+    G4double xa = (k == 0) ? 0. : std::sqrt(alpha*e[k-1]);
+    G4double xb = (k == n) ? DBL_MAX : std::sqrt(alpha*e[k]);
+    if (xa > xMax) break;
+    G4double p[5] = { 0., 0., 0., 0., 0. };
+    if (k == 0) {
+      p[1] = v[0]*xb;
+    }
+    else if (k == n) {
+      p[0] = v[n-1]*xa*xa;  p[1] = 2.*v[n-1]*xa;  p[2] = v[n-1];
+    }
+    else {
+      G4double sa = v[k-1], b = (v[k] - sa)/(xb*xb - xa*xa);
+      G4double s[3] = { sa, 2.*b*xa, b };
+      G4double x2[3] = { xa*xa, 2.*xa, 1. };
+      for (G4int i=0; i<3; ++i) {
+        for (G4int j=0; j<3; ++j) p[i+j] += s[i]*x2[j];
+      }
+    }
+    G4double z1 = std::max(xa - y, -kWindow), z2 = std::min(xb - y, kWindow);
+    if (z1 < z2) minus += Integral(p, y - xa, z1, z2);
+    z1 = xa + y;
+    z2 = std::min(xb + y, kWindow);
+    if (z1 < z2) plus += Integral(p, -(y + xa), z1, z2);
+  }
+  return (minus - plus)/(std::sqrt(pi)*y*y);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NeutronXSTableBuilder::GetCrossSection(G4int reaction,
+                                                const G4Element* element,
+                                                G4double energy,
+                                                G4double temperature)
+{
+  const Curve& curve = GetCurve(reaction, element);
+  if (!(temperature > 0.)) return Interpolate(curve, energy);
+  G4double massRatio = element->GetN()*amu_c2/neutron_mass_c2;
+  return Broaden(curve, massRatio, temperature, energy);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NeutronXSTableBuilder::GetThreshold(G4int reaction,
+                                             const G4Element* element)
+{
+  const Curve& curve = GetCurve(reaction, element);
+  for (size_t i=0; i<curve.fValue.size(); ++i) {
+    if (curve.fValue[i] > 0.) return (i == 0) ? 0. : curve.fEnergy[i-1];
+  }
+  return DBL_MAX;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronXSTable* NeutronXSTableBuilder::Build(const G4Material* material,
+                                             G4double temperature)
+{
+  size_t nElements = material->GetNumberOfElements();
+  std::vector<G4int> elementZ(nElements);
+  for (size_t j=0; j<nElements; ++j) {
+    elementZ[j] = G4lrint(material->GetElement(j)->GetZ());
+  }
+
+  // unionized grid: all the 0 K points of the elements
+  std::vector<G4double> grid;
+  for (G4int r=0; r<NeutronXSTable::kNbReactions; ++r) {
+    for (size_t j=0; j<nElements; ++j) {
+      const Curve& curve = GetCurve(r, material->GetElement(j));
+      grid.insert(grid.end(), curve.fEnergy.begin(), curve.fEnergy.end());
+    }
+  }
+  std::sort(grid.begin(), grid.end());
+  grid.erase(std::unique(grid.begin(), grid.end()), grid.end());
+
+  NeutronXSTable* table
+    = new NeutronXSTable(material->GetName(), temperature, elementZ);
+  table->SetGrid(grid);
+  for (size_t i=0; i<grid.size(); ++i) {
+    for (G4int r=0; r<NeutronXSTable::kNbReactions; ++r) {
+      for (size_t j=0; j<nElements; ++j) {
+        table->SetCrossSection(r, (G4int)j, i, GetCrossSection(r, 
+                               material->GetElement(j), grid[i], temperature));
+      }
+    }
+  }
+  return table;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NeutronXSTableBuilder::BuildAndWrite(const G4Material* material,
+                                            G4double temperature,
+                                            const G4String& directory)
+{
+  NeutronXSTable* table = Build(material, temperature);
+  G4String fileName
+    = NeutronXSTable::FileName(directory, material->GetName(), temperature);
+  G4bool ok = table->Write(fileName);
+  G4cout << " NeutronXSTableBuilder: " << material->GetName() << " at "
+         << temperature/kelvin << " K, " << table->GetNbEnergies()
+         << " energy points, tolerance " << fTolerance
+         << (ok ? " --> " : " ### could not write ") << fileName << G4endl;
+  delete table;
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
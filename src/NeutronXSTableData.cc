@@ -0,0 +1,115 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NeutronXSTableData.cc
+/// \brief Implementation of the NeutronXSTableData class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NeutronXSTableData.hh"
+#include "NeutronXSTable.hh"
+#include "NeutronXSTableStore.hh"
+
+#include "G4DynamicParticle.hh"
+#include "G4Material.hh"
+
+namespace {
+  const char* kReactionName[NeutronXSTable::kNbReactions]
+    = { "Elastic", "Inelastic", "Capture", "Fission" };
+
+  // last bin search, shared by the elements and reactions of a material
+  G4ThreadLocal const NeutronXSTable* lastTable = 0;
+  G4ThreadLocal G4double              lastEnergy = -1.;
+  G4ThreadLocal size_t                lastBin = 0;
+
+  inline size_t FindBin(const NeutronXSTable* table, G4double energy)
+  {
+    if (table != lastTable || energy != lastEnergy) {
+      lastTable  = table;
+      lastEnergy = energy;
+      lastBin    = table->FindBin(energy);
+    }
+    return lastBin;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronXSTableData::NeutronXSTableData(G4int reaction)
+: G4VCrossSectionDataSet(G4String("NeutronXSTable") + kReactionName[reaction]),
+  fReaction(reaction)
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronXSTableData::~NeutronXSTableData()
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NeutronXSTableData::IsElementApplicable(const G4DynamicParticle* dp,
+                                               G4int Z, const G4Material* mat)
+{
+  if (!mat) return false;
+  const NeutronXSTable* table = NeutronXSTableStore::Instance()->GetTable(mat);
+  if (!table) return false;
+  G4double energy = dp->GetKineticEnergy();
+  if (energy < table->GetMinEnergy() || energy > table->GetMaxEnergy()) {
+    return false;
+  }
+  return (table->ElementIndex(Z) >= 0);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double NeutronXSTableData::GetElementCrossSection(const G4DynamicParticle* dp,
+                                                    G4int Z,
+                                                    const G4Material* mat)
+{
+  const NeutronXSTable* table = NeutronXSTableStore::Instance()->GetTable(mat);
+  G4double energy = dp->GetKineticEnergy();
+  return table->GetCrossSection(fReaction, table->ElementIndex(Z),
+                                FindBin(table, energy), energy);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NeutronXSTableData::BuildPhysicsTable(const G4ParticleDefinition&)
+{
+  NeutronXSTableStore::Instance()->Load();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NeutronXSTableData::CrossSectionDescription(std::ostream& out) const
+{
+  out << "Pre-broadened " << kReactionName[fReaction]
+      << " cross sections tabulated per material and temperature on a"
+      << " unionized energy grid (see NeutronXSTableBuilder)." << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,130 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NeutronXSTableStore.cc
+/// \brief Implementation of the NeutronXSTableStore class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NeutronXSTableStore.hh"
+#include "NeutronXSTable.hh"
+#include "NeutronMacroXS.hh"
+
+#include "G4Material.hh"
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+
+namespace {
+  G4Mutex storeMutex = G4MUTEX_INITIALIZER;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronXSTableStore* NeutronXSTableStore::Instance()
+{
+  static NeutronXSTableStore instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronXSTableStore::NeutronXSTableStore()
+: fDirectory("xstables"), fLoaded(false)
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NeutronXSTableStore::~NeutronXSTableStore()
+{
+  for (size_t i=0; i<fTables.size(); ++i) delete fTables[i];
+  for (size_t i=0; i<fMacroTables.size(); ++i) delete fMacroTables[i];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NeutronXSTableStore::Load()
+{
+  G4AutoLock lock(&storeMutex);
+  const G4MaterialTable* materials = G4Material::GetMaterialTable();
+  if (fLoaded && fTables.size() == materials->size()) return;
+
+  fTables.resize(materials->size(), 0);
+  fMacroTables.resize(materials->size(), 0);
+  G4int nbLoaded = 0;
+  for (size_t i=0; i<materials->size(); ++i) {
+    if (fTables[i]) continue;
+    const G4Material* material = (*materials)[i];
+    G4String fileName = NeutronXSTable::FileName(fDirectory,
+                          material->GetName(), material->GetTemperature());
+    NeutronXSTable* table = NeutronXSTable::Read(fileName);
+    if (!table) continue;
+
+    // the table must describe the elements of the material, in order
+    G4bool match = (table->GetNbElements() == (G4int)material->GetNumberOfElements());
+    for (G4int j=0; match && j<table->GetNbElements(); ++j) {
+      match = (table->GetZ(j) == G4lrint(material->GetElement(j)->GetZ()));
+    }
+    if (!match) {
+      G4cout << "### NeutronXSTableStore: " << fileName
+             << " does not match the composition of " << material->GetName()
+             << "; ignored" << G4endl;
+      delete table;
+      continue;
+    }
+    fTables[i] = table;
+    fMacroTables[i] = new NeutronMacroXS(table, material);
+    nbLoaded++;
+    G4cout << " NeutronXSTableStore: " << material->GetName() << " at "
+           << material->GetTemperature()/kelvin << " K, "
+           << table->GetNbEnergies() << " energy points" << G4endl;
+  }
+  fLoaded = true;
+  if (nbLoaded == 0) {
+    G4cout << "### NeutronXSTableStore: no table found in " << fDirectory
+           << "; ParticleHP data will be used" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const NeutronXSTable*
+NeutronXSTableStore::GetTable(const G4Material* material) const
+{
+  size_t index = material->GetIndex();
+  return (index < fTables.size()) ? fTables[index] : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const NeutronMacroXS*
+NeutronXSTableStore::GetMacroTable(const G4Material* material) const
+{
+  size_t index = material->GetIndex();
+  return (index < fMacroTables.size()) ? fMacroTables[index] : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
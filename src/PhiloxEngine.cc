@@ -0,0 +1,229 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file PhiloxEngine.cc
+/// \brief Implementation of the PhiloxEngine class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PhiloxEngine.hh"
+
+#include <fstream>
+#include <iomanip>
+
+namespace {
+  // round multipliers and Weyl key increments of Philox4x32
+  const uint32_t kM0 = 0xD2511F53, kM1 = 0xCD9E8D57;
+  const uint32_t kW0 = 0x9E3779B9, kW1 = 0xBB67AE85;
+  const G4int    kNbRounds = 10;
+  const double   kTwoToMinus53 = 1./9007199254740992.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhiloxEngine::PhiloxEngine(G4long seed)
+: CLHEP::HepRandomEngine(), fIndex(4)
+{
+  setSeed(seed, 0);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhiloxEngine::~PhiloxEngine()
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhiloxEngine::SetStream(uint64_t seed, uint64_t stream)
+{
+  fKey[0] = (uint32_t)seed;
+  fKey[1] = (uint32_t)(seed >> 32);
+  fCounter[0] = fCounter[1] = 0;
+  fCounter[2] = (uint32_t)stream;
+  fCounter[3] = (uint32_t)(stream >> 32);
+  fIndex = 4;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhiloxEngine::Generate()
+{
+  uint32_t c[4] = { fCounter[0], fCounter[1], fCounter[2], fCounter[3] };
+  uint32_t k[2] = { fKey[0], fKey[1] };
+  for (G4int r=0; r<kNbRounds; ++r) {
+    uint64_t p0 = (uint64_t)kM0*c[0];
+    uint64_t p1 = (uint64_t)kM1*c[2];
+    uint32_t hi0 = (uint32_t)(p0 >> 32), lo0 = (uint32_t)p0;
+    uint32_t hi1 = (uint32_t)(p1 >> 32), lo1 = (uint32_t)p1;
+    c[0] = hi1 ^ c[1] ^ k[0];
+    c[1] = lo1;
+    c[2] = hi0 ^ c[3] ^ k[1];
+    c[3] = lo0;
+    k[0] += kW0; k[1] += kW1;
+  }
+  for (G4int i=0; i<4; ++i) fBuffer[i] = c[i];
+  
+  // next block of the stream
+  if (++fCounter[0] == 0) ++fCounter[1];
+  fIndex = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline uint32_t PhiloxEngine::Next()
+{
+  if (fIndex > 3) Generate();
+  return fBuffer[fIndex++];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+double PhiloxEngine::flat()
+{
+  // 53 random bits, centred in their interval: never 0 nor 1
+  uint64_t high = Next();
+  uint64_t low  = Next();
+  uint64_t bits = (high << 21) ^ (low >> 11);
+  return ((bits & 0x1FFFFFFFFFFFFFULL) + 0.5)*kTwoToMinus53;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhiloxEngine::flatArray(const int size, double* vect)
+{
+  for (G4int i=0; i<size; ++i) vect[i] = flat();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhiloxEngine::operator unsigned int()
+{
+  return Next();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhiloxEngine::SelfTest()
+{
+  // philox4x32-10 vectors: counter, key, then expected output
+  static const uint32_t kat[3][10] = {
+    { 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+      0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 },
+    { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+      0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd },
+    { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344, 0xa4093822, 0x299f31d0,
+      0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } };
+  PhiloxEngine engine;
+  for (G4int t=0; t<3; ++t) {
+    for (G4int i=0; i<4; ++i) engine.fCounter[i] = kat[t][i];
+    engine.fKey[0] = kat[t][4];
+    engine.fKey[1] = kat[t][5];
+    engine.Generate();
+    for (G4int i=0; i<4; ++i) {
+      if (engine.fBuffer[i] != kat[t][6+i]) return false;
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhiloxEngine::setSeed(long seed, int)
+{
+  theSeed = seed;
+  SetStream((uint64_t)seed, 0);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhiloxEngine::setSeeds(const long* seeds, int)
+{
+  // seeds as handed out by the MT run manager: zero-terminated list
+  theSeeds = seeds;
+  uint64_t key = 0, stream = 0;
+  if (seeds && seeds[0]) {
+    key = (uint32_t)seeds[0];
+    if (seeds[1]) {
+      key |= (uint64_t)(uint32_t)seeds[1] << 32;
+      if (seeds[2]) stream = (uint32_t)seeds[2];
+    }
+  }
+  theSeed = (long)key;
+  SetStream(key, stream);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhiloxEngine::saveStatus(const char filename[]) const
+{
+  std::ofstream out(filename);
+  if (!out) {
+    G4cout << "### PhiloxEngine: cannot write " << filename << G4endl;
+    return;
+  }
+  out << name() << "\n" << fKey[0] << " " << fKey[1];
+  for (G4int i=0; i<4; ++i) out << " " << fCounter[i];
+  for (G4int i=0; i<4; ++i) out << " " << fBuffer[i];
+  out << " " << fIndex << "\n";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhiloxEngine::restoreStatus(const char filename[])
+{
+  std::ifstream in(filename);
+  std::string engine;
+  if (!(in >> engine) || engine != name()) {
+    G4cout << "### PhiloxEngine: " << filename 
+           << " is not a PhiloxEngine status file" << G4endl;
+    return;
+  }
+  in >> fKey[0] >> fKey[1];
+  for (G4int i=0; i<4; ++i) in >> fCounter[i];
+  for (G4int i=0; i<4; ++i) in >> fBuffer[i];
+  in >> fIndex;
+  if (!in) {
+    G4cout << "### PhiloxEngine: corrupted status in " << filename << G4endl;
+    SetStream(0, 0);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhiloxEngine::showStatus() const
+{
+  uint64_t key = ((uint64_t)fKey[1] << 32) | fKey[0];
+  uint64_t stream = ((uint64_t)fCounter[3] << 32) | fCounter[2];
+  uint64_t block = ((uint64_t)fCounter[1] << 32) | fCounter[0];
+  G4cout << "\n--------- Philox engine status ---------"
+         << "\n  key (seed) = " << key 
+         << "   stream = " << stream
+         << "   position = " << 4*block - (4 - fIndex) 
+         << "\n----------------------------------------" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -30,11 +30,13 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #include "PhysicsList.hh"
+#include "PhysicsListMessenger.hh"
 
 #include "G4SystemOfUnits.hh"
 #include "G4UnitsTable.hh"
 
 #include "NeutronHPphysics.hh"
+#include "MultigroupNeutronPhysics.hh"
 #include "EmStandardPhysics.hh"
 #include "G4DecayPhysics.hh"
 #include "G4RadioactiveDecayPhysics.hh"
@@ -62,11 +64,13 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 PhysicsList::PhysicsList()
-:G4VModularPhysicsList()
+:G4VModularPhysicsList(), fMessenger(0), fMultigroup(false)
 {
   G4int verb = 1;
   SetVerboseLevel(verb);
   
+  fMessenger = new PhysicsListMessenger(this);
+  
   //add new units
   //
   new G4UnitDefinition( "millielectronVolt", "meV", "Energy", 1.e-3*eV);   
@@ -108,7 +112,9 @@ PhysicsList::PhysicsList()
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 PhysicsList::~PhysicsList()
-{ }
+{
+  delete fMessenger;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -144,3 +150,18 @@ void PhysicsList::SetCuts()
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsList::SelectNeutronModel(const G4String& name)
+{
+  // the multigroup constructor is registered after neutronHP and replaces
+  // its processes in ConstructProcess; HP is the default
+  if (name == "MG" && !fMultigroup) {
+    RegisterPhysics(new MultigroupNeutronPhysics("neutronMG"));
+    fMultigroup = true;
+  } else if (name == "HP" && fMultigroup) {
+    G4cout << "### PhysicsList: multigroup transport already selected"
+           << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,584 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file PointDetector.cc
+/// \brief Implementation of the PointDetector class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PointDetector.hh"
+#include "PointDetectorMessenger.hh"
+#include "Campaign.hh"
+#include "Checkpoint.hh"
+#include "Run.hh"
+#include "TallySums.hh"
+
+#include "G4Step.hh"
+#include "G4Neutron.hh"
+#include "G4Gamma.hh"
+#include "G4VProcess.hh"
+#include "G4HadronicProcess.hh"
+#include "G4HadronicProcessType.hh"
+#include "G4EmProcessSubType.hh"
+#include "G4Material.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Navigator.hh"
+#include "G4TransportationManager.hh"
+#include "G4HadronicProcessStore.hh"
+#include "G4EmCalculator.hh"
+#include "G4ParticleHPManager.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+#include "G4AutoLock.hh"
+#include "geomdefs.hh"
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  // energies of the tables of cross sections
+  const G4double kXsEmin = 1.e-5*eV;
+  const G4double kXsEmax = 20.*MeV;
+  
+  // rays given up: beyond this optical depth, after this many volumes
+  const G4double kMaxDepth = 50.;
+  const G4int    kMaxVolumes = 10000;
+  
+  // score of the current event, sums over the events, for the run fRun;
+  // navigator of the thread
+  struct ThreadSums {
+    ThreadSums() : fNbEvents(0), fNbRays(0), fNbRouletted(0), fRun(-1),
+                   fRandom(0), fNavigator(new G4Navigator) {}
+   ~ThreadSums() { delete fNavigator; }
+    void Reset(size_t size, size_t nbTallies, G4int run)
+    {
+      fEvent.assign(size, 0.);
+      fSum.assign(size, 0.);
+      fSum2.assign(size, 0.);
+      fTouched.clear();
+      fMeanSum.assign(nbTallies, 0.);
+      fMeanCount.assign(nbTallies, 0);
+      fNbEvents = fNbRays = fNbRouletted = 0;
+      fRun = run;
+    }
+    std::vector<G4double> fEvent, fSum, fSum2;
+    std::vector<size_t>   fTouched;     // bins of fEvent not zero
+    std::vector<G4double> fMeanSum;     // contributions, per point and particle
+    std::vector<G4long>   fMeanCount;
+    G4long                fNbEvents, fNbRays, fNbRouletted;
+    G4int                 fRun;
+    uint64_t              fRandom;
+    G4Navigator*          fNavigator;
+  };
+  G4ThreadLocal ThreadSums* threadSums = 0;
+  
+  // uniform in [0,1), splitmix64: the roulette of the rays does not use
+  // the random engine, which would change the histories of the tracks
+  inline G4double Uniform(uint64_t& state)
+  {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+    return ((z ^ (z >> 31)) >> 11)*(1./9007199254740992.);
+  }
+  
+  // Klein-Nishina cross section, in units of pi re^2, k = E/mc2
+  G4double KleinNishina(G4double k)
+  {
+    if (k < 1.e-3) return 8./3.*(1. - 2.*k + 5.2*k*k);
+    G4double l = std::log(1. + 2.*k);
+    return 2.*((1. + k)/(k*k)*(2.*(1. + k)/(1. + 2.*k) - l/k) + 0.5*l/k 
+               - (1. + 3.*k)/((1. + 2.*k)*(1. + 2.*k)));
+  }
+  
+  // density of the lab cosine mu of an emission, and energy emitted at mu
+  G4double Toward(const PointDetector::Emission& emission, G4double energy,
+                  G4double mu, G4double& energyOut)
+  {
+    energyOut = energy;
+    switch (emission.fType) {
+      case PointDetector::kElastic: {
+        // speed u at mu, in units of the centre of mass speed:
+        // u^2 - 2 u mu + 1 - A^2 = 0, A >= 1 (one root)
+        G4double A = emission.fMassRatio;
+        G4double root = std::sqrt(std::max(0., mu*mu + A*A - 1.));
+        G4double u = mu + root;
+        if (!(u > 0.) || !(root > 0.)) return 0.;
+        energyOut = energy*u*u/((A + 1.)*(A + 1.));
+        return u*u/(2.*A*root);
+      }
+      case PointDetector::kCompton: {
+        G4double k = energy/electron_mass_c2;
+        G4double ratio = 1./(1. + k*(1. - mu));
+        energyOut = energy*ratio;
+        return ratio*ratio*(ratio + 1./ratio - 1. + mu*mu)/KleinNishina(k);
+      }
+      case PointDetector::kRayleigh:
+        return 0.375*(1. + mu*mu);
+      default:
+        return 0.5;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PointDetector* PointDetector::Instance()
+{
+  static PointDetector instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PointDetector::PointDetector()
+: fExclusion(10.*cm), fRoulette(0.), fXsPoints(100), fNbBins(600), 
+  fEmin(1.e-5*eV), fEmax(10.*MeV), fFileName("Hadr04"), fActive(false), 
+  fRunCount(0), fStride(0), fStart(0.), fNbEvents(0), fNbRays(0), 
+  fNbRouletted(0), fMessenger(0)
+{
+  fMessenger = new PointDetectorMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PointDetector::~PointDetector()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PointDetector::AddPoint(const G4String& name, const G4ThreeVector& position)
+{
+  // a point of same name is moved
+  for (size_t i=0; i<fPoints.size(); ++i) {
+    if (fPoints[i].fName == name) {
+      fPoints[i].fPosition = position;
+      return;
+    }
+  }
+  Point point;
+  point.fName = name;
+  point.fPosition = position;
+  fPoints.push_back(point);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PointDetector::SetBinning(G4int nbins, G4double emin, G4double emax)
+{
+  if (nbins < 1 || !(emin > 0.) || !(emax > emin)) {
+    G4cout << "### PointDetector: bad binning, unchanged" << G4endl;
+    return;
+  }
+  fNbBins = nbins;
+  fEmin = emin;
+  fEmax = emax;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PointDetector::BeginOfRun()
+{
+  fActive = false;
+  if (fPoints.empty()) return;
+  
+  // energy bins, evenly spaced in log(E)
+  std::vector<G4double> edges;
+  for (G4int i=0; i<=fNbBins; ++i) {
+    edges.push_back(fEmin*std::pow(fEmax/fEmin, G4double(i)/fNbBins));
+  }
+  if (!fBinning.Set(edges)) {
+    G4cout << "### PointDetector: bins too narrow, no flux scored" << G4endl;
+    return;
+  }
+  fStride = fNbBins + 3;
+  BuildTables();
+  
+  G4AutoLock lock(&fMutex);
+  fSum.assign(fPoints.size()*kNbParticles*fStride, 0.);
+  fSum2.assign(fPoints.size()*kNbParticles*fStride, 0.);
+  fNbEvents = fNbRays = fNbRouletted = 0;
+  fStart = Run::WallClock();
+  fRunCount++;
+  fActive = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PointDetector::PrepareThread()
+{
+  // arrays of this thread, reset at its first use in the run
+  if (!threadSums) threadSums = new ThreadSums;
+  if (threadSums->fRun == fRunCount) return;
+  threadSums->Reset(fPoints.size()*kNbParticles*fStride, 
+                    fPoints.size()*kNbParticles, fRunCount);
+  threadSums->fRandom = uint64_t(fRunCount) << 32 
+                      | uint64_t(G4Threading::G4GetThreadId() + 1);
+  G4Navigator* tracking = 
+    G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
+  threadSums->fNavigator->SetWorldVolume(tracking->GetWorldVolume());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PointDetector::Score(const G4Step* step)
+{
+  const G4Track* track = step->GetTrack();
+  G4int particle;
+  if      (track->GetDefinition() == G4Neutron::Definition()) particle = kNeutron;
+  else if (track->GetDefinition() == G4Gamma::Definition())   particle = kGamma;
+  else return;
+  const G4StepPoint* pre = step->GetPreStepPoint();
+  const G4StepPoint* post = step->GetPostStepPoint();
+  
+  // birth of the track
+  Emission emission = { kIsotropic, G4ThreeVector(), 0. };
+  if (track->GetCurrentStepNumber() == 1) {
+    Contribute(pre->GetPosition(), particle, pre->GetKineticEnergy(), 
+               pre->GetWeight(), pre->GetMaterial(), emission);
+  }
+  
+  // collision that the track survives: from the incident energy and
+  // direction when its kinematics is known, isotropic otherwise
+  if (post->GetStepStatus() != fPostStepDoItProc || 
+      track->GetTrackStatus() != fAlive) return;
+  const G4VProcess* process = post->GetProcessDefinedStep();
+  G4ProcessType type = process->GetProcessType();
+  if (type != fHadronic && type != fElectromagnetic) return;
+  G4int subType = process->GetProcessSubType();
+  if (particle == kNeutron && subType == fHadronElastic) {
+    const G4HadronicProcess* hadronic = 
+      dynamic_cast<const G4HadronicProcess*>(process);
+    G4int A = hadronic ? hadronic->GetTargetNucleus()->GetA_asInt() : 0;
+    if (A > 0) {
+      // hydrogen as A = 1
+      emission.fType = kElastic;
+      emission.fMassRatio = std::max(1., A*amu_c2/neutron_mass_c2);
+    }
+  }
+  else if (particle == kGamma && subType == fComptonScattering) {
+    emission.fType = kCompton;
+  }
+  else if (particle == kGamma && subType == fRayleigh) {
+    emission.fType = kRayleigh;
+  }
+  G4double energy = post->GetKineticEnergy();
+  if (emission.fType != kIsotropic) {
+    emission.fDirection = pre->GetMomentumDirection();
+    energy = pre->GetKineticEnergy();
+  }
+  Contribute(post->GetPosition(), particle, energy, post->GetWeight(), 
+             pre->GetMaterial(), emission);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PointDetector::Contribute(const G4ThreeVector& position, G4int particle,
+                               G4double incident, G4double weight,
+                               const G4Material* material,
+                               const Emission& emission)
+{
+  if (!(weight > 0.) || !(incident > 0.)) return;
+  PrepareThread();
+  ThreadSums* sums = threadSums;
+  for (size_t p=0; p<fPoints.size(); ++p) {
+    size_t tally = p*kNbParticles + particle;
+    G4ThreeVector toPoint = fPoints[p].fPosition - position;
+    G4double r2 = toPoint.mag2();
+    
+    // density of the emission toward the point, times 4 pi
+    G4double mu = (r2 > 0.) ? emission.fDirection.dot(toPoint)/std::sqrt(r2) : 1.;
+    G4double energy;
+    G4double density = 2.*Toward(emission, incident, mu, energy);
+    if (!(density > 0.) || !(energy > 0.)) continue;
+    
+    G4double score;
+    if (r2 < fExclusion*fExclusion) {
+      // mean over the exclusion sphere, of uniform material
+      G4double depth = CrossSection(material, particle, energy)*fExclusion;
+      G4double mean = (depth > 1.e-6) ? (1. - std::exp(-depth))/depth 
+                                      : 1. - 0.5*depth;
+      score = weight*density*3.*mean/(4.*pi*fExclusion*fExclusion);
+    }
+    else {
+      score = weight*density/(4.*pi*r2);
+      if (fRoulette > 0. && sums->fMeanCount[tally] > 0) {
+        G4double threshold = 
+          fRoulette*sums->fMeanSum[tally]/sums->fMeanCount[tally];
+        if (score < threshold) {
+          G4double survival = score/threshold;
+          if (Uniform(sums->fRandom) >= survival) {
+            sums->fNbRouletted++;
+            continue;
+          }
+          score /= survival;
+        }
+      }
+      sums->fNbRays++;
+      score *= std::exp(-OpticalDepth(position, fPoints[p].fPosition, 
+                                      particle, energy));
+    }
+    sums->fMeanSum[tally] += score;
+    sums->fMeanCount[tally]++;
+    if (!(score > 0.)) continue;
+    
+    size_t first = tally*fStride;
+    size_t bins[2] = { first + fBinning.Index(energy), first + fStride - 1 };
+    for (G4int k=0; k<2; ++k) {
+      G4double& event = sums->fEvent[bins[k]];
+      if (event == 0.) sums->fTouched.push_back(bins[k]);
+      event += score;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PointDetector::BuildTables()
+{
+  // at fXsPoints energies per decade, for all the materials; the 0 K 
+  // neutron data draw no random number
+  G4ParticleHPManager* hpManager = G4ParticleHPManager::GetInstance();
+  G4bool neglectDoppler = hpManager->GetNeglectDoppler();
+  hpManager->SetNeglectDoppler(true);
+  
+  const G4MaterialTable* materials = G4Material::GetMaterialTable();
+  G4int nbPoints = G4int(std::ceil(std::log10(kXsEmax/kXsEmin)*fXsPoints)) + 1;
+  G4HadronicProcessStore* store = G4HadronicProcessStore::Instance();
+  G4EmCalculator calculator;
+  const G4ParticleDefinition* neutron = G4Neutron::Definition();
+  fTables.assign(materials->size()*kNbParticles, std::vector<G4double>());
+  for (size_t j=0; j<materials->size(); ++j) {
+    const G4Material* material = (*materials)[j];
+    for (G4int particle=0; particle<kNbParticles; ++particle) {
+      std::vector<G4double>& table = 
+        fTables[material->GetIndex()*kNbParticles + particle];
+      for (G4int i=0; i<nbPoints; ++i) {
+        G4double e = kXsEmin*std::pow(10., G4double(i)/fXsPoints);
+        G4double sigma = 0.;
+        if (particle == kNeutron) {
+          sigma = store->GetElasticCrossSectionPerVolume(neutron, e, material)
+                + store->GetInelasticCrossSectionPerVolume(neutron, e, material)
+                + store->GetCaptureCrossSectionPerVolume(neutron, e, material)
+                + store->GetFissionCrossSectionPerVolume(neutron, e, material);
+        }
+        else {
+          G4double length = calculator.ComputeGammaAttenuationLength(e, material);
+          if (length > 0. && length < DBL_MAX) sigma = 1./length;
+        }
+        table.push_back(sigma);
+      }
+    }
+  }
+  hpManager->SetNeglectDoppler(neglectDoppler);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double PointDetector::CrossSection(const G4Material* material, 
+                                     G4int particle, G4double energy) const
+{
+  if (!material) return 0.;
+  size_t index = material->GetIndex()*kNbParticles + particle;
+  if (index >= fTables.size() || fTables[index].empty()) return 0.;
+  const std::vector<G4double>& table = fTables[index];
+  
+  // linear in log(E) between the points
+  G4double u = std::log10(energy/kXsEmin)*fXsPoints;
+  if (!(u > 0.)) return table.front();
+  size_t i = size_t(u);
+  if (i + 1 >= table.size()) return table.back();
+  G4double f = u - i;
+  return (1. - f)*table[i] + f*table[i+1];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double PointDetector::OpticalDepth(const G4ThreeVector& from, 
+                                     const G4ThreeVector& to,
+                                     G4int particle, G4double energy)
+{
+  G4ThreeVector direction = to - from;
+  G4double remaining = direction.mag();
+  if (!(remaining > 0.)) return 0.;
+  direction /= remaining;
+  
+  // volume after volume; nothing beyond the world
+  G4Navigator* navigator = threadSums->fNavigator;
+  G4ThreeVector position = from;
+  G4VPhysicalVolume* volume = 
+    navigator->LocateGlobalPointAndSetup(position, &direction, false, false);
+  G4double depth = 0.;
+  for (G4int n=0; volume && remaining > 0. && n<kMaxVolumes; ++n) {
+    G4double safety = 0.;
+    G4double step = navigator->ComputeStep(position, direction, remaining, safety);
+    if (step > remaining) step = remaining;
+    depth += step*CrossSection(volume->GetLogicalVolume()->GetMaterial(), 
+                               particle, energy);
+    if (depth > kMaxDepth) return depth;
+    remaining -= step;
+    position += step*direction;
+    navigator->SetGeometricallyLimitedStep();
+    volume = navigator->LocateGlobalPointAndSetup(position, &direction, true);
+  }
+  return depth;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PointDetector::EndOfEvent()
+{
+  if (!fActive) return;
+  PrepareThread();
+  ThreadSums* sums = threadSums;
+  for (size_t k=0; k<sums->fTouched.size(); ++k) {
+    size_t i = sums->fTouched[k];
+    G4double score = sums->fEvent[i];
+    sums->fSum[i]  += score;
+    sums->fSum2[i] += score*score;
+    sums->fEvent[i] = 0.;
+  }
+  sums->fTouched.clear();
+  sums->fNbEvents++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PointDetector::EndOfThreadRun()
+{
+  if (!fActive || !threadSums || threadSums->fRun != fRunCount) return;
+  
+  G4AutoLock lock(&fMutex);
+  for (size_t i=0; i<fSum.size(); ++i) {
+    fSum[i]  += threadSums->fSum[i];
+    fSum2[i] += threadSums->fSum2[i];
+  }
+  fNbEvents += threadSums->fNbEvents;
+  fNbRays += threadSums->fNbRays;
+  fNbRouletted += threadSums->fNbRouletted;
+  threadSums->fRun = -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  // relative error of the mean of the event scores, -1 if undefined
+  G4double RelError(G4double sum, G4double sum2, G4double n)
+  {
+    if (n < 2. || sum <= 0.) return -1.;
+    G4double mean = sum/n;
+    G4double variance = std::max(0., sum2/n - mean*mean)*n/(n-1.);
+    return std::sqrt(variance/n)/mean;
+  }
+  
+  const char* kParticleNames[PointDetector::kNbParticles] = 
+    { "neutron", "gamma" };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PointDetector::EndOfRun()
+{
+  if (!fActive) return;
+  fActive = false;
+  
+  G4AutoLock lock(&fMutex);
+  if (fNbEvents == 0) return;
+  G4double n = (G4double)fNbEvents;
+  G4double time = Run::WallClock() - fStart;
+  
+  G4int prec = G4cout.precision(3);
+  G4cout << "\n Next event estimator of the flux per source neutron (" 
+         << fNbEvents << " events, exclusion radius " 
+         << G4BestUnit(fExclusion, "Length") << "):\n"
+         << "  point            x (m)     y (m)     z (m)  particle"
+         << "  flux (/cm2)  rel.error    FOM (/s)" << G4endl;
+  for (size_t p=0; p<fPoints.size(); ++p) {
+    const G4ThreeVector& position = fPoints[p].fPosition;
+    for (G4int particle=0; particle<kNbParticles; ++particle) {
+      size_t total = (p*kNbParticles + particle)*fStride + fStride - 1;
+      G4double error = RelError(fSum[total], fSum2[total], n);
+      G4cout << "  " << std::setw(14) << std::left << fPoints[p].fName
+             << std::right << std::setw(8) << position.x()/m 
+             << std::setw(10) << position.y()/m << std::setw(10) << position.z()/m
+             << std::setw(10) << kParticleNames[particle]
+             << std::setw(13) << fSum[total]/n*cm2 << std::setw(11) << error;
+      if (error > 0. && time > 0.) G4cout << std::setw(12) << 1./(error*error*time);
+      G4cout << G4endl;
+    }
+  }
+  G4cout << "  rays per event: " << fNbRays/n 
+         << ", rouletted: " << fNbRouletted/n << G4endl;
+  G4cout.precision(prec);
+  
+  WriteSpectra(fNbEvents);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PointDetector::WriteSpectra(G4long nbEvents) const
+{
+  // raw sums (.h04s), summed as such over a campaign, and their text
+  TallySums sums("next event flux per source neutron and per unit lethargy",
+                 "point particle Elow(MeV) Ehigh(MeV) flux(/cm2) relError");
+  sums.SetNbEvents(nbEvents);
+  
+  // per unit lethargy: bins of ln(Emax/Emin)/nbins
+  G4double lethargy = std::log(fEmax/fEmin)/fNbBins;
+  for (size_t p=0; p<fPoints.size(); ++p) {
+    for (G4int particle=0; particle<kNbParticles; ++particle) {
+      for (G4int b=1; b<=fNbBins; ++b) {
+        size_t i = (p*kNbParticles + particle)*fStride + b;
+        std::ostringstream key;
+        key << fPoints[p].fName << " " << kParticleNames[particle] << " "
+            << fBinning.GetEdge(b-1)/MeV << " " << fBinning.GetEdge(b)/MeV;
+        sums.AddEntry(key.str(), cm2/lethargy, fSum[i], fSum2[i]);
+      }
+    }
+  }
+  
+  Campaign* campaign = Campaign::Instance();
+  Checkpoint* checkpoint = Checkpoint::Instance();
+  G4String names[2] = { fFileName + "_point.txt", fFileName + "_point.h04s" };
+  names[0] = checkpoint->OutputName(campaign->OutputName(names[0], ".txt"));
+  names[1] = checkpoint->OutputName(campaign->OutputName(names[1], ".h04s"));
+  if (!sums.WriteText(names[0]) || !sums.Write(names[1])) {
+    G4cout << "### PointDetector: cannot write " << names[0] << " or " 
+           << names[1] << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
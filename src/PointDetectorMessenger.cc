@@ -0,0 +1,175 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file PointDetectorMessenger.cc
+/// \brief Implementation of the PointDetectorMessenger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PointDetectorMessenger.hh"
+
+#include "PointDetector.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PointDetectorMessenger::PointDetectorMessenger(PointDetector* detector)
+:G4UImessenger(),fDetector(detector),
+ fPointDir(0), fAddCmd(0), fClearCmd(0), fExclusionCmd(0), fRouletteCmd(0),
+ fXsPointsCmd(0), fBinningCmd(0), fFileCmd(0)
+{ 
+  G4bool broadcast = false;
+  fPointDir = new G4UIdirectory("/testhadr/point/",broadcast);
+  fPointDir->SetGuidance("next event estimator of the flux at points");
+  
+  fAddCmd = new G4UIcommand("/testhadr/point/add",this);
+  fAddCmd->SetGuidance("add a point detector, or move the one of same name");
+  fAddCmd->SetParameter(new G4UIparameter("name",'s',false));
+  fAddCmd->SetParameter(new G4UIparameter("x",'d',false));
+  fAddCmd->SetParameter(new G4UIparameter("y",'d',false));
+  fAddCmd->SetParameter(new G4UIparameter("z",'d',false));
+  G4UIparameter* unitPrm = new G4UIparameter("unit",'s',true);
+  unitPrm->SetDefaultUnit("m");
+  fAddCmd->SetParameter(unitPrm);
+  fAddCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fAddCmd->SetToBeBroadcasted(false);
+  
+  fClearCmd = new G4UIcmdWithoutParameter("/testhadr/point/clear",this);
+  fClearCmd->SetGuidance("remove all the point detectors");
+  fClearCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fClearCmd->SetToBeBroadcasted(false);
+  
+  fExclusionCmd = new G4UIcmdWithADoubleAndUnit("/testhadr/point/exclusion",this);
+  fExclusionCmd->SetGuidance("radius of the exclusion spheres (default 10 cm)");
+  fExclusionCmd->SetParameterName("radius",false);
+  fExclusionCmd->SetRange("radius>0.");
+  fExclusionCmd->SetUnitCategory("Length");
+  fExclusionCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fExclusionCmd->SetToBeBroadcasted(false);
+  
+  fRouletteCmd = new G4UIcmdWithADouble("/testhadr/point/roulette",this);
+  fRouletteCmd->SetGuidance("roulette of the rays of bound below k times the");
+  fRouletteCmd->SetGuidance("  mean contribution to their point; 0 for none");
+  fRouletteCmd->SetParameterName("k",false);
+  fRouletteCmd->SetRange("k>=0.");
+  fRouletteCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fRouletteCmd->SetToBeBroadcasted(false);
+  
+  fXsPointsCmd = new G4UIcmdWithAnInteger("/testhadr/point/xsPoints",this);
+  fXsPointsCmd->SetGuidance("energies per decade of the tables of total");
+  fXsPointsCmd->SetGuidance("  cross sections (default 100)");
+  fXsPointsCmd->SetParameterName("n",false);
+  fXsPointsCmd->SetRange("n>0");
+  fXsPointsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fXsPointsCmd->SetToBeBroadcasted(false);
+  
+  fBinningCmd = new G4UIcommand("/testhadr/point/binning",this);
+  fBinningCmd->SetGuidance("energy bins of the spectra, equal in lethargy");
+  fBinningCmd->SetGuidance("  (default: 600 bins from 1e-5 eV to 10 MeV)");
+  G4UIparameter* nbPrm = new G4UIparameter("nbins",'i',false);
+  nbPrm->SetParameterRange("nbins>0");
+  fBinningCmd->SetParameter(nbPrm);
+  G4UIparameter* minPrm = new G4UIparameter("emin",'d',false);
+  minPrm->SetParameterRange("emin>0.");
+  fBinningCmd->SetParameter(minPrm);
+  G4UIparameter* maxPrm = new G4UIparameter("emax",'d',false);
+  maxPrm->SetParameterRange("emax>0.");
+  fBinningCmd->SetParameter(maxPrm);
+  G4UIparameter* energyPrm = new G4UIparameter("unit",'s',true);
+  energyPrm->SetDefaultUnit("MeV");
+  fBinningCmd->SetParameter(energyPrm);
+  fBinningCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fBinningCmd->SetToBeBroadcasted(false);
+  
+  fFileCmd = new G4UIcmdWithAString("/testhadr/point/file",this);
+  fFileCmd->SetGuidance("stem of the file of spectra, <file>_point.txt");
+  fFileCmd->SetParameterName("file",false);
+  fFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fFileCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PointDetectorMessenger::~PointDetectorMessenger()
+{
+  delete fAddCmd;
+  delete fClearCmd;
+  delete fExclusionCmd;
+  delete fRouletteCmd;
+  delete fXsPointsCmd;
+  delete fBinningCmd;
+  delete fFileCmd;
+  delete fPointDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PointDetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{   
+  if (command == fAddCmd)
+   { G4String name, unit; G4double x, y, z;
+     std::istringstream is(newValue);
+     is >> name >> x >> y >> z >> unit;
+     G4double u = G4UIcommand::ValueOf(unit);
+     fDetector->AddPoint(name, G4ThreeVector(x*u, y*u, z*u));
+   }
+   
+  if (command == fClearCmd)
+   {fDetector->ClearPoints();}
+   
+  if (command == fExclusionCmd)
+   {fDetector->SetExclusionRadius(fExclusionCmd->GetNewDoubleValue(newValue));}
+   
+  if (command == fRouletteCmd)
+   {fDetector->SetRoulette(fRouletteCmd->GetNewDoubleValue(newValue));}
+   
+  if (command == fXsPointsCmd)
+   {fDetector->SetCrossSectionPoints(fXsPointsCmd->GetNewIntValue(newValue));}
+   
+  if (command == fBinningCmd)
+   { G4int nbins; G4double emin, emax; G4String unit;
+     std::istringstream is(newValue);
+     is >> nbins >> emin >> emax >> unit;
+     G4double u = G4UIcommand::ValueOf(unit);
+     fDetector->SetBinning(nbins, emin*u, emax*u);
+   }
+   
+  if (command == fFileCmd)
+   {fDetector->SetFileName(newValue);}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
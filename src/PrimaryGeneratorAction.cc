@@ -34,6 +34,7 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #include "PrimaryGeneratorAction.hh"
+#include "RandomStreams.hh"
 
 #include "G4Event.hh"
 #include "G4ParticleTable.hh"
@@ -79,6 +80,9 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
   //this function is called at the begining of event
   //
   
+  //random stream of this event
+  RandomStreams::Instance()->BeginOfEvent(anEvent->GetEventID());
+  
   //set particle position
   G4double pos_z = -fDetector->fSteelPlate_z/2 - fDetector->fNeutronShieldThickness - fDetector->fDDtubeLength/4;
   fParticleGun->SetParticlePosition(G4ThreeVector(0.*cm,0.*cm,pos_z));
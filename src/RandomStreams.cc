@@ -0,0 +1,130 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RandomStreams.cc
+/// \brief Implementation of the RandomStreams class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "RandomStreams.hh"
+#include "RandomStreamsMessenger.hh"
+#include "PhiloxEngine.hh"
+
+#include "Randomize.hh"
+
+namespace {
+  // engine of this thread, and the one it replaced
+  G4ThreadLocal PhiloxEngine*             philoxEngine = 0;
+  G4ThreadLocal CLHEP::HepRandomEngine*   defaultEngine = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RandomStreams* RandomStreams::Instance()
+{
+  static RandomStreams instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RandomStreams::RandomStreams()
+: fCounterBased(false), fSeed(20191008), fFirstEvent(0), fStreamListEnd(0),
+  fMessenger(0)
+{
+  fMessenger = new RandomStreamsMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RandomStreams::~RandomStreams()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RandomStreams::SetCounterBased(G4bool flag)
+{
+  if (flag && !PhiloxEngine::SelfTest()) {
+    G4cerr << "### RandomStreams: PhiloxEngine fails its known-answer test,"
+           << " counter-based streams are not used" << G4endl;
+    flag = false;
+  }
+  fCounterBased = flag;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RandomStreams::BeginOfEvent(G4int eventID)
+{
+  if (!fCounterBased) {
+    // back to the engine installed in main, if it was replaced
+    if (philoxEngine && G4Random::getTheEngine() == philoxEngine) {
+      G4Random::setTheEngine(defaultEngine);
+    }
+    return;
+  }
+
+  if (!philoxEngine) philoxEngine = new PhiloxEngine(fSeed);
+  if (G4Random::getTheEngine() != philoxEngine) {
+    defaultEngine = G4Random::getTheEngine();
+    G4Random::setTheEngine(philoxEngine);
+  }
+  
+  // the seeds set by the run manager for this event are overridden
+  philoxEngine->SetStream(fSeed, GetStreamIndex(eventID));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RandomStreams::BeginOfRun(G4int nbEvents) const
+{
+  if (!fCounterBased || nbEvents <= 0) return;
+  if (!fStreamList.empty()) {
+    G4cout << "\n Counter-based random streams (Philox4x32-10): seed " << fSeed
+           << ", " << nbEvents << " event streams from " << fStreamList.front()
+           << " to " << fStreamList.back() << G4endl;
+    return;
+  }
+  G4cout << "\n Counter-based random streams (Philox4x32-10): seed " << fSeed
+         << ", event streams " << fFirstEvent << " to " 
+         << fFirstEvent + nbEvents - 1 << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RandomStreams::EndOfRun(G4int nbEvents)
+{
+  if (!fStreamList.empty()) {
+    fFirstEvent = fStreamListEnd;
+    fStreamList.clear();
+  }
+  else if (nbEvents > 0) fFirstEvent += (uint64_t)nbEvents;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,110 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RandomStreamsMessenger.cc
+/// \brief Implementation of the RandomStreamsMessenger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "RandomStreamsMessenger.hh"
+
+#include "RandomStreams.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RandomStreamsMessenger::RandomStreamsMessenger(RandomStreams* streams)
+:G4UImessenger(),fStreams(streams),
+ fRandomDir(0), fEngineCmd(0), fSeedCmd(0), fFirstEventCmd(0)
+{ 
+  G4bool broadcast = false;
+  fRandomDir = new G4UIdirectory("/testhadr/random/",broadcast);
+  fRandomDir->SetGuidance("per-event random streams");
+  
+  fEngineCmd = new G4UIcmdWithAString("/testhadr/random/engine",this);
+  fEngineCmd->SetGuidance("default: engine of main, seeded by the run manager;");
+  fEngineCmd->SetGuidance("philox: counter-based stream per event,");
+  fEngineCmd->SetGuidance("  independent of threads and scheduling");
+  fEngineCmd->SetParameterName("engine",false);
+  fEngineCmd->SetCandidates("default philox");
+  fEngineCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fEngineCmd->SetToBeBroadcasted(false);
+  
+  fSeedCmd = new G4UIcommand("/testhadr/random/seed",this);
+  fSeedCmd->SetGuidance("seed of the philox streams (64 bits);");
+  fSeedCmd->SetGuidance("  /random/setSeeds does not apply to them");
+  G4UIparameter* seedPrm = new G4UIparameter("seed",'s',false);
+  fSeedCmd->SetParameter(seedPrm);
+  fSeedCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fSeedCmd->SetToBeBroadcasted(false);
+  
+  fFirstEventCmd = new G4UIcommand("/testhadr/random/firstEvent",this);
+  fFirstEventCmd->SetGuidance("stream index of the first event of next run;");
+  fFirstEventCmd->SetGuidance("  advanced by the number of events after each run");
+  G4UIparameter* firstPrm = new G4UIparameter("index",'s',false);
+  fFirstEventCmd->SetParameter(firstPrm);
+  fFirstEventCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fFirstEventCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RandomStreamsMessenger::~RandomStreamsMessenger()
+{
+  delete fEngineCmd;
+  delete fSeedCmd;
+  delete fFirstEventCmd;
+  delete fRandomDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RandomStreamsMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{   
+  if (command == fEngineCmd)
+   {fStreams->SetCounterBased(newValue == "philox");}
+   
+  if (command == fSeedCmd || command == fFirstEventCmd)
+   { unsigned long long value = 0;
+     std::istringstream is(newValue);
+     if (!(is >> value)) {
+       G4cout << "### " << command->GetCommandPath() << ": " << newValue
+              << " is not an unsigned integer" << G4endl;
+       return;
+     }
+     if (command == fSeedCmd) fStreams->SetSeed(value);
+     else                     fStreams->SetFirstEvent(value);
+   }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
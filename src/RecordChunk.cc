@@ -0,0 +1,112 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RecordChunk.cc
+/// \brief Implementation of the RecordChunk class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "RecordChunk.hh"
+
+#include "G4SystemOfUnits.hh"
+
+namespace RecordSchema {
+  const Column kCrossingColumns[] = {
+    { "event", kUInt32 }, { "code", kUInt8 },
+    { "x", kFloat32 }, { "y", kFloat32 }, { "z", kFloat32 },
+    { "energy", kFloat32 }, { "time", kFloat32 } };
+  const Column kCaptureColumns[] = {
+    { "event", kUInt32 },
+    { "x", kFloat32 }, { "y", kFloat32 }, { "z", kFloat32 },
+    { "time", kFloat32 }, { "gammaSum", kFloat32 } };
+  const Table kTables[kNbTables] = {
+    { "crossing", 7, kCrossingColumns },
+    { "capture",  6, kCaptureColumns } };
+
+  const Table& GetTable(G4int table) { return kTables[table]; }
+  
+  size_t TypeSize(G4int type)
+  {
+    return (type == kUInt8) ? 1 : 4;
+  }
+  
+  void AppendCrossing(RecordChunk& chunk, uint32_t event, G4int code,
+                      const G4ThreeVector& position, G4double energy,
+                      G4double time)
+  {
+    chunk.Append<uint32_t>(0, event);
+    chunk.Append<uint8_t>(1, code);
+    chunk.Append<float>(2, position.x()/m);
+    chunk.Append<float>(3, position.y()/m);
+    chunk.Append<float>(4, position.z()/m);
+    chunk.Append<float>(5, energy/MeV);
+    chunk.Append<float>(6, time/ns);
+    chunk.EndRow();
+  }
+  
+  void AppendCapture(RecordChunk& chunk, uint32_t event,
+                     const G4ThreeVector& position, G4double time,
+                     G4double gammaSum)
+  {
+    chunk.Append<uint32_t>(0, event);
+    chunk.Append<float>(1, position.x()/m);
+    chunk.Append<float>(2, position.y()/m);
+    chunk.Append<float>(3, position.z()/m);
+    chunk.Append<float>(4, time/ns);
+    chunk.Append<float>(5, gammaSum/MeV);
+    chunk.EndRow();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RecordChunk::RecordChunk(G4int table, size_t capacity)
+: fTable(table), fCapacity(capacity), fNbRows(0)
+{
+  const RecordSchema::Table& schema = RecordSchema::GetTable(table);
+  fColumns.resize(schema.fNbColumns);
+  for (G4int i=0; i<schema.fNbColumns; ++i) {
+    fColumns[i].reserve(capacity*RecordSchema::TypeSize(
+                                    schema.fColumns[i].fType));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RecordChunk::~RecordChunk()
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RecordChunk::Clear()
+{
+  // the capacity of the columns is kept
+  for (size_t i=0; i<fColumns.size(); ++i) fColumns[i].clear();
+  fNbRows = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,208 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RecordMerger.cc
+/// \brief Implementation of the RecordMerger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "RecordMerger.hh"
+#include "RecordChunk.hh"
+#include "ColumnarReader.hh"
+#include "ColumnarWriter.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+  // a block to copy from an input file to its place in the output
+  struct Copy {
+    const char* fData;
+    uint64_t    fSize;
+    uint64_t    fOffset;
+  };
+  
+  G4String Directory(const G4String& fileName)
+  {
+    size_t slash = fileName.rfind('/');
+    return slash == std::string::npos ? G4String("") 
+                                      : G4String(fileName.substr(0, slash+1));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RecordMerger::WriteManifest(const G4String& fileName,
+                                   const std::vector<Shard>& shards)
+{
+  // names relative to the manifest
+  G4String directory = Directory(fileName);
+  std::ofstream out(fileName.c_str());
+  out << "# table thread rows bytes file" << std::endl;
+  for (size_t i=0; i<shards.size(); ++i) {
+    const Shard& shard = shards[i];
+    G4String file = shard.fFile;
+    if (!directory.empty() && file.compare(0, directory.size(), directory) == 0) {
+      file = file.substr(directory.size());
+    }
+    out << RecordSchema::GetTable(shard.fTable).fName << " " << shard.fThread
+        << " " << shard.fNbRows << " " << shard.fSize << " " << file 
+        << std::endl;
+  }
+  return out.good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RecordMerger::ReadManifest(const G4String& fileName, 
+                                  std::vector<Shard>& shards)
+{
+  std::ifstream in(fileName.c_str());
+  if (!in) return false;
+  G4String directory = Directory(fileName);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream fields(line);
+    std::string table, file;
+    Shard shard;
+    if (!(fields >> table >> shard.fThread >> shard.fNbRows >> shard.fSize 
+                 >> file)) return false;
+    shard.fTable = -1;
+    for (G4int t=0; t<RecordSchema::kNbTables; ++t) {
+      if (table == RecordSchema::GetTable(t).fName) shard.fTable = t;
+    }
+    if (shard.fTable < 0) return false;
+    shard.fFile = (file[0] == '/') ? G4String(file) : directory + file;
+    shards.push_back(shard);
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RecordMerger::RecordMerger(G4int nbThreads)
+: fNbThreads(std::max(nbThreads, 1))
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RecordMerger::~RecordMerger()
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RecordMerger::Merge(const std::vector<G4String>& manifests,
+                           const G4String& stem)
+{
+  std::vector<G4String> files[RecordSchema::kNbTables];
+  for (size_t i=0; i<manifests.size(); ++i) {
+    std::vector<Shard> shards;
+    if (!ReadManifest(manifests[i], shards)) {
+      G4cout << "### RecordMerger: cannot read " << manifests[i] << G4endl;
+      return false;
+    }
+    for (size_t k=0; k<shards.size(); ++k) {
+      files[shards[k].fTable].push_back(shards[k].fFile);
+    }
+  }
+  
+  G4bool ok = true;
+  for (G4int t=0; t<RecordSchema::kNbTables; ++t) {
+    if (files[t].empty()) continue;
+    G4String output = stem + "_" + RecordSchema::GetTable(t).fName + ".h04c";
+    ok &= MergeTable(t, files[t], output);
+  }
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RecordMerger::MergeTable(G4int table, 
+                                const std::vector<G4String>& files,
+                                const G4String& output)
+{
+  const RecordSchema::Table& schema = RecordSchema::GetTable(table);
+  std::vector<ColumnarReader> readers(files.size());
+  for (size_t i=0; i<files.size(); ++i) {
+    if (!readers[i].Open(files[i]) || readers[i].GetTableName() != schema.fName) {
+      G4cout << "### RecordMerger: cannot read " << files[i] << " as " 
+             << schema.fName << " records" << G4endl;
+      return false;
+    }
+  }
+  
+  // room of all the blocks, in the order of the inputs
+  ColumnarWriter writer;
+  if (!writer.Open(output, table, ColumnarWriter::kStored)) return false;
+  std::vector<Copy> copies;
+  for (size_t i=0; i<readers.size(); ++i) {
+    const std::vector<ColumnarReader::Block>& blocks = readers[i].GetBlocks();
+    for (size_t k=0; k<blocks.size(); ++k) {
+      Copy copy;
+      copy.fData = readers[i].GetBlockData(blocks[k]);
+      copy.fSize = blocks[k].fStoredSize;
+      if (!writer.Reserve(blocks[k], copy.fOffset)) return false;
+      copies.push_back(copy);
+    }
+  }
+  writer.Flush();
+  
+  // the copies, shared out by the threads
+  G4int fd = writer.GetDescriptor();
+  std::atomic<size_t> next(0);
+  std::atomic<G4bool> ok(true);
+  std::vector<std::thread> threads;
+  G4int nbThreads = std::min(fNbThreads, std::max((G4int)copies.size(), 1));
+  for (G4int t=0; t<nbThreads; ++t) {
+    threads.push_back(std::thread([&]() {
+      for (size_t i = next++; i < copies.size() && ok; i = next++) {
+        const Copy& copy = copies[i];
+        uint64_t done = 0;
+        while (done < copy.fSize) {
+          ssize_t n = pwrite(fd, copy.fData + done, copy.fSize - done,
+                             (off_t)(copy.fOffset + done));
+          if (n <= 0) { ok = false; break; }
+          done += n;
+        }
+      }
+    }));
+  }
+  for (size_t t=0; t<threads.size(); ++t) threads[t].join();
+  
+  G4bool closed = writer.Close();
+  G4cout << " Merged " << files.size() << " " << schema.fName 
+         << " record files into " << output << ": " << writer.GetNbRows() 
+         << " rows" << G4endl;
+  return ok && closed;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,241 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RecordWriterThread.cc
+/// \brief Implementation of the RecordWriterThread class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "RecordWriterThread.hh"
+#include "ColumnarWriter.hh"
+
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+  // lane of this thread: -1 not yet given, -2 none left
+  G4ThreadLocal G4int threadLane = -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RecordWriterThread::RecordWriterThread(ColumnarWriter* writers)
+: fWriters(writers), fDepth(0), fNbLanes(0), fStop(false), fRunning(false),
+  fNbChunks(0), fNbStalls(0)
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RecordWriterThread::~RecordWriterThread()
+{
+  Stop();
+  G4int nbLanes = std::min(fNbLanes.load(), kMaxLanes);
+  for (G4int i=0; i<nbLanes; ++i) {
+    for (G4int t=0; t<RecordSchema::kNbTables; ++t) {
+      RecordChunk* chunk = 0;
+      while (fLanes[i].fFree[t].Pop(chunk)) delete chunk;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RecordWriterThread::Start(G4int depth)
+{
+  Stop();
+  fDepth = std::min(std::max(depth, 0), (G4int)kMaxDepth);
+  fNbChunks = fNbStalls = 0;
+  if (fDepth == 0) return;
+  
+  fStop = false;
+  fRunning = true;
+  fThread = std::thread(&RecordWriterThread::Loop, this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RecordWriterThread::Stop()
+{
+  if (!fThread.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(fWakeMutex);
+    fStop = true;
+  }
+  fWakeCondition.notify_all();
+  fThread.join();
+  fRunning = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RecordWriterThread::Lane* RecordWriterThread::GetLane()
+{
+  if (threadLane == -1) {
+    G4int lane = fNbLanes.fetch_add(1);
+    threadLane = lane < kMaxLanes ? lane : -2;
+  }
+  return threadLane >= 0 ? &fLanes[threadLane] : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RecordWriterThread::Write(RecordChunk* chunk, ColumnarWriter* target)
+{
+  // a target of its own is written by one thread at a time: no lock
+  if (target) target->Write(*chunk);
+  else {
+    std::lock_guard<std::mutex> lock(fWriteMutex);
+    fWriters[chunk->GetTable()].Write(*chunk);
+  }
+  chunk->Clear();
+  fNbChunks++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RecordWriterThread::Wake()
+{
+  fWakeCondition.notify_one();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RecordChunk* RecordWriterThread::Push(RecordChunk* chunk, 
+                                      ColumnarWriter* target)
+{
+  Lane* lane = fRunning ? GetLane() : 0;
+  if (!lane) {
+    Write(chunk, target);
+    return chunk;
+  }
+  
+  // the chunk belongs to the writer thread once pushed
+  G4int table = chunk->GetTable();
+  size_t capacity = chunk->GetCapacity();
+  
+  // wait while the lane is full: the writer thread is behind
+  Item item;
+  item.fChunk = chunk;
+  item.fTarget = target;
+  G4bool stalled = false;
+  while (lane->fPushed - lane->fWritten.load(std::memory_order_acquire) 
+                                                    >= (uint64_t)fDepth 
+         || !lane->fFull.Push(item)) {
+    if (!stalled) fNbStalls++;
+    stalled = true;
+    Wake();
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  lane->fPushed++;
+  Wake();
+  
+  // a chunk written by the writer thread, or a new one
+  RecordChunk* empty = 0;
+  while (lane->fFree[table].Pop(empty)) {
+    if (empty->GetCapacity() == capacity) return empty;
+    delete empty;
+  }
+  return new RecordChunk(table, capacity);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RecordWriterThread::Flush()
+{
+  Lane* lane = fRunning ? GetLane() : 0;
+  if (!lane) {
+    std::lock_guard<std::mutex> lock(fWriteMutex);
+    for (G4int t=0; t<RecordSchema::kNbTables; ++t) fWriters[t].Flush();
+    return;
+  }
+  
+  uint64_t target = lane->fPushed;
+  lane->fFlushRequest.store(target, std::memory_order_release);
+  Wake();
+  while (lane->fFlushed.load(std::memory_order_acquire) < target) {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RecordWriterThread::Loop()
+{
+  std::unique_lock<std::mutex> lock(fWakeMutex);
+  for (;;) {
+    // after a stop, drain until the lanes are empty
+    G4bool stop = fStop;
+    lock.unlock();
+    size_t nbWritten = Drain();
+    lock.lock();
+    if (nbWritten > 0) continue;
+    if (stop) break;
+    fWakeCondition.wait_for(lock, std::chrono::milliseconds(2));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+size_t RecordWriterThread::Drain()
+{
+  size_t nbWritten = 0;
+  G4bool flush = false;
+  G4int nbLanes = std::min(fNbLanes.load(), kMaxLanes);
+  for (G4int i=0; i<nbLanes; ++i) {
+    Lane& lane = fLanes[i];
+    Item item;
+    while (lane.fFull.Pop(item)) {
+      RecordChunk* chunk = item.fChunk;
+      Write(chunk, item.fTarget);
+      if (!lane.fFree[chunk->GetTable()].Push(chunk)) delete chunk;
+      lane.fWritten.fetch_add(1, std::memory_order_release);
+      nbWritten++;
+    }
+    uint64_t request = lane.fFlushRequest.load(std::memory_order_acquire);
+    flush |= request > lane.fFlushed.load(std::memory_order_relaxed);
+  }
+  if (!flush) return nbWritten;
+  
+  // the chunks of the requests are written: flush, then answer (the 
+  // files of a thread are flushed by itself, see Records::FlushThread)
+  {
+    std::lock_guard<std::mutex> lock(fWriteMutex);
+    for (G4int t=0; t<RecordSchema::kNbTables; ++t) fWriters[t].Flush();
+  }
+  for (G4int i=0; i<nbLanes; ++i) {
+    Lane& lane = fLanes[i];
+    uint64_t request = lane.fFlushRequest.load(std::memory_order_acquire);
+    if (lane.fWritten.load(std::memory_order_acquire) >= request) {
+      lane.fFlushed.store(request, std::memory_order_release);
+    }
+  }
+  return nbWritten;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,364 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Records.cc
+/// \brief Implementation of the Records class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "Records.hh"
+#include "RecordsMessenger.hh"
+#include "Campaign.hh"
+#include "Checkpoint.hh"
+#include "RandomStreams.hh"
+
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <thread>
+
+namespace {
+  // chunks, event and shards of this thread
+  struct ThreadRecords {
+    ThreadRecords() : fEvent(0), fShardRun(-1)
+    { 
+      for (G4int i=0; i<RecordSchema::kNbTables; ++i) {
+        fChunks[i] = 0;
+        fShards[i] = 0;
+        fShardFailed[i] = false;
+      }
+    }
+    RecordChunk*    fChunks[RecordSchema::kNbTables];
+    uint32_t        fEvent;
+    ColumnarWriter* fShards[RecordSchema::kNbTables];
+    G4bool          fShardFailed[RecordSchema::kNbTables];
+    G4int           fShardRun;
+  };
+  G4ThreadLocal ThreadRecords* threadRecords = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Records* Records::Instance()
+{
+  static Records instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Records::Records()
+: fEnabled(false), fFileName("Hadr04"), fChunkRows(65536), 
+  fCodec(ColumnarWriter::kStored), fQueueDepth(8), fShards(false), 
+  fMergeShards(false), fActive(false), fRunCount(0), 
+  fWriterThread(fWriters), fMessenger(0)
+{
+  fMessenger = new RecordsMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Records::~Records()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Records::BeginOfRun()
+{
+  fActive = false;
+  if (!fEnabled) return;
+  
+  if (fCodec == ColumnarWriter::kZlib && !ColumnarWriter::HasZlib()) {
+    G4cout << "\n Records: built without zlib, the blocks are stored"
+           << G4endl;
+  }
+  Campaign* campaign = Campaign::Instance();
+  Checkpoint* checkpoint = Checkpoint::Instance();
+  fActive = true;
+  fRunCount++;
+  for (G4int i=0; i<RecordSchema::kNbTables; ++i) {
+    G4String name = fFileName + "_" + RecordSchema::GetTable(i).fName 
+                  + ".h04c";
+    fNames[i] = checkpoint->OutputName(campaign->OutputName(name, ".h04c"));
+    // shards: opened by each thread at its first record
+    if (!fShards) fActive &= fWriters[i].Open(fNames[i], i, fCodec);
+  }
+  if (!fActive) {
+    // no records for this run: the files already open are closed
+    for (G4int i=0; i<RecordSchema::kNbTables; ++i) {
+      if (!fWriters[i].IsOpen()) continue;
+      fWriters[i].Close();
+      std::remove(fWriters[i].GetFileName().c_str());
+    }
+    return;
+  }
+  fManifestName = 
+    checkpoint->OutputName(campaign->OutputName(fFileName + ".h04m", ".h04m"));
+  fWriterThread.Start(fQueueDepth);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Records::EndOfRun()
+{
+  if (!fActive) return;
+  fActive = false;
+  
+  // all threads are done: write what is still queued
+  fWriterThread.Stop();
+  
+  G4cout << "\n Records: " << fWriterThread.GetNbChunks() << " chunks";
+  if (fQueueDepth > 0) {
+    G4cout << " through the writer thread, " << fWriterThread.GetNbStalls()
+           << " waits for a full queue";
+  }
+  G4cout << G4endl;
+  
+  std::vector<RecordMerger::Shard> shards;
+  if (fShards) {
+    CloseShards(shards);
+    if (fMergeShards) MergeShards(shards);
+  } 
+  else {
+    for (G4int i=0; i<RecordSchema::kNbTables; ++i) {
+      RecordMerger::Shard shard;
+      shard.fTable  = i;
+      shard.fNbRows = fWriters[i].GetNbRows();
+      fWriters[i].Close();
+      shard.fSize   = fWriters[i].GetFileSize();
+      shard.fFile   = fWriters[i].GetFileName();
+      shards.push_back(shard);
+    }
+  }
+  for (size_t i=0; i<shards.size(); ++i) {
+    G4cout << "   " << shards[i].fFile << ": " << shards[i].fNbRows 
+           << " rows, " << shards[i].fSize << " bytes" << G4endl;
+  }
+  if (!RecordMerger::WriteManifest(fManifestName, shards)) {
+    G4cout << "### Records: cannot write " << fManifestName << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Records::CloseShards(std::vector<RecordMerger::Shard>& shards)
+{
+  // table by table, thread by thread: the same manifest for the same run
+  std::sort(fShardWriters.begin(), fShardWriters.end(),
+            [](const ShardWriter& a, const ShardWriter& b) {
+              return a.fTable != b.fTable ? a.fTable < b.fTable 
+                                          : a.fThread < b.fThread; });
+  for (size_t i=0; i<fShardWriters.size(); ++i) {
+    ColumnarWriter* writer = fShardWriters[i].fWriter;
+    RecordMerger::Shard shard;
+    shard.fTable  = fShardWriters[i].fTable;
+    shard.fThread = fShardWriters[i].fThread;
+    shard.fNbRows = writer->GetNbRows();
+    writer->Close();
+    shard.fSize   = writer->GetFileSize();
+    shard.fFile   = writer->GetFileName();
+    shards.push_back(shard);
+    delete writer;
+  }
+  fShardWriters.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Records::MergeShards(std::vector<RecordMerger::Shard>& shards)
+{
+  // one file per table, as without shards; the shards are removed once 
+  // all the tables are merged, and kept in the manifest otherwise
+  G4int nbThreads = std::max(1, (G4int)std::thread::hardware_concurrency());
+  RecordMerger merger(std::min(nbThreads, (G4int)shards.size()));
+  std::vector<RecordMerger::Shard> merged;
+  for (G4int t=0; t<RecordSchema::kNbTables; ++t) {
+    std::vector<G4String> files;
+    RecordMerger::Shard total;
+    total.fTable = t;
+    total.fFile  = fNames[t];
+    for (size_t i=0; i<shards.size(); ++i) {
+      if (shards[i].fTable == t) files.push_back(shards[i].fFile);
+    }
+    if (files.empty()) continue;
+    if (!merger.MergeTable(t, files, fNames[t])) {
+      G4cout << "### Records: shards of " << fNames[t] << " not merged,"
+             << " the shards are kept" << G4endl;
+      for (size_t i=0; i<merged.size(); ++i) {
+        std::remove(merged[i].fFile.c_str());
+      }
+      std::remove(fNames[t].c_str());
+      return;
+    }
+    for (size_t i=0; i<shards.size(); ++i) {
+      if (shards[i].fTable == t) total.fNbRows += shards[i].fNbRows;
+    }
+    std::FILE* file = std::fopen(fNames[t].c_str(), "rb");
+    if (file) {
+      std::fseek(file, 0, SEEK_END);
+      total.fSize = std::ftell(file);
+      std::fclose(file);
+    }
+    merged.push_back(total);
+  }
+  for (size_t i=0; i<shards.size(); ++i) std::remove(shards[i].fFile.c_str());
+  shards.swap(merged);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Records::BeginOfEvent(G4int eventID)
+{
+  if (!fActive) return;
+  if (!threadRecords) threadRecords = new ThreadRecords;
+  RandomStreams* streams = RandomStreams::Instance();
+  threadRecords->fEvent = streams->IsCounterBased() ?
+    (uint32_t)streams->GetStreamIndex(eventID) : (uint32_t)eventID;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RecordChunk*& Records::GetChunk(G4int table)
+{
+  RecordChunk*& chunk = threadRecords->fChunks[table];
+  if (chunk && (G4int)chunk->GetCapacity() != fChunkRows) {
+    Flush(chunk);
+    delete chunk;
+    chunk = 0;
+  }
+  if (!chunk) chunk = new RecordChunk(table, fChunkRows);
+  return chunk;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarWriter* Records::GetShard(G4int table)
+{
+  // the shards of an earlier run are closed
+  if (threadRecords->fShardRun != fRunCount) {
+    for (G4int i=0; i<RecordSchema::kNbTables; ++i) {
+      threadRecords->fShards[i] = 0;
+      threadRecords->fShardFailed[i] = false;
+    }
+    threadRecords->fShardRun = fRunCount;
+  }
+  ColumnarWriter*& shard = threadRecords->fShards[table];
+  if (shard || threadRecords->fShardFailed[table]) return shard;
+  
+  G4int thread = std::max(0, G4Threading::G4GetThreadId());
+  std::ostringstream name;
+  name << fNames[table].substr(0, fNames[table].rfind('.')) 
+       << "_t" << thread << ".h04c";
+  shard = new ColumnarWriter;
+  if (!shard->Open(name.str(), table, fCodec)) {
+    // not in the manifest; the rows of this table and thread are dropped
+    delete shard;
+    shard = 0;
+    threadRecords->fShardFailed[table] = true;
+    return 0;
+  }
+  
+  ShardWriter entry;
+  entry.fTable  = table;
+  entry.fThread = thread;
+  entry.fWriter = shard;
+  std::lock_guard<std::mutex> lock(fShardMutex);
+  fShardWriters.push_back(entry);
+  return shard;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Records::AddCrossing(G4int code, const G4ThreeVector& position, 
+                          G4double energy, G4double time)
+{
+  if (!fActive) return;
+  RecordChunk*& chunk = GetChunk(RecordSchema::kCrossing);
+  RecordSchema::AppendCrossing(*chunk, threadRecords->fEvent, code, position,
+                               energy, time);
+  if (chunk->IsFull()) Flush(chunk);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Records::AddCapture(const G4ThreeVector& position, G4double time, 
+                         G4double gammaSum)
+{
+  if (!fActive) return;
+  RecordChunk*& chunk = GetChunk(RecordSchema::kCapture);
+  RecordSchema::AppendCapture(*chunk, threadRecords->fEvent, position, time,
+                              gammaSum);
+  if (chunk->IsFull()) Flush(chunk);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Records::Flush(RecordChunk*& chunk)
+{
+  // the chunk is replaced by an empty one
+  if (chunk->GetNbRows() == 0) return;
+  ColumnarWriter* target = 0;
+  if (fShards) {
+    target = GetShard(chunk->GetTable());
+    if (!target) { chunk->Clear(); return; }
+  }
+  chunk = fWriterThread.Push(chunk, target);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Records::FlushThread()
+{
+  if (!fActive || !threadRecords) return;
+  for (G4int i=0; i<RecordSchema::kNbTables; ++i) {
+    if (threadRecords->fChunks[i]) Flush(threadRecords->fChunks[i]);
+  }
+  fWriterThread.Flush();
+  
+  // the writer thread is done with the shards of this thread
+  if (fShards && threadRecords->fShardRun == fRunCount) {
+    for (G4int i=0; i<RecordSchema::kNbTables; ++i) {
+      if (threadRecords->fShards[i]) threadRecords->fShards[i]->Flush();
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Records::EndOfThreadRun()
+{
+  if (!fActive || !threadRecords) return;
+  for (G4int i=0; i<RecordSchema::kNbTables; ++i) {
+    if (threadRecords->fChunks[i]) Flush(threadRecords->fChunks[i]);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
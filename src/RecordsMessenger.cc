@@ -0,0 +1,146 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RecordsMessenger.cc
+/// \brief Implementation of the RecordsMessenger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "RecordsMessenger.hh"
+
+#include "Records.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RecordsMessenger::RecordsMessenger(Records* records)
+:G4UImessenger(),fRecords(records),
+ fRecordsDir(0), fEnableCmd(0), fFileCmd(0), fChunkRowsCmd(0), 
+ fCompressionCmd(0), fQueueDepthCmd(0), fShardsCmd(0), fMergeShardsCmd(0)
+{ 
+  G4bool broadcast = false;
+  fRecordsDir = new G4UIdirectory("/testhadr/records/",broadcast);
+  fRecordsDir->SetGuidance("columnar files of crossing and capture records");
+  
+  fEnableCmd = new G4UIcmdWithABool("/testhadr/records/enable",this);
+  fEnableCmd->SetGuidance("write the records at the next runs");
+  fEnableCmd->SetParameterName("flag",true);
+  fEnableCmd->SetDefaultValue(true);
+  fEnableCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fEnableCmd->SetToBeBroadcasted(false);
+  
+  fFileCmd = new G4UIcmdWithAString("/testhadr/records/file",this);
+  fFileCmd->SetGuidance("name of the files, without table and extension");
+  fFileCmd->SetParameterName("name",false);
+  fFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fFileCmd->SetToBeBroadcasted(false);
+  
+  fChunkRowsCmd = new G4UIcmdWithAnInteger("/testhadr/records/chunkRows",this);
+  fChunkRowsCmd->SetGuidance("rows per block of the columns");
+  fChunkRowsCmd->SetParameterName("n",false);
+  fChunkRowsCmd->SetRange("n>0");
+  fChunkRowsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fChunkRowsCmd->SetToBeBroadcasted(false);
+  
+  fCompressionCmd = new G4UIcmdWithAString("/testhadr/records/compression",this);
+  fCompressionCmd->SetGuidance("none: blocks readable in place (mmap), default;");
+  fCompressionCmd->SetGuidance("zlib: shuffled and deflated blocks");
+  fCompressionCmd->SetParameterName("codec",false);
+  fCompressionCmd->SetCandidates("none zlib");
+  fCompressionCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fCompressionCmd->SetToBeBroadcasted(false);
+  
+  fQueueDepthCmd = new G4UIcmdWithAnInteger("/testhadr/records/queueDepth",this);
+  fQueueDepthCmd->SetGuidance("full chunks queued per thread to the writer thread;");
+  fQueueDepthCmd->SetGuidance("  0: no writer thread, chunks written by the event loop");
+  fQueueDepthCmd->SetParameterName("n",false);
+  fQueueDepthCmd->SetRange("n>=0 && n<=64");
+  fQueueDepthCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fQueueDepthCmd->SetToBeBroadcasted(false);
+  
+  fShardsCmd = new G4UIcmdWithABool("/testhadr/records/shards",this);
+  fShardsCmd->SetGuidance("files of each thread, <file>_<table>_t<thread>.h04c");
+  fShardsCmd->SetParameterName("flag",true);
+  fShardsCmd->SetDefaultValue(true);
+  fShardsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fShardsCmd->SetToBeBroadcasted(false);
+  
+  fMergeShardsCmd = new G4UIcmdWithABool("/testhadr/records/mergeShards",this);
+  fMergeShardsCmd->SetGuidance("merge the shards into one file per table");
+  fMergeShardsCmd->SetGuidance("  at the end of the run, then remove them");
+  fMergeShardsCmd->SetParameterName("flag",true);
+  fMergeShardsCmd->SetDefaultValue(true);
+  fMergeShardsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fMergeShardsCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RecordsMessenger::~RecordsMessenger()
+{
+  delete fEnableCmd;
+  delete fFileCmd;
+  delete fChunkRowsCmd;
+  delete fCompressionCmd;
+  delete fQueueDepthCmd;
+  delete fShardsCmd;
+  delete fMergeShardsCmd;
+  delete fRecordsDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RecordsMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{   
+  if (command == fEnableCmd)
+   {fRecords->SetEnabled(fEnableCmd->GetNewBoolValue(newValue));}
+   
+  if (command == fFileCmd)
+   {fRecords->SetFileName(newValue);}
+   
+  if (command == fChunkRowsCmd)
+   {fRecords->SetChunkRows(fChunkRowsCmd->GetNewIntValue(newValue));}
+   
+  if (command == fCompressionCmd)
+   {fRecords->SetCodec(newValue == "zlib" ? ColumnarWriter::kZlib 
+                                          : ColumnarWriter::kStored);}
+   
+  if (command == fQueueDepthCmd)
+   {fRecords->SetQueueDepth(fQueueDepthCmd->GetNewIntValue(newValue));}
+   
+  if (command == fShardsCmd)
+   {fRecords->SetShards(fShardsCmd->GetNewBoolValue(newValue));}
+   
+  if (command == fMergeShardsCmd)
+   {fRecords->SetMergeShards(fMergeShardsCmd->GetNewBoolValue(newValue));}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
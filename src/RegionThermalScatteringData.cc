@@ -0,0 +1,108 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RegionThermalScatteringData.cc
+/// \brief Implementation of the RegionThermalScatteringData class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "RegionThermalScatteringData.hh"
+
+#include "G4HadronicInteraction.hh"
+#include "G4Material.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4SystemOfUnits.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RegionThermalScatteringData::RegionThermalScatteringData(
+                                    const G4String& region,
+                                    G4HadronicInteraction* freeGas,
+                                    G4HadronicInteraction* thermal)
+: G4ParticleHPThermalScatteringData(), fRegionName(region),
+  fFreeGas(freeGas), fThermal(thermal)
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RegionThermalScatteringData::~RegionThermalScatteringData()
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RegionThermalScatteringData::IsIsoApplicable(
+                                    const G4DynamicParticle* particle,
+                                    G4int Z, G4int A,
+                                    const G4Element* element,
+                                    const G4Material* material)
+{
+  size_t index = material->GetIndex();
+  if (index >= fInRegion.size() || !fInRegion[index]) return false;
+  return G4ParticleHPThermalScatteringData::IsIsoApplicable(particle, Z, A,
+                                                           element, material);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RegionThermalScatteringData::BuildPhysicsTable(
+                                    const G4ParticleDefinition& particle)
+{
+  G4ParticleHPThermalScatteringData::BuildPhysicsTable(particle);
+
+  // the material lists of the regions are up to date at this stage
+  const G4MaterialTable* materials = G4Material::GetMaterialTable();
+  fInRegion.assign(materials->size(), false);
+  G4Region* region
+    = G4RegionStore::GetInstance()->GetRegion(fRegionName, false);
+  if (!region) {
+    G4cout << "### RegionThermalScatteringData: region " << fRegionName
+           << " not found; thermal scattering is disabled" << G4endl;
+  } else {
+    std::vector<G4Material*>::const_iterator it
+      = region->GetMaterialIterator();
+    for (size_t i=0; i<region->GetNumberOfMaterials(); ++i, ++it) {
+      fInRegion[(*it)->GetIndex()] = true;
+    }
+  }
+
+  const G4double thermalLimit = 4*eV;
+  for (size_t i=0; i<materials->size(); ++i) {
+    const G4Material* material = (*materials)[i];
+    if (fInRegion[i]) {
+      fFreeGas->SetMinEnergy(thermalLimit, material);
+      fThermal->SetMinEnergy(0., material);
+      fThermal->SetMaxEnergy(thermalLimit, material);
+    } else {
+      fFreeGas->SetMinEnergy(0., material);
+      fThermal->SetMinEnergy(0., material);
+      fThermal->SetMaxEnergy(0., material);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -34,9 +34,38 @@
 #include "DetectorConstruction.hh"
 #include "PrimaryGeneratorAction.hh"
 #include "HistoManager.hh"
+#include "RunSummary.hh"
+#include "Campaign.hh"
+#include "SlowEvents.hh"
+#include "Watchdog.hh"
 
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+namespace {
+  // event time histogram: 8 bins per decade from 1 us to 10^4 s
+  const G4int    kTimeBinsPerDecade = 8;
+  const G4int    kNbTimeBins = 80;
+  const G4double kMinEventTime = 1.e-6;
+  
+  // worker run waiting for a partner in the pairwise reduction
+  G4Mutex reduceMutex = G4MUTEX_INITIALIZER;
+  Run*    pendingRun  = 0;
+  
+  // events of a run logged by the watchdog
+  const size_t kMaxWatchdogEvents = 100;
+  
+  // order of the slowest events
+  G4bool SlowerEvent(const Run::EventCost& a, const Run::EventCost& b)
+  { return a.fTime > b.fTime; }
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -45,8 +74,21 @@ Run::Run(DetectorConstruction* det)
   fDetector(det), fParticle(0), fEkin(0.),
   fNbStep1(0), fNbStep2(0),
   fTrackLen1(0.), fTrackLen2(0.),
-  fTime1(0.),fTime2(0.)
-{ }
+  fTime1(0.),fTime2(0.),
+  fRunStart(0.), fNbSteps(0), fNbSecondaries(0),
+  fNbReduced(1), fMergeDepth(0), fMergeTime(0.), fWriteTime(0.), 
+  fReducedAt(0.)
+{
+  fRunStart = WallClock();
+  fEventTimeHisto.assign(kNbTimeBins, 0);
+  fKilledTracks.assign(Watchdog::kNbBreaches, 0);
+  fKilledWeight.assign(Watchdog::kNbBreaches, 0.);
+  // the master of an MT run processes no event
+  if (G4Threading::IsWorkerThread() || 
+      !G4Threading::IsMultithreadedApplication()) {
+    fThreadLoads.push_back(ThreadLoad(G4Threading::G4GetThreadId()));
+  }
+}
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 Run::~Run()
@@ -107,8 +149,86 @@ void Run::SumTrackLength(G4int nstep1, G4int nstep2,
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+G4double Run::WallClock()
+{
+  return std::chrono::duration<G4double>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::AddEventTime(G4double start, G4double end)
+{
+  if (fThreadLoads.empty()) return;
+  ThreadLoad& load = fThreadLoads.front();
+  G4double duration = end - start;
+  if (load.fNbEvents == 0) load.fFirst = start;
+  load.fNbEvents++;
+  load.fBusy += duration;
+  load.fLast = end;
+  if (duration > load.fMaxEvent) load.fMaxEvent = duration;
+
+  G4int bin = (duration > kMinEventTime) ?
+    (G4int)(kTimeBinsPerDecade*std::log10(duration/kMinEventTime)) : 0;
+  fEventTimeHisto[std::min(bin, kNbTimeBins-1)]++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Run::AddEventCost(G4double time, G4long nbSteps, G4long nbSecondaries)
+{
+  fNbSteps       += nbSteps;
+  fNbSecondaries += nbSecondaries;
+  
+  // fSlowEvents is a heap, the fastest of the slowest events on top
+  size_t nbSlowest = SlowEvents::Instance()->GetNbSlowest();
+  if (nbSlowest == 0) return false;
+  return fSlowEvents.size() < nbSlowest || time > fSlowEvents.front().fTime;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::AddSlowEvent(const EventCost& cost)
+{
+  fSlowEvents.push_back(cost);
+  std::push_heap(fSlowEvents.begin(), fSlowEvents.end(), SlowerEvent);
+  KeepSlowest(SlowEvents::Instance()->GetNbSlowest());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::KeepSlowest(size_t nbSlowest)
+{
+  while (fSlowEvents.size() > nbSlowest) {
+    std::pop_heap(fSlowEvents.begin(), fSlowEvents.end(), SlowerEvent);
+    fSlowEvents.pop_back();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::AddKilledTrack(G4int breach, G4double weight)
+{
+  fKilledTracks[breach]++;
+  fKilledWeight[breach] += weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::AddWatchdogEvent(const EventCost& cost)
+{
+  if (fWatchdogEvents.size() < kMaxWatchdogEvents) {
+    fWatchdogEvents.push_back(cost);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void Run::Merge(const G4Run* run)
 {
+  // called by the kernel under a global lock, one worker after the other:
+  // only the primary info and the event count; the summaries are summed
+  // by Reduce() without holding the lock.
   const Run* localRun = static_cast<const Run*>(run);
   
   //primary particle info
@@ -116,6 +236,13 @@ void Run::Merge(const G4Run* run)
   fParticle = localRun->fParticle;
   fEkin     = localRun->fEkin;
   
+  G4Run::Merge(run); 
+} 
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::MergeSummaries(const Run* localRun)
+{
   // accumulate sums
   //
   fNbStep1   += localRun->fNbStep1;
@@ -126,47 +253,113 @@ void Run::Merge(const G4Run* run)
   fTime2     += localRun->fTime2;
   
   //map: processes count
+  //  (one lookup per entry: the hint of lower_bound serves the insertion)
   std::map<G4String,G4int>::const_iterator itp;
   for ( itp = localRun->fProcCounter.begin();
         itp != localRun->fProcCounter.end(); ++itp ) {
-
-    G4String procName = itp->first;
-    G4int localCount = itp->second;
-    if ( fProcCounter.find(procName) == fProcCounter.end()) {
-      fProcCounter[procName] = localCount;
+    std::map<G4String,G4int>::iterator it 
+      = fProcCounter.lower_bound(itp->first);
+    if (it != fProcCounter.end() && it->first == itp->first) {
+      it->second += itp->second;
     }
     else {
-      fProcCounter[procName] += localCount;
-    }  
+      fProcCounter.insert(it, *itp);
+    }
   }
    
   //map: created particles count         
   std::map<G4String,ParticleData>::const_iterator itn;
   for (itn = localRun->fParticleDataMap.begin(); 
        itn != localRun->fParticleDataMap.end(); ++itn) {
-    
-    G4String name = itn->first;
-    const ParticleData& localData = itn->second;   
-    if ( fParticleDataMap.find(name) == fParticleDataMap.end()) {
-      fParticleDataMap[name]
-       = ParticleData(localData.fCount, 
-                      localData.fEmean, 
-                      localData.fEmin, 
-                      localData.fEmax);
-    }
-    else {
-      ParticleData& data = fParticleDataMap[name];   
+    std::map<G4String,ParticleData>::iterator it
+      = fParticleDataMap.lower_bound(itn->first);
+    if (it != fParticleDataMap.end() && it->first == itn->first) {
+      const ParticleData& localData = itn->second;   
+      ParticleData& data = it->second;   
       data.fCount += localData.fCount;
       data.fEmean += localData.fEmean;
-      G4double emin = localData.fEmin;
-      if (emin < data.fEmin) data.fEmin = emin;
-      G4double emax = localData.fEmax;
-      if (emax > data.fEmax) data.fEmax = emax; 
-    }   
+      if (localData.fEmin < data.fEmin) data.fEmin = localData.fEmin;
+      if (localData.fEmax > data.fEmax) data.fEmax = localData.fEmax;
+    }
+    else {
+      fParticleDataMap.insert(it, *itn);
+    }
   }
 
-  G4Run::Merge(run); 
-} 
+  //thread loads
+  fThreadLoads.insert(fThreadLoads.end(), localRun->fThreadLoads.begin(),
+                      localRun->fThreadLoads.end());
+  for (G4int i=0; i<kNbTimeBins; ++i) {
+    fEventTimeHisto[i] += localRun->fEventTimeHisto[i];
+  }
+  
+  //event costs
+  fNbSteps       += localRun->fNbSteps;
+  fNbSecondaries += localRun->fNbSecondaries;
+  fSlowEvents.insert(fSlowEvents.end(), localRun->fSlowEvents.begin(),
+                     localRun->fSlowEvents.end());
+  std::make_heap(fSlowEvents.begin(), fSlowEvents.end(), SlowerEvent);
+  KeepSlowest(SlowEvents::Instance()->GetNbSlowest());
+  
+  //watchdog
+  for (G4int i=0; i<Watchdog::kNbBreaches; ++i) {
+    fKilledTracks[i] += localRun->fKilledTracks[i];
+    fKilledWeight[i] += localRun->fKilledWeight[i];
+  }
+  size_t nbEvents = std::min(localRun->fWatchdogEvents.size(),
+                       kMaxWatchdogEvents - fWatchdogEvents.size());
+  fWatchdogEvents.insert(fWatchdogEvents.end(), 
+                         localRun->fWatchdogEvents.begin(),
+                         localRun->fWatchdogEvents.begin() + nbEvents);
+  
+  //reduction statistics
+  fNbReduced  += localRun->fNbReduced;
+  fMergeDepth  = std::max(fMergeDepth, localRun->fMergeDepth) + 1;
+  fMergeTime  += localRun->fMergeTime;
+  fWriteTime  += localRun->fWriteTime;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::Reduce()
+{
+  // Worker side, at the end of its event loop. As long as another worker 
+  // run is waiting, take it and sum it into this one outside the lock; 
+  // otherwise leave this run waiting. Workers finishing early thus merge 
+  // while the others are still running, and at most one run is waiting:
+  // after the last worker, it holds the sum of all of them.
+  G4AutoLock lock(&reduceMutex);
+  while (pendingRun) {
+    Run* other = pendingRun;
+    pendingRun = 0;
+    lock.unlock();
+    G4double start = WallClock();
+    MergeSummaries(other);
+    fMergeTime += WallClock() - start;
+    lock.lock();
+  }
+  fReducedAt = WallClock();
+  pendingRun = this;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::CollectReduced()
+{
+  // Master side, after all workers have ended their event loop
+  G4AutoLock lock(&reduceMutex);
+  Run* reduced = pendingRun;
+  pendingRun = 0;
+  lock.unlock();
+  if (!reduced) return;
+  
+  G4double start = WallClock();
+  fNbReduced = 0;
+  MergeSummaries(reduced);
+  fMergeDepth = reduced->fMergeDepth;
+  fMergeTime += WallClock() - start;
+  fReducedAt  = reduced->fReducedAt;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -256,6 +449,18 @@ void Run::EndOfRun()
   ////G4double factor = 1./numberOfEvent;
   ////analysisManager->ScaleH1(3,factor);
            
+  //load balance between threads, merge of their results
+  PrintThreadLoads();
+  PrintEventCosts();
+  PrintWatchdog();
+  PrintMergeStatistics();
+  
+  //process of a campaign: counters to be merged with the other processes
+  Campaign* campaign = Campaign::Instance();
+  if (campaign->IsProcess()) {
+    WriteSummary(campaign->OutputName("Hadr04.summary", ".summary"));
+  }
+           
   //remove all contents in fProcCounter, fCount 
   fProcCounter.clear();
   fParticleDataMap.clear();
@@ -265,3 +470,221 @@ void Run::EndOfRun()
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::FillSummary(RunSummary& summary) const
+{
+  summary.fNbEvents  = numberOfEvent;
+  summary.fPrimary   = fParticle ? fParticle->GetParticleName() : "none";
+  summary.fEkin      = fEkin;
+  summary.fNbStep1   = fNbStep1;   summary.fNbStep2   = fNbStep2;
+  summary.fTrackLen1 = fTrackLen1; summary.fTrackLen2 = fTrackLen2;
+  summary.fTime1     = fTime1;     summary.fTime2     = fTime2;
+  summary.fProcCounter = fProcCounter;
+  summary.fParticleDataMap.clear();
+  std::map<G4String,ParticleData>::const_iterator itn;
+  for (itn = fParticleDataMap.begin(); itn != fParticleDataMap.end(); ++itn) {
+    const ParticleData& data = itn->second;
+    summary.fParticleDataMap[itn->first] = RunSummary::ParticleData(
+                   data.fCount, data.fEmean, data.fEmin, data.fEmax);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::AddSummary(const RunSummary& summary)
+{
+  // e.g. events of a previous session, restored from a checkpoint
+  numberOfEvent += summary.fNbEvents;
+  fNbStep1   += summary.fNbStep1;   fNbStep2   += summary.fNbStep2;
+  fTrackLen1 += summary.fTrackLen1; fTrackLen2 += summary.fTrackLen2;
+  fTime1     += summary.fTime1;     fTime2     += summary.fTime2;
+  
+  std::map<G4String,G4int>::const_iterator itp;
+  for (itp = summary.fProcCounter.begin(); 
+       itp != summary.fProcCounter.end(); ++itp) {
+    fProcCounter[itp->first] += itp->second;
+  }
+  
+  std::map<G4String,RunSummary::ParticleData>::const_iterator itn;
+  for (itn = summary.fParticleDataMap.begin(); 
+       itn != summary.fParticleDataMap.end(); ++itn) {
+    const RunSummary::ParticleData& other = itn->second;
+    std::map<G4String,ParticleData>::iterator it 
+      = fParticleDataMap.find(itn->first);
+    if (it == fParticleDataMap.end()) {
+      fParticleDataMap[itn->first] 
+        = ParticleData(other.fCount, other.fEsum, other.fEmin, other.fEmax);
+      continue;
+    }
+    ParticleData& data = it->second;
+    data.fCount += other.fCount;
+    data.fEmean += other.fEsum;
+    if (other.fEmin < data.fEmin) data.fEmin = other.fEmin;
+    if (other.fEmax > data.fEmax) data.fEmax = other.fEmax;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Run::WriteSummary(const G4String& fileName) const
+{
+  RunSummary summary;
+  FillSummary(summary);
+  return summary.Write(fileName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::CountNtupleRow(G4int id)
+{
+  if (id >= (G4int)fNtupleRows.size()) fNtupleRows.resize(id+1, 0);
+  fNtupleRows[id]++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::PrintThreadLoads()
+{
+  if (fThreadLoads.empty()) return;
+  
+  G4double runEnd = WallClock();
+  G4double wall = runEnd - fRunStart;
+  G4double busy = 0., firstEnd = runEnd, lastEnd = 0., maxEvent = 0.;
+  G4int nbEvents = 0;
+  std::sort(fThreadLoads.begin(), fThreadLoads.end(),
+            [](const ThreadLoad& a, const ThreadLoad& b)
+            { return a.fThread < b.fThread; });
+            
+  G4int prec = G4cout.precision(4);
+  G4cout << "\n Load balance (wall clock " << wall 
+         << " s):\n   thread  events   busy (s)   idle (s)  done at (s)"
+         << G4endl;
+  for (size_t i=0; i<fThreadLoads.size(); ++i) {
+    const ThreadLoad& load = fThreadLoads[i];
+    G4double doneAt = (load.fNbEvents > 0) ? load.fLast - fRunStart : 0.;
+    G4cout << "  " << std::setw(7) << load.fThread
+           << std::setw(8) << load.fNbEvents
+           << std::setw(11) << load.fBusy
+           << std::setw(11) << wall - load.fBusy
+           << std::setw(13) << doneAt << G4endl;
+    busy += load.fBusy;
+    nbEvents += load.fNbEvents;
+    if (load.fMaxEvent > maxEvent) maxEvent = load.fMaxEvent;
+    if (load.fNbEvents > 0) {
+      firstEnd = std::min(firstEnd, load.fLast);
+      lastEnd  = std::max(lastEnd, load.fLast);
+    }
+  }
+  if (nbEvents == 0) { G4cout.precision(prec); return; }
+  
+  // quantiles of the event time, from the upper edge of the bins
+  G4double quantile[2] = { 0.5, 0.99 }, value[2] = { 0., 0. };
+  for (G4int q=0; q<2; ++q) {
+    G4int sum = 0;
+    for (G4int i=0; i<kNbTimeBins; ++i) {
+      sum += fEventTimeHisto[i];
+      if (sum >= quantile[q]*nbEvents) {
+        value[q] = kMinEventTime*std::pow(10., (i+1.)/kTimeBinsPerDecade);
+        break;
+      }
+    }
+  }
+  
+  G4double utilization = busy/(wall*fThreadLoads.size());
+  G4cout << "   core utilization = " << 100.*utilization << " %"
+         << "   tail (first to last thread done) = " << lastEnd - firstEnd
+         << " s" 
+         << "\n   event time: mean = " << busy/nbEvents << " s"
+         << "   median < " << value[0] << " s   99% < " << value[1] << " s"
+         << "   max = " << maxEvent << " s" << G4endl;
+  G4cout.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::PrintMergeStatistics()
+{
+  if (fNbReduced < 2) return;
+
+  // last worker to end its event loop
+  G4double lastEvent = 0.;
+  for (size_t i=0; i<fThreadLoads.size(); ++i) {
+    lastEvent = std::max(lastEvent, fThreadLoads[i].fLast);
+  }
+  
+  G4int prec = G4cout.precision(4);
+  G4cout << "\n Merge of " << fNbReduced << " worker runs (tree depth " 
+         << fMergeDepth << "): "
+         << fMergeTime << " s summed over threads, reduction done " 
+         << std::max(0., fReducedAt - lastEvent) << " s after the last event"
+         << "\n   histograms and ntuples written by the workers in "
+         << fWriteTime << " s (incl. waiting for the output lock)" << G4endl;
+  G4cout.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::PrintEventCosts()
+{
+  if (numberOfEvent == 0) return;
+  
+  G4int prec = G4cout.precision(4);
+  G4cout << "\n Event cost: " 
+         << (G4double)fNbSteps/numberOfEvent << " steps and " 
+         << (G4double)fNbSecondaries/numberOfEvent << " secondaries per event"
+         << G4endl;
+  if (fSlowEvents.empty()) { G4cout.precision(prec); return; }
+  
+  std::vector<EventCost> slowest(fSlowEvents);
+  std::sort(slowest.begin(), slowest.end(), SlowerEvent);
+  G4cout << "   " << slowest.size() << " slowest events"
+         << " (replay with /run/replayEvent <stream>):"
+         << "\n   time (s)  event thread    stream     steps  secondaries"
+         << "  time by particle | steps by volume" << G4endl;
+  for (size_t i=0; i<slowest.size(); ++i) {
+    const EventCost& cost = slowest[i];
+    G4cout << "  " << std::setw(9) << cost.fTime 
+           << std::setw(7) << cost.fEventID 
+           << std::setw(7) << cost.fThread;
+    if (cost.fStream >= 0) G4cout << std::setw(10) << cost.fStream;
+    else                   G4cout << std::setw(10) << "-";
+    G4cout << std::setw(10) << cost.fNbSteps 
+           << std::setw(13) << cost.fNbSecondaries 
+           << "  " << cost.fWhere << G4endl;
+  }
+  G4cout.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::PrintWatchdog()
+{
+  G4int nbKilled = 0;
+  for (G4int i=0; i<Watchdog::kNbBreaches; ++i) nbKilled += fKilledTracks[i];
+  if (nbKilled == 0) return;
+  
+  G4cout << "\n Watchdog: " << nbKilled << " tracks killed in " 
+         << fWatchdogEvents.size();
+  if (fWatchdogEvents.size() == kMaxWatchdogEvents) G4cout << " (or more)";
+  G4cout << " events" << G4endl;
+  for (G4int i=1; i<Watchdog::kNbBreaches; ++i) {
+    if (fKilledTracks[i] == 0) continue;
+    G4cout << "   over the " << std::setw(11) << std::left 
+           << Watchdog::GetBreachName(i) << std::right << ": " 
+           << std::setw(8) << fKilledTracks[i] << " tracks, weight " 
+           << fKilledWeight[i] << G4endl;
+  }
+  G4cout << "   event thread    stream     steps   CPU (s)"
+         << "  (replay with /run/replayEvent <stream>)" << G4endl;
+  for (size_t i=0; i<fWatchdogEvents.size(); ++i) {
+    const EventCost& cost = fWatchdogEvents[i];
+    G4cout << "  " << std::setw(6) << cost.fEventID 
+           << std::setw(7) << cost.fThread;
+    if (cost.fStream >= 0) G4cout << std::setw(10) << cost.fStream;
+    else                   G4cout << std::setw(10) << "-";
+    G4cout << std::setw(10) << cost.fNbSteps
+           << std::setw(10) << cost.fTime << "  " << cost.fWhere << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
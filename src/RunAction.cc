@@ -35,6 +35,17 @@
 #include "DetectorConstruction.hh"
 #include "PrimaryGeneratorAction.hh"
 #include "HistoManager.hh"
+#include "RandomStreams.hh"
+#include "Campaign.hh"
+#include "Checkpoint.hh"
+#include "Convergence.hh"
+#include "Telemetry.hh"
+#include "Records.hh"
+#include "StreamSink.hh"
+#include "SparseScoring.hh"
+#include "FluenceTally.hh"
+#include "MeshTally.hh"
+#include "PointDetector.hh"
 
 #include "G4Run.hh"
 #include "G4UnitsTable.hh"
@@ -71,10 +82,22 @@ G4Run* RunAction::GenerateRun()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void RunAction::BeginOfRunAction(const G4Run*)
+void RunAction::BeginOfRunAction(const G4Run* run)
 {    
   // show Rndm status
-  if (isMaster) G4Random::showEngineStatus();
+  if (isMaster) {
+    G4Random::showEngineStatus();
+    RandomStreams::Instance()->BeginOfRun(run->GetNumberOfEventToBeProcessed());
+    Convergence::Instance()->BeginOfRun();
+    Telemetry::Instance()->BeginOfRun(run->GetRunID(), 
+                                      run->GetNumberOfEventToBeProcessed());
+    Records::Instance()->BeginOfRun();
+    StreamSink::Instance()->BeginOfRun(run->GetRunID());
+    SparseScoring::Instance()->BeginOfRun();
+    FluenceTally::Instance()->BeginOfRun();
+    MeshTally::Instance()->BeginOfRun();
+    PointDetector::Instance()->BeginOfRun();
+  }
   
   // keep run condition
   if (fPrimary) { 
@@ -83,11 +106,24 @@ void RunAction::BeginOfRunAction(const G4Run*)
     G4double energy = fPrimary->GetParticleGun()->GetParticleEnergy();
     fRun->SetPrimary(particle, energy);
   }
+  
+  // events done by this thread, for the checkpoints
+  Checkpoint::Instance()->BeginOfThreadRun();
              
   //histograms
   //
+  HistoManager::UpdateActivation();
   G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
   if ( analysisManager->IsActive() ) {
+    // process of a campaign: one file per process in the campaign directory
+    Campaign* campaign = Campaign::Instance();
+    if (campaign->IsProcess()) {
+      analysisManager->SetFileName(
+        campaign->OutputName(analysisManager->GetFileName(), ".root"));
+    }
+    // resumed run: new files beside those of the interrupted sessions
+    analysisManager->SetFileName(
+      Checkpoint::Instance()->OutputName(analysisManager->GetFileName()));
     analysisManager->OpenFile();
   } 
   
@@ -95,19 +131,51 @@ void RunAction::BeginOfRunAction(const G4Run*)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void RunAction::EndOfRunAction(const G4Run*)
+void RunAction::EndOfRunAction(const G4Run* run)
 {
-  if (isMaster) fRun->EndOfRun();    
+  Convergence* convergence = Convergence::Instance();
+  convergence->EndOfThreadRun();
+  Records::Instance()->EndOfThreadRun();
+  StreamSink::Instance()->EndOfThreadRun();
+  SparseScoring::Instance()->EndOfThreadRun();
+  FluenceTally::Instance()->EndOfThreadRun();
+  MeshTally::Instance()->EndOfThreadRun();
+  PointDetector::Instance()->EndOfThreadRun();
+  
+  if (isMaster) {
+    Telemetry::Instance()->EndOfRun();
+    Records::Instance()->EndOfRun();
+    StreamSink::Instance()->EndOfRun();
+    SparseScoring::Instance()->EndOfRun();
+    FluenceTally::Instance()->EndOfRun();
+    MeshTally::Instance()->EndOfRun();
+    PointDetector::Instance()->EndOfRun();
+    fRun->CollectReduced();
+    Checkpoint::Instance()->EndOfRun(fRun);
+    fRun->EndOfRun();    
+    convergence->EndOfRun();
+  }
   
   //save histograms      
+  G4double start = Run::WallClock();
+  HistoManager::FlushThread();
   G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
   if ( analysisManager->IsActive() ) {
     analysisManager->Write();
     analysisManager->CloseFile();
   }
+  
+  //sum this worker run with the others (see Run::Reduce)
+  if (!isMaster) {
+    fRun->SetWriteTime(Run::WallClock() - start);
+    fRun->Reduce();
+  }
       
-  // show Rndm status
-  if (isMaster) G4Random::showEngineStatus();
+  // show Rndm status, go past the random streams of this run
+  if (isMaster) {
+    G4Random::showEngineStatus();
+    RandomStreams::Instance()->EndOfRun(run->GetNumberOfEventToBeProcessed());
+  }
   	
 //  // export gdml
 //  G4VPhysicalVolume* W = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking() ->GetWorldVolume();
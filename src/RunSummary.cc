@@ -0,0 +1,228 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RunSummary.cc
+/// \brief Implementation of the RunSummary class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "RunSummary.hh"
+
+#include "G4UnitsTable.hh"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunSummary::RunSummary()
+: fNbEvents(0), fPrimary("none"), fEkin(0.),
+  fNbStep1(0), fNbStep2(0),
+  fTrackLen1(0.), fTrackLen2(0.),
+  fTime1(0.), fTime2(0.)
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunSummary::~RunSummary()
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RunSummary::Write(const G4String& fileName) const
+{
+  std::ofstream out(fileName);
+  if (!out) {
+    G4cout << "### RunSummary: cannot write " << fileName << G4endl;
+    return false;
+  }
+  Write(out);
+  return out.good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunSummary::Write(std::ostream& out) const
+{
+  std::streamsize prec = out.precision(17);
+  out << "# Hadr04 run summary (units: mm, ns, MeV)\n"
+      << "events "      << fNbEvents << "\n"
+      << "primary "     << fPrimary << " " << fEkin << "\n"
+      << "steps "       << fNbStep1 << " " << fNbStep2 << "\n"
+      << "trackLength " << fTrackLen1 << " " << fTrackLen2 << "\n"
+      << "time "        << fTime1 << " " << fTime2 << "\n";
+  std::map<G4String,G4int>::const_iterator itp;
+  for (itp = fProcCounter.begin(); itp != fProcCounter.end(); ++itp) {
+    out << "process " << itp->first << " " << itp->second << "\n";
+  }
+  std::map<G4String,ParticleData>::const_iterator itn;
+  for (itn = fParticleDataMap.begin(); itn != fParticleDataMap.end(); ++itn) {
+    const ParticleData& data = itn->second;
+    out << "particle " << itn->first << " " << data.fCount << " " 
+        << data.fEsum << " " << data.fEmin << " " << data.fEmax << "\n";
+  }
+  out.precision(prec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RunSummary::Read(const G4String& fileName)
+{
+  std::ifstream in(fileName);
+  if (!in) {
+    G4cout << "### RunSummary: cannot open " << fileName << G4endl;
+    return false;
+  }
+  return Read(in, fileName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RunSummary::Read(std::istream& in, const G4String& source)
+{
+  std::string line;
+  G4int nbLine = 0;
+  while (std::getline(in, line)) {
+    ++nbLine;
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream is(line);
+    std::string key, name;
+    is >> key;
+    if      (key == "events")      is >> fNbEvents;
+    else if (key == "primary")     { is >> name >> fEkin; fPrimary = name; }
+    else if (key == "steps")       is >> fNbStep1 >> fNbStep2;
+    else if (key == "trackLength") is >> fTrackLen1 >> fTrackLen2;
+    else if (key == "time")        is >> fTime1 >> fTime2;
+    else if (key == "process")     { G4int count; is >> name >> count;
+                                     fProcCounter[name] = count; }
+    else if (key == "particle")    { ParticleData data;
+                                     is >> name >> data.fCount >> data.fEsum
+                                        >> data.fEmin >> data.fEmax;
+                                     fParticleDataMap[name] = data; }
+    else {
+      G4cout << "### RunSummary: unknown record '" << key << "' in "
+             << source << " line " << nbLine << G4endl;
+      return false;
+    }
+    if (is.fail()) {
+      G4cout << "### RunSummary: bad record in " << source 
+             << " line " << nbLine << G4endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunSummary::Add(const RunSummary& other)
+{
+  if (other.fNbEvents > 0) { fPrimary = other.fPrimary; fEkin = other.fEkin; }
+  fNbEvents  += other.fNbEvents;
+  fNbStep1   += other.fNbStep1;   fNbStep2   += other.fNbStep2;
+  fTrackLen1 += other.fTrackLen1; fTrackLen2 += other.fTrackLen2;
+  fTime1     += other.fTime1;     fTime2     += other.fTime2;
+  
+  std::map<G4String,G4int>::const_iterator itp;
+  for (itp = other.fProcCounter.begin(); itp != other.fProcCounter.end();
+       ++itp) {
+    fProcCounter[itp->first] += itp->second;
+  }
+  
+  std::map<G4String,ParticleData>::const_iterator itn;
+  for (itn = other.fParticleDataMap.begin(); 
+       itn != other.fParticleDataMap.end(); ++itn) {
+    const ParticleData& otherData = itn->second;
+    std::map<G4String,ParticleData>::iterator it 
+      = fParticleDataMap.find(itn->first);
+    if (it == fParticleDataMap.end()) {
+      fParticleDataMap[itn->first] = otherData;
+      continue;
+    }
+    ParticleData& data = it->second;
+    data.fCount += otherData.fCount;
+    data.fEsum  += otherData.fEsum;
+    if (otherData.fEmin < data.fEmin) data.fEmin = otherData.fEmin;
+    if (otherData.fEmax > data.fEmax) data.fEmax = otherData.fEmax;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunSummary::Print() const
+{
+  // same layout as Run::EndOfRun
+  G4int prec = 5, wid = prec + 2;  
+  G4int dfprec = G4cout.precision(prec);
+  
+  G4cout << "\n The run is " << fNbEvents << " " << fPrimary << " of "
+         << G4BestUnit(fEkin,"Energy") << G4endl;
+  if (fNbEvents == 0) { G4cout.precision(dfprec); return; }
+  
+  G4cout << "\n Process calls frequency :" << G4endl;  
+  std::map<G4String,G4int>::const_iterator itp;
+  for (itp = fProcCounter.begin(); itp != fProcCounter.end(); ++itp) {
+    G4cout << "\t" << itp->first << "= " << itp->second;
+  }
+  G4cout << G4endl;
+  
+  G4double meanCollision1 = (G4double)fNbStep1/fNbEvents;
+  G4double meanCollision2 = (G4double)fNbStep2/fNbEvents;
+  G4double meanTrackLen1  = fTrackLen1/fNbEvents;
+  G4double meanTrackLen2  = fTrackLen2/fNbEvents;
+  G4double meanTime1      = fTime1/fNbEvents;
+  G4double meanTime2      = fTime2/fNbEvents;
+  
+  G4cout << "\n Parcours of incident neutron:"
+    << "\n   nb of collisions    E>1*eV= " << meanCollision1
+    << "      E<1*eV= " << meanCollision2
+    << "       total= " << meanCollision1 + meanCollision2
+    << "\n   track length        E>1*eV= " << G4BestUnit(meanTrackLen1,"Length")
+    << "  E<1*eV= " << G4BestUnit(meanTrackLen2, "Length")
+    << "   total= " << G4BestUnit(meanTrackLen1 + meanTrackLen2, "Length")
+    << "\n   time of flight      E>1*eV= " << G4BestUnit(meanTime1,"Time")
+    << "  E<1*eV= " << G4BestUnit(meanTime2, "Time")
+    << "   total= " << G4BestUnit(meanTime1 + meanTime2, "Time") << G4endl;
+  
+  G4cout << "\n List of generated particles:" << G4endl;
+  std::map<G4String,ParticleData>::const_iterator itn;
+  for (itn = fParticleDataMap.begin(); itn != fParticleDataMap.end(); ++itn) {
+    const ParticleData& data = itn->second;
+    G4cout << "  " << std::setw(13) << itn->first << ": " 
+           << std::setw(7) << data.fCount
+           << "  Emean = " << std::setw(wid) 
+           << G4BestUnit(data.fEsum/data.fCount, "Energy")
+           << "\t( "  << G4BestUnit(data.fEmin, "Energy")
+           << " --> " << G4BestUnit(data.fEmax, "Energy") 
+           << ")" << G4endl;           
+  }
+  
+  G4cout.precision(dfprec);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,84 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SlowEvents.cc
+/// \brief Implementation of the SlowEvents class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "SlowEvents.hh"
+#include "SlowEventsMessenger.hh"
+#include "RandomStreams.hh"
+
+#include "G4UImanager.hh"
+
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SlowEvents* SlowEvents::Instance()
+{
+  static SlowEvents instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SlowEvents::SlowEvents()
+: fNbSlowest(10), fMessenger(0)
+{
+  fMessenger = new SlowEventsMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SlowEvents::~SlowEvents()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SlowEvents::Replay(uint64_t stream)
+{
+  RandomStreams* streams = RandomStreams::Instance();
+  if (!streams->IsCounterBased()) {
+    G4cout << "### /run/replayEvent: events are identified by their random"
+           << " stream, set /testhadr/random/engine philox (and the seed of"
+           << " the run) first" << G4endl;
+    return;
+  }
+  
+  // the streams of the next runs are not moved by the replay
+  G4cout << "\n Replay of the event of random stream " << stream 
+         << " (seed " << streams->GetSeed() << ")" << G4endl;
+  streams->SetStreamList(std::vector<uint64_t>(1, stream),
+                         streams->GetFirstEvent());
+  G4UImanager::GetUIpointer()->ApplyCommand("/run/beamOn 1");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,100 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SlowEventsMessenger.cc
+/// \brief Implementation of the SlowEventsMessenger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "SlowEventsMessenger.hh"
+
+#include "SlowEvents.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SlowEventsMessenger::SlowEventsMessenger(SlowEvents* slowEvents)
+:G4UImessenger(),fSlowEvents(slowEvents),
+ fEventDir(0), fSlowestCmd(0), fReplayCmd(0)
+{ 
+  G4bool broadcast = false;
+  fEventDir = new G4UIdirectory("/testhadr/event/",broadcast);
+  fEventDir->SetGuidance("cost of the events");
+  
+  fSlowestCmd = new G4UIcmdWithAnInteger("/testhadr/event/slowest",this);
+  fSlowestCmd->SetGuidance("number of slowest events listed at end of run;");
+  fSlowestCmd->SetGuidance("  0 to disable");
+  fSlowestCmd->SetParameterName("n",false);
+  fSlowestCmd->SetRange("n>=0");
+  fSlowestCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fSlowestCmd->SetToBeBroadcasted(false);
+  
+  // beside /run/beamOn, as it is a run of one event
+  fReplayCmd = new G4UIcommand("/run/replayEvent",this);
+  fReplayCmd->SetGuidance("run alone the event of a counter-based random");
+  fReplayCmd->SetGuidance("  stream, e.g. one of the slowest events of a run");
+  G4UIparameter* streamPrm = new G4UIparameter("stream",'s',false);
+  fReplayCmd->SetParameter(streamPrm);
+  fReplayCmd->AvailableForStates(G4State_Idle);
+  fReplayCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SlowEventsMessenger::~SlowEventsMessenger()
+{
+  delete fSlowestCmd;
+  delete fReplayCmd;
+  delete fEventDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SlowEventsMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{   
+  if (command == fSlowestCmd)
+   {fSlowEvents->SetNbSlowest(fSlowestCmd->GetNewIntValue(newValue));}
+   
+  if (command == fReplayCmd)
+   { unsigned long long stream = 0;
+     std::istringstream is(newValue);
+     if (!(is >> stream)) {
+       G4cout << "### " << command->GetCommandPath() << ": " << newValue
+              << " is not an unsigned integer" << G4endl;
+       return;
+     }
+     fSlowEvents->Replay(stream);
+   }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,302 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SparseH2.cc
+/// \brief Implementation of the SparseH2 class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "SparseH2.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+  const G4int kInitialBits = 6;
+  
+  // keys are ix << 32 | iy: order of the bins by y, then x
+  inline uint64_t Order(uint64_t key) { return key << 32 | key >> 32; }
+  
+  struct ByBin {
+    template <class C> bool operator()(const C* a, const C* b) const
+      { return Order(a->fKey) < Order(b->fKey); }
+  };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SparseH2::SparseH2(G4int nx, G4double xmin, G4double xmax,
+                   G4int ny, G4double ymin, G4double ymax)
+: fNx(nx), fNy(ny), 
+  fXmin(xmin), fXmax(xmax), fXscale(nx/(xmax - xmin)),
+  fYmin(ymin), fYmax(ymax), fYscale(ny/(ymax - ymin)),
+  fShift(64 - kInitialBits), fNbOccupied(0)
+{
+  Reset();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SparseH2::~SparseH2()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SparseH2::Reset()
+{
+  Cell empty = { kEmpty, 0., 0., 0 };
+  std::vector<Cell>(size_t(1) << kInitialBits, empty).swap(fCells);
+  fShift = 64 - kInitialBits;
+  fNbOccupied = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SparseH2::Cell& SparseH2::Insert(uint64_t key)
+{
+  // at most half full
+  if (2*(fNbOccupied + 1) > fCells.size()) Grow();
+  size_t mask = fCells.size() - 1;
+  size_t i = Hash(key);
+  while (fCells[i].fKey != kEmpty) i = (i + 1) & mask;
+  fCells[i].fKey = key;
+  fNbOccupied++;
+  return fCells[i];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SparseH2::Grow()
+{
+  Cell empty = { kEmpty, 0., 0., 0 };
+  std::vector<Cell> cells(2*fCells.size(), empty);
+  cells.swap(fCells);
+  fShift--;
+  size_t mask = fCells.size() - 1;
+  for (size_t k=0; k<cells.size(); ++k) {
+    if (cells[k].fKey == kEmpty) continue;
+    size_t i = Hash(cells[k].fKey);
+    while (fCells[i].fKey != kEmpty) i = (i + 1) & mask;
+    fCells[i] = cells[k];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SparseH2::Add(const SparseH2& other)
+{
+  if (other.fNx != fNx || other.fNy != fNy || 
+      other.fXmin != fXmin || other.fXmax != fXmax ||
+      other.fYmin != fYmin || other.fYmax != fYmax) return false;
+  
+  for (size_t k=0; k<other.fCells.size(); ++k) {
+    const Cell& cell = other.fCells[k];
+    if (cell.fKey == kEmpty) continue;
+    Cell& sum = Find(cell.fKey);
+    sum.fEntries += cell.fEntries;
+    sum.fSw      += cell.fSw;
+    sum.fSw2     += cell.fSw2;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+size_t SparseH2::GetDenseMemory() const
+{
+  // entries, sum of w and of w2 for every bin
+  return size_t(fNx + 2)*size_t(fNy + 2)*(sizeof(uint32_t) + 2*sizeof(G4double));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<const SparseH2::Cell*> SparseH2::SortedCells() const
+{
+  std::vector<const Cell*> cells;
+  cells.reserve(fNbOccupied);
+  for (size_t k=0; k<fCells.size(); ++k) {
+    if (fCells[k].fKey != kEmpty) cells.push_back(&fCells[k]);
+  }
+  std::sort(cells.begin(), cells.end(), ByBin());
+  return cells;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SparseH2::WriteCoo(const G4String& fileName, 
+                          G4double unit, const G4String& unitName) const
+{
+  std::ofstream out(fileName.c_str());
+  if (!out) return false;
+  
+  std::vector<const Cell*> cells = SortedCells();
+  G4double outside = 0.;
+  for (size_t k=0; k<cells.size(); ++k) {
+    G4int ix = G4int(cells[k]->fKey >> 32), iy = G4int(cells[k]->fKey & 0xffffffff);
+    if (ix < 1 || ix > fNx || iy < 1 || iy > fNy) outside += cells[k]->fSw;
+  }
+  
+  out << "# sparse H2: " << fNx << " bins in x from " << fXmin/unit 
+      << " to " << fXmax/unit << ", " << fNy << " bins in y from " 
+      << fYmin/unit << " to " << fYmax/unit << " " << unitName << "\n"
+      << "# occupied bins: " << fNbOccupied 
+      << ", sum of weights out of range: " << outside << "\n"
+      << "# ix iy x y sumw sumw2 entries (bins from 0, centres)\n"
+      << std::setprecision(9);
+  G4double dx = (fXmax - fXmin)/fNx, dy = (fYmax - fYmin)/fNy;
+  for (size_t k=0; k<cells.size(); ++k) {
+    const Cell& cell = *cells[k];
+    G4int ix = G4int(cell.fKey >> 32), iy = G4int(cell.fKey & 0xffffffff);
+    if (ix < 1 || ix > fNx || iy < 1 || iy > fNy) continue;
+    out << ix-1 << " " << iy-1 << " "
+        << (fXmin + (ix - 0.5)*dx)/unit << " " << (fYmin + (iy - 0.5)*dy)/unit
+        << " " << cell.fSw << " " << cell.fSw2 << " " << cell.fEntries << "\n";
+  }
+  return out.good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SparseH2::WriteDense(const G4String& fileName,
+                            G4double unit, const G4String& unitName) const
+{
+  std::ofstream out(fileName.c_str());
+  if (!out) return false;
+  
+  out << "# dense H2: " << fNx << " bins in x from " << fXmin/unit 
+      << " to " << fXmax/unit << ", " << fNy << " bins in y from " 
+      << fYmin/unit << " to " << fYmax/unit << " " << unitName << "\n"
+      << "# sum of weights: one line per y bin, one value per x bin\n"
+      << std::setprecision(9);
+  
+  // row by row, walking the sorted occupied bins
+  std::vector<const Cell*> cells = SortedCells();
+  size_t k = 0;
+  for (G4int iy=1; iy<=fNy; ++iy) {
+    for (G4int ix=1; ix<=fNx; ++ix) {
+      // past the under/overflows and the bins before this one
+      uint64_t key = Key(ix, iy);
+      while (k < cells.size() && Order(cells[k]->fKey) < Order(key)) ++k;
+      G4double sw = 0.;
+      if (k < cells.size() && cells[k]->fKey == key) sw = cells[k]->fSw;
+      out << sw << ((ix < fNx) ? " " : "\n");
+    }
+  }
+  return out.good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SparseH2::Write(const G4String& fileName, G4double unit, 
+                       const G4String& unitName, G4int formats) const
+{
+  FILE* file = std::fopen(fileName.c_str(), "wb");
+  if (!file) return false;
+  
+  uint32_t version = 1, n[2] = { uint32_t(fNx), uint32_t(fNy) };
+  uint32_t length = unitName.size(), format = formats;
+  G4double limits[5] = { fXmin, fXmax, fYmin, fYmax, unit };
+  uint64_t nbCells = fNbOccupied;
+  G4bool ok = std::fwrite("H04H", 1, 4, file) == 4
+           && std::fwrite(&version, sizeof(version), 1, file) == 1
+           && std::fwrite(n, sizeof(n), 1, file) == 1
+           && std::fwrite(limits, sizeof(limits), 1, file) == 1
+           && std::fwrite(&length, sizeof(length), 1, file) == 1
+           && std::fwrite(unitName.data(), 1, length, file) == length
+           && std::fwrite(&format, sizeof(format), 1, file) == 1
+           && std::fwrite(&nbCells, sizeof(nbCells), 1, file) == 1;
+  for (size_t k=0; k<fCells.size() && ok; ++k) {
+    const Cell& cell = fCells[k];
+    if (cell.fKey == kEmpty) continue;
+    G4double sums[2] = { cell.fSw, cell.fSw2 };
+    ok = std::fwrite(&cell.fKey, sizeof(cell.fKey), 1, file) == 1
+      && std::fwrite(sums, sizeof(sums), 1, file) == 1
+      && std::fwrite(&cell.fEntries, sizeof(cell.fEntries), 1, file) == 1;
+  }
+  ok &= (std::fclose(file) == 0);
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SparseH2* SparseH2::Read(const G4String& fileName, G4double& unit,
+                         G4String& unitName, G4int& formats)
+{
+  FILE* file = std::fopen(fileName.c_str(), "rb");
+  if (!file) return 0;
+  
+  char magic[4];
+  uint32_t version = 0, n[2], length = 0, format = 0;
+  G4double limits[5];
+  uint64_t nbCells = 0;
+  G4bool ok = std::fread(magic, 1, 4, file) == 4
+           && std::memcmp(magic, "H04H", 4) == 0
+           && std::fread(&version, sizeof(version), 1, file) == 1
+           && version == 1
+           && std::fread(n, sizeof(n), 1, file) == 1
+           && std::fread(limits, sizeof(limits), 1, file) == 1
+           && std::fread(&length, sizeof(length), 1, file) == 1;
+  std::string name(length, ' ');
+  ok = ok && (length == 0 || std::fread(&name[0], 1, length, file) == length)
+          && std::fread(&format, sizeof(format), 1, file) == 1
+          && std::fread(&nbCells, sizeof(nbCells), 1, file) == 1;
+  if (!ok) {
+    std::fclose(file);
+    return 0;
+  }
+  
+  SparseH2* h2 = new SparseH2(n[0], limits[0], limits[1], 
+                              n[1], limits[2], limits[3]);
+  for (uint64_t k=0; k<nbCells && ok; ++k) {
+    uint64_t key;
+    G4double sums[2];
+    uint32_t entries;
+    ok = std::fread(&key, sizeof(key), 1, file) == 1
+      && std::fread(sums, sizeof(sums), 1, file) == 1
+      && std::fread(&entries, sizeof(entries), 1, file) == 1
+      && key != kEmpty;
+    if (!ok) break;
+    Cell& cell = h2->Find(key);
+    cell.fSw      += sums[0];
+    cell.fSw2     += sums[1];
+    cell.fEntries += entries;
+  }
+  std::fclose(file);
+  if (!ok) {
+    delete h2;
+    return 0;
+  }
+  unit = limits[4];
+  unitName = name;
+  formats = format;
+  return h2;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,284 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SparseMesh.cc
+/// \brief Implementation of the SparseMesh class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "SparseMesh.hh"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+  const G4int kInitialBits = 6;
+  const uint64_t kNoBlock = ~uint64_t(0);
+  const uint64_t kAxisMask = (uint64_t(1) << 21) - 1;
+  
+  // blocks, as voxels: bx << 42 | by << 21 | bz
+  inline uint64_t BlockKey(uint64_t key)
+  {
+    const G4int bits = SparseMesh::kBlockBits;
+    return ((key >> 42 & kAxisMask) >> bits) << 42 
+         | ((key >> 21 & kAxisMask) >> bits) << 21 
+         | ((key & kAxisMask) >> bits);
+  }
+  
+  // voxel within its block, z fastest
+  inline G4int VoxelInBlock(uint64_t key)
+  {
+    const uint64_t mask = SparseMesh::kBlockSide - 1;
+    return G4int(((key >> 42 & mask) << 2*SparseMesh::kBlockBits) 
+               | ((key >> 21 & mask) << SparseMesh::kBlockBits) 
+               | (key & mask));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SparseMesh::SparseMesh(G4int nx, G4int ny, G4int nz,
+                       const G4ThreeVector& lower, const G4ThreeVector& upper)
+: fShift(64 - kInitialBits)
+{
+  fN[0] = nx; fN[1] = ny; fN[2] = nz;
+  for (G4int k=0; k<3; ++k) {
+    fLower[k] = lower[k];
+    fUpper[k] = upper[k];
+    fSize[k]  = (upper[k] - lower[k])/fN[k];
+  }
+  Slot empty = { kNoBlock, -1 };
+  fSlots.assign(size_t(1) << kInitialBits, empty);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SparseMesh::~SparseMesh()
+{
+  for (size_t i=0; i<fBlocks.size(); ++i) delete fBlocks[i];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SparseMesh::Find(const G4ThreeVector& point, uint64_t& key) const
+{
+  G4int index[3];
+  for (G4int k=0; k<3; ++k) {
+    G4double u = (point[k] - fLower[k])/fSize[k];
+    if (!(u >= 0.) || u >= fN[k]) return false;
+    index[k] = std::min(G4int(u), fN[k] - 1);
+  }
+  key = Key(index[0], index[1], index[2]);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SparseMesh::Block& SparseMesh::GetBlock(uint64_t blockKey)
+{
+  size_t mask = fSlots.size() - 1;
+  size_t i = Hash(blockKey);
+  while (fSlots[i].fBlock >= 0) {
+    if (fSlots[i].fKey == blockKey) return *fBlocks[fSlots[i].fBlock];
+    i = (i + 1) & mask;
+  }
+  
+  // new block, the table at most half full
+  if (2*(fBlocks.size() + 1) > fSlots.size()) {
+    Grow();
+    mask = fSlots.size() - 1;
+    i = Hash(blockKey);
+    while (fSlots[i].fBlock >= 0) i = (i + 1) & mask;
+  }
+  Block* block = new Block;
+  std::memset(block, 0, sizeof(Block));
+  fSlots[i].fKey = blockKey;
+  fSlots[i].fBlock = fBlocks.size();
+  fBlocks.push_back(block);
+  return *block;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SparseMesh::Grow()
+{
+  Slot empty = { kNoBlock, -1 };
+  std::vector<Slot> slots(2*fSlots.size(), empty);
+  slots.swap(fSlots);
+  fShift--;
+  size_t mask = fSlots.size() - 1;
+  for (size_t k=0; k<slots.size(); ++k) {
+    if (slots[k].fBlock < 0) continue;
+    size_t i = Hash(slots[k].fKey);
+    while (fSlots[i].fBlock >= 0) i = (i + 1) & mask;
+    fSlots[i] = slots[k];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SparseMesh::AddEventScore(uint64_t key, G4double score)
+{
+  Block& block = GetBlock(BlockKey(key));
+  G4int i = VoxelInBlock(key);
+  block.fSum[i]  += score;
+  block.fSum2[i] += score*score;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SparseMesh::Add(const SparseMesh& other)
+{
+  for (G4int k=0; k<3; ++k) {
+    if (other.fN[k] != fN[k] || other.fLower[k] != fLower[k] || 
+        other.fUpper[k] != fUpper[k]) return false;
+  }
+  for (size_t s=0; s<other.fSlots.size(); ++s) {
+    const Slot& slot = other.fSlots[s];
+    if (slot.fBlock < 0) continue;
+    const Block& from = *other.fBlocks[slot.fBlock];
+    Block& to = GetBlock(slot.fKey);
+    for (G4int i=0; i<kBlockSize; ++i) {
+      to.fSum[i]  += from.fSum[i];
+      to.fSum2[i] += from.fSum2[i];
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SparseMesh::GetTotal() const
+{
+  G4double total = 0.;
+  for (size_t b=0; b<fBlocks.size(); ++b) {
+    for (G4int i=0; i<kBlockSize; ++i) total += fBlocks[b]->fSum[i];
+  }
+  return total;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+size_t SparseMesh::GetMemory() const
+{
+  return fBlocks.size()*(sizeof(Block) + sizeof(Block*)) 
+       + fSlots.size()*sizeof(Slot);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SparseMesh::GetDenseMemory() const
+{
+  return G4double(fN[0])*fN[1]*fN[2]*2*sizeof(G4double);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SparseMesh::Write(const G4String& fileName, G4long nbEvents) const
+{
+  FILE* file = std::fopen(fileName.c_str(), "wb");
+  if (!file) return false;
+  
+  uint32_t version = 1;
+  uint32_t n[3] = { uint32_t(fN[0]), uint32_t(fN[1]), uint32_t(fN[2]) };
+  uint64_t events = nbEvents, blocks = fBlocks.size();
+  G4bool ok = std::fwrite("H04V", 1, 4, file) == 4
+           && std::fwrite(&version, sizeof(version), 1, file) == 1
+           && std::fwrite(n, sizeof(n), 1, file) == 1
+           && std::fwrite(fLower, sizeof(fLower), 1, file) == 1
+           && std::fwrite(fUpper, sizeof(fUpper), 1, file) == 1
+           && std::fwrite(&events, sizeof(events), 1, file) == 1
+           && std::fwrite(&blocks, sizeof(blocks), 1, file) == 1;
+  
+  // blocks in the order of their creation
+  std::vector<uint64_t> keys(fBlocks.size());
+  for (size_t s=0; s<fSlots.size(); ++s) {
+    if (fSlots[s].fBlock >= 0) keys[fSlots[s].fBlock] = fSlots[s].fKey;
+  }
+  for (size_t b=0; b<fBlocks.size() && ok; ++b) {
+    uint32_t coordinates[3] = { uint32_t(keys[b] >> 42 & kAxisMask),
+                                uint32_t(keys[b] >> 21 & kAxisMask),
+                                uint32_t(keys[b] & kAxisMask) };
+    ok = std::fwrite(coordinates, sizeof(coordinates), 1, file) == 1
+      && std::fwrite(fBlocks[b], sizeof(Block), 1, file) == 1;
+  }
+  ok &= (std::fclose(file) == 0);
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SparseMesh* SparseMesh::Read(const G4String& fileName, G4long& nbEvents)
+{
+  FILE* file = std::fopen(fileName.c_str(), "rb");
+  if (!file) return 0;
+  
+  char magic[4];
+  uint32_t version = 0, n[3];
+  G4double lower[3], upper[3];
+  uint64_t events = 0, blocks = 0;
+  G4bool ok = std::fread(magic, 1, 4, file) == 4 
+           && std::memcmp(magic, "H04V", 4) == 0
+           && std::fread(&version, sizeof(version), 1, file) == 1 
+           && version == 1
+           && std::fread(n, sizeof(n), 1, file) == 1
+           && std::fread(lower, sizeof(lower), 1, file) == 1
+           && std::fread(upper, sizeof(upper), 1, file) == 1
+           && std::fread(&events, sizeof(events), 1, file) == 1
+           && std::fread(&blocks, sizeof(blocks), 1, file) == 1;
+  if (!ok) {
+    std::fclose(file);
+    return 0;
+  }
+  
+  SparseMesh* mesh = new SparseMesh(n[0], n[1], n[2], 
+                                    G4ThreeVector(lower[0], lower[1], lower[2]),
+                                    G4ThreeVector(upper[0], upper[1], upper[2]));
+  Block data;
+  for (uint64_t b=0; b<blocks && ok; ++b) {
+    uint32_t coordinates[3];
+    ok = std::fread(coordinates, sizeof(coordinates), 1, file) == 1
+      && std::fread(&data, sizeof(Block), 1, file) == 1;
+    if (!ok) break;
+    Block& block = mesh->GetBlock(uint64_t(coordinates[0]) << 42 
+                                | uint64_t(coordinates[1]) << 21 
+                                | uint64_t(coordinates[2]));
+    for (G4int i=0; i<kBlockSize; ++i) {
+      block.fSum[i]  += data.fSum[i];
+      block.fSum2[i] += data.fSum2[i];
+    }
+  }
+  std::fclose(file);
+  if (!ok) {
+    delete mesh;
+    return 0;
+  }
+  nbEvents = (G4long)events;
+  return mesh;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,195 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SparseScoring.cc
+/// \brief Implementation of the SparseScoring class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "SparseScoring.hh"
+#include "SparseScoringMessenger.hh"
+#include "Campaign.hh"
+#include "Checkpoint.hh"
+
+#include "G4UnitsTable.hh"
+
+#include <sstream>
+
+namespace {
+  // maps of this thread, for the run fRun
+  struct ThreadMaps {
+    ThreadMaps() : fRun(-1) {}
+    std::vector<SparseH2*> fMaps;
+    G4int                  fRun;
+  };
+  G4ThreadLocal ThreadMaps* threadMaps = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SparseScoring* SparseScoring::Instance()
+{
+  static SparseScoring instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SparseScoring::SparseScoring()
+: fFileName("Hadr04"), fFormat(kCoo), fH2Mask(0), fRunCount(0), 
+  fMessenger(0)
+{
+  for (G4int i=0; i<kMaxH2; ++i) fIndex[i] = -1;
+  fMessenger = new SparseScoringMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SparseScoring::~SparseScoring()
+{
+  for (size_t i=0; i<fDefinitions.size(); ++i) delete fDefinitions[i].fSum;
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SparseScoring::Define(G4int id, G4int nx, G4double xmin, G4double xmax,
+                           G4int ny, G4double ymin, G4double ymax, 
+                           const G4String& unitName)
+{
+  if (id < 0 || id >= kMaxH2 || nx < 1 || ny < 1 || 
+      !(xmax > xmin) || !(ymax > ymin)) {
+    G4cout << "### SparseScoring: bad definition of the map of H2 " << id
+           << G4endl;
+    return;
+  }
+  Definition definition = 
+    { id, nx, ny, xmin, xmax, ymin, ymax, unitName, 0 };
+  for (size_t i=0; i<fDefinitions.size(); ++i) {
+    if (fDefinitions[i].fId == id) { fDefinitions[i] = definition; return; }
+  }
+  fDefinitions.push_back(definition);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SparseScoring::BeginOfRun()
+{
+  fRunCount++;
+  uint64_t mask = 0;
+  for (G4int i=0; i<kMaxH2; ++i) fIndex[i] = -1;
+  for (size_t i=0; i<fDefinitions.size(); ++i) {
+    Definition& definition = fDefinitions[i];
+    delete definition.fSum;
+    definition.fSum = new SparseH2(definition.fNx, definition.fXmin, 
+      definition.fXmax, definition.fNy, definition.fYmin, definition.fYmax);
+    fIndex[definition.fId] = i;
+    mask |= uint64_t(1) << definition.fId;
+  }
+  fH2Mask = mask;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SparseScoring::Fill(G4int id, G4double x, G4double y, G4double weight)
+{
+  // maps of this thread, at its first fill of the run
+  if (!threadMaps) threadMaps = new ThreadMaps;
+  if (threadMaps->fRun != fRunCount) {
+    for (size_t i=0; i<threadMaps->fMaps.size(); ++i) {
+      delete threadMaps->fMaps[i];
+    }
+    threadMaps->fMaps.assign(fDefinitions.size(), 0);
+    threadMaps->fRun = fRunCount;
+  }
+  SparseH2*& map = threadMaps->fMaps[fIndex[id]];
+  if (!map) {
+    const Definition& definition = fDefinitions[fIndex[id]];
+    map = new SparseH2(definition.fNx, definition.fXmin, definition.fXmax,
+                       definition.fNy, definition.fYmin, definition.fYmax);
+  }
+  map->Fill(x, y, weight);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SparseScoring::EndOfThreadRun()
+{
+  if (!threadMaps || threadMaps->fRun != fRunCount) return;
+  
+  // sums of the maps of this thread, freed
+  std::lock_guard<std::mutex> lock(fSumMutex);
+  for (size_t i=0; i<threadMaps->fMaps.size(); ++i) {
+    SparseH2* map = threadMaps->fMaps[i];
+    if (!map) continue;
+    fDefinitions[i].fSum->Add(*map);
+    delete map;
+    threadMaps->fMaps[i] = 0;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SparseScoring::EndOfRun()
+{
+  fH2Mask = 0;
+  if (fDefinitions.empty()) return;
+  
+  Campaign* campaign = Campaign::Instance();
+  Checkpoint* checkpoint = Checkpoint::Instance();
+  G4cout << "\n Sparse maps of the test planes:" << G4endl;
+  for (size_t i=0; i<fDefinitions.size(); ++i) {
+    Definition& definition = fDefinitions[i];
+    if (!definition.fSum) continue;
+    SparseH2* sum = definition.fSum;
+    G4double unit = G4UnitDefinition::GetValueOf(definition.fUnitName);
+    
+    std::ostringstream stem;
+    stem << fFileName << "_sparse" << definition.fId;
+    G4String names[2] = { stem.str() + ".coo", stem.str() + ".dense" };
+    G4String raw = checkpoint->OutputName(
+                     campaign->OutputName(stem.str() + ".h04h", ".h04h"));
+    G4bool ok = sum->Write(raw, unit, definition.fUnitName, fFormat);
+    for (G4int k=0; k<2; ++k) {
+      if (!(fFormat & (1 << k))) continue;
+      G4String ext = (k == 0) ? ".coo" : ".dense";
+      names[k] = checkpoint->OutputName(campaign->OutputName(names[k], ext));
+      ok &= (k == 0) ? sum->WriteCoo(names[k], unit, definition.fUnitName)
+                     : sum->WriteDense(names[k], unit, definition.fUnitName);
+    }
+    G4cout << "   H2 " << definition.fId << ": " << sum->GetNbOccupied() 
+           << " bins occupied, " << sum->GetMemory()/1024 << " kB (dense: "
+           << sum->GetDenseMemory()/1024 << " kB)";
+    if (!ok) G4cout << "  ### could not write its files";
+    G4cout << G4endl;
+    
+    delete definition.fSum;
+    definition.fSum = 0;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,133 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file SparseScoringMessenger.cc
+/// \brief Implementation of the SparseScoringMessenger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "SparseScoringMessenger.hh"
+
+#include "SparseScoring.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SparseScoringMessenger::SparseScoringMessenger(SparseScoring* scoring)
+:G4UImessenger(),fScoring(scoring),
+ fSparseDir(0), fH2Cmd(0), fClearCmd(0), fFileCmd(0), fFormatCmd(0)
+{ 
+  G4bool broadcast = false;
+  fSparseDir = new G4UIdirectory("/testhadr/sparse/",broadcast);
+  fSparseDir->SetGuidance("sparse high resolution maps of the test planes");
+  
+  fH2Cmd = new G4UIcommand("/testhadr/sparse/h2",this);
+  fH2Cmd->SetGuidance("sparse map filled as the H2 id, with its own binning,");
+  fH2Cmd->SetGuidance("  e.g. 0 1600 -800 800 1600 -800 800 cm");
+  G4UIparameter* idPrm = new G4UIparameter("id",'i',false);
+  idPrm->SetParameterRange("id>=0 && id<64");
+  fH2Cmd->SetParameter(idPrm);
+  G4UIparameter* nxPrm = new G4UIparameter("nx",'i',false);
+  nxPrm->SetParameterRange("nx>0");
+  fH2Cmd->SetParameter(nxPrm);
+  fH2Cmd->SetParameter(new G4UIparameter("xmin",'d',false));
+  fH2Cmd->SetParameter(new G4UIparameter("xmax",'d',false));
+  G4UIparameter* nyPrm = new G4UIparameter("ny",'i',false);
+  nyPrm->SetParameterRange("ny>0");
+  fH2Cmd->SetParameter(nyPrm);
+  fH2Cmd->SetParameter(new G4UIparameter("ymin",'d',false));
+  fH2Cmd->SetParameter(new G4UIparameter("ymax",'d',false));
+  G4UIparameter* unitPrm = new G4UIparameter("unit",'s',true);
+  unitPrm->SetDefaultUnit("cm");
+  fH2Cmd->SetParameter(unitPrm);
+  fH2Cmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fH2Cmd->SetToBeBroadcasted(false);
+  
+  fClearCmd = new G4UIcmdWithoutParameter("/testhadr/sparse/clear",this);
+  fClearCmd->SetGuidance("remove all the sparse maps");
+  fClearCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fClearCmd->SetToBeBroadcasted(false);
+  
+  fFileCmd = new G4UIcmdWithAString("/testhadr/sparse/file",this);
+  fFileCmd->SetGuidance("stem of the files <file>_sparse<id>.coo/.dense");
+  fFileCmd->SetParameterName("file",false);
+  fFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fFileCmd->SetToBeBroadcasted(false);
+  
+  fFormatCmd = new G4UIcmdWithAString("/testhadr/sparse/format",this);
+  fFormatCmd->SetGuidance("occupied bins (coo), full grid (dense) or both");
+  fFormatCmd->SetParameterName("format",false);
+  fFormatCmd->SetCandidates("coo dense both");
+  fFormatCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fFormatCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SparseScoringMessenger::~SparseScoringMessenger()
+{
+  delete fH2Cmd;
+  delete fClearCmd;
+  delete fFileCmd;
+  delete fFormatCmd;
+  delete fSparseDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SparseScoringMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{   
+  if (command == fH2Cmd)
+   { G4int id, nx, ny; G4double xmin, xmax, ymin, ymax; G4String unit;
+     std::istringstream is(newValue);
+     is >> id >> nx >> xmin >> xmax >> ny >> ymin >> ymax >> unit;
+     G4double u = G4UIcommand::ValueOf(unit);
+     fScoring->Define(id, nx, xmin*u, xmax*u, ny, ymin*u, ymax*u, unit);
+   }
+   
+  if (command == fClearCmd)
+   {fScoring->Clear();}
+   
+  if (command == fFileCmd)
+   {fScoring->SetFileName(newValue);}
+   
+  if (command == fFormatCmd)
+   { G4int format = SparseScoring::kCoo;
+     if (newValue == "dense") format = SparseScoring::kDense;
+     if (newValue == "both")  format = SparseScoring::kCoo | SparseScoring::kDense;
+     fScoring->SetFormat(format);
+   }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
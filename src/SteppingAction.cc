@@ -33,8 +33,24 @@
 #include "SteppingAction.hh"
 #include "Run.hh"
 #include "HistoManager.hh"
+#include "Watchdog.hh"
+#include "Records.hh"
+#include "StreamSink.hh"
+#include "FluenceTally.hh"
+#include "MeshTally.hh"
+#include "PointDetector.hh"
 
 #include "G4RunManager.hh"
+#include "G4Gamma.hh"
+
+namespace {
+  // analysis histogram, and its live stream if any
+  inline void FillH1(G4int id, G4double value)
+  {
+    HistoManager::FillH1(id, value);
+    StreamSink::Instance()->FillH1(id, value);
+  }
+}
                            
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -59,16 +75,19 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
   const G4VProcess* process   = endPoint->GetProcessDefinedStep();
   G4String processName = process->GetProcessName();  
     
-  // Count processes  
+  // Count processes, cost of the event
   Run* run = static_cast<Run*>(
         G4RunManager::GetRunManager()->GetNonConstCurrentRun());
   run->CountProcesses(process);
+  fEventAction->CountStep(step);
+  Watchdog::Instance()->Check(step);
     
   // Get step information
   const G4StepPoint* pre = step->GetPreStepPoint();   
   const G4StepPoint* post = step->GetPostStepPoint();
   const G4VPhysicalVolume* prePhysical = pre->GetPhysicalVolume();
   const G4VPhysicalVolume* postPhysical = post->GetPhysicalVolume();
+  const G4ThreeVector& position = post->GetPosition();
   G4double x = post->GetPosition().x(), y = post->GetPosition().y(), z = post->GetPosition().z(); 		
   
   // Get track information
@@ -76,6 +95,11 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
   G4double ekin = track->GetKineticEnergy();
   G4double trackl = track->GetTrackLength();
   G4double time = track->GetLocalTime(); 
+  
+  // Fluence in the cells and meshes, and at the point detectors
+  FluenceTally::Instance()->AddStep(step);
+  MeshTally::Instance()->AddStep(step);
+  PointDetector::Instance()->AddStep(step);
    
   // Sanity checks
   if(prePhysical == 0 || postPhysical == 0) return;  // The track does not exist  
@@ -94,59 +118,83 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
   	// Neutrons exiting collimator window
     if(preLogical == fDetector->fSourceVolume_l && postLogical == fDetector->fTestPlane1_l)	{
     	fEventAction->fCount_neutron_source2nitrogenBW++;
-    	if(fEventAction->fCount_neutron_source2nitrogenBW==1) G4AnalysisManager::Instance()->FillH1(1,ekin);
+    	if(fEventAction->fCount_neutron_source2nitrogenBW==1) FillH1(1,ekin);
     }
   	
   	// Neutrons exiting shield (from shield to world)
     if(preLogical == fDetector->fGammaShield_l && postLogical == fDetector->fWorld_l)	{
     	fEventAction->fCount_neutron_shield2world++;
-    	if(fEventAction->fCount_neutron_shield2world==1) G4AnalysisManager::Instance()->FillH1(2,ekin);
+    	if(fEventAction->fCount_neutron_shield2world==1) FillH1(2,ekin);
     }
     
     // Neutrons entering liquid argon
     if(postLogical == fDetector->fPool_l)	{
     	fEventAction->fCount_neutron_all2argon++;
-    	if(fEventAction->fCount_neutron_all2argon==1) G4AnalysisManager::Instance()->FillH1(3,ekin);
+    	if(fEventAction->fCount_neutron_all2argon==1) FillH1(3,ekin);
+    	Records::Instance()->AddCrossing(RecordSchema::kNeutronEnterArgon, position, ekin, time);
+    	StreamSink::Instance()->AddCrossing(RecordSchema::kNeutronEnterArgon, position, ekin, time);
     }
     
     // Neutrons exiting cryostat (from cryostat to world)
     if(preLogical == fDetector->fSteelPlate_l && postLogical == fDetector->fWorld_l)	{
     	fEventAction->fCount_neutron_cryostat2world++;
     	if(fEventAction->fCount_neutron_cryostat2world==1) {
-    		G4AnalysisManager::Instance()->FillH1(4,ekin);
-    		G4AnalysisManager::Instance()->FillNtupleDColumn(0, 0, x/1000); // ID, column, value
-    		G4AnalysisManager::Instance()->FillNtupleDColumn(0, 1, y/1000); // ID, column, value
-    		G4AnalysisManager::Instance()->FillNtupleDColumn(0, 2, z/1000); // ID, column, value
-    		G4AnalysisManager::Instance()->FillNtupleIColumn(0, 3, 0); //ID, column, tag
-        G4AnalysisManager::Instance()->AddNtupleRow(0); 	
+    		FillH1(4,ekin);
+    		if (HistoManager::IsNtupleActive(0)) {
+    			G4AnalysisManager::Instance()->FillNtupleDColumn(0, 0, x/1000); // ID, column, value
+    			G4AnalysisManager::Instance()->FillNtupleDColumn(0, 1, y/1000); // ID, column, value
+    			G4AnalysisManager::Instance()->FillNtupleDColumn(0, 2, z/1000); // ID, column, value
+    			G4AnalysisManager::Instance()->FillNtupleIColumn(0, 3, 0); //ID, column, tag
+    			G4AnalysisManager::Instance()->AddNtupleRow(0); 	
+    			run->CountNtupleRow(0);
+    		}
+        Records::Instance()->AddCrossing(RecordSchema::kNeutronExitCryostat, position, ekin, time);
+        StreamSink::Instance()->AddCrossing(RecordSchema::kNeutronExitCryostat, position, ekin, time);
     	}
     }
     
     // Neutrons entering world
     if(postLogical == fDetector->fWorld_l)	{
     	fEventAction->fCount_neutron_all2world++;
-    	if(fEventAction->fCount_neutron_all2world==1) G4AnalysisManager::Instance()->FillH1(5,ekin);
+    	if(fEventAction->fCount_neutron_all2world==1) FillH1(5,ekin);
     }
     
     // Neutron entering test planes  
-    if(postLogical == fDetector->fTestPlane1_l) G4AnalysisManager::Instance()->FillH2(0, x, y);
-    if(postLogical == fDetector->fTestPlane2_l) G4AnalysisManager::Instance()->FillH2(1, x, y);
-    if(postLogical == fDetector->fTestPlane3_l) G4AnalysisManager::Instance()->FillH2(2, x, y);      
-    if(postLogical == fDetector->fTestPlane4_l) G4AnalysisManager::Instance()->FillH2(3, x, y); 
-    if(postLogical == fDetector->fTestPlane5_l) G4AnalysisManager::Instance()->FillH2(4, x, z);
-    if(postLogical == fDetector->fTestPlane6_l) G4AnalysisManager::Instance()->FillH2(5, x, z); 
+    if(postLogical == fDetector->fTestPlane1_l) HistoManager::FillH2(0, x, y);
+    if(postLogical == fDetector->fTestPlane2_l) HistoManager::FillH2(1, x, y);
+    if(postLogical == fDetector->fTestPlane3_l) HistoManager::FillH2(2, x, y);      
+    if(postLogical == fDetector->fTestPlane4_l) HistoManager::FillH2(3, x, y); 
+    if(postLogical == fDetector->fTestPlane5_l) HistoManager::FillH2(4, x, z);
+    if(postLogical == fDetector->fTestPlane6_l) HistoManager::FillH2(5, x, z); 
       
   } 
   
   // Neutron capture
   if(particleName == "neutron" && processName == "nCapture" && postLogical == fDetector->fPool_l ) {
-  	G4AnalysisManager::Instance()->FillH1(11,time); 	
-    G4AnalysisManager::Instance()->FillNtupleDColumn(1, 0, x/1000); // ID, column, value
-    G4AnalysisManager::Instance()->FillNtupleDColumn(1, 1, y/1000); // ID, column, value
-    G4AnalysisManager::Instance()->FillNtupleDColumn(1, 2, z/1000); // ID, column, value
-    G4AnalysisManager::Instance()->FillNtupleDColumn(1, 3, time); // ID, column, value
-    G4AnalysisManager::Instance()->FillNtupleIColumn(1, 4, 0); //ID, column, tag
-    G4AnalysisManager::Instance()->AddNtupleRow(1); 	
+    fEventAction->fCount_neutron_argonCapture++;
+  	FillH1(11,time); 	
+    if (HistoManager::IsNtupleActive(1)) {
+      G4AnalysisManager::Instance()->FillNtupleDColumn(1, 0, x/1000); // ID, column, value
+      G4AnalysisManager::Instance()->FillNtupleDColumn(1, 1, y/1000); // ID, column, value
+      G4AnalysisManager::Instance()->FillNtupleDColumn(1, 2, z/1000); // ID, column, value
+      G4AnalysisManager::Instance()->FillNtupleDColumn(1, 3, time); // ID, column, value
+      G4AnalysisManager::Instance()->FillNtupleIColumn(1, 4, 0); //ID, column, tag
+      G4AnalysisManager::Instance()->AddNtupleRow(1); 	
+      run->CountNtupleRow(1);
+    }
+    
+    // capture gammas, one by one and summed over the cascade
+    const std::vector<const G4Track*>* secondaries = step->GetSecondaryInCurrentStep();
+    G4double gammaSum = 0.;
+    for (size_t i=0; i<secondaries->size(); ++i) {
+      const G4Track* secondary = (*secondaries)[i];
+      if (secondary->GetDefinition() != G4Gamma::Gamma()) continue;
+      FillH1(12, secondary->GetKineticEnergy());
+      gammaSum += secondary->GetKineticEnergy();
+    }
+    if (gammaSum > 0.) FillH1(13, gammaSum);
+    Records::Instance()->AddCapture(position, time, gammaSum);
+    StreamSink::Instance()->AddCapture(position, time, gammaSum);
   }
   
   // Gammas passing through boundary
@@ -154,41 +202,46 @@ void SteppingAction::UserSteppingAction(const G4Step* step)
   	
   	// Gammas entering shield
   	if(preLogical == fDetector->fNeutronShield_l && postLogical == fDetector->fGammaShield_l)	{
-    	G4AnalysisManager::Instance()->FillH1(6,ekin);
+    	FillH1(6,ekin);
     }
   	
     // Gammas exiting shield
     if(preLogical == fDetector->fGammaShield_l && postLogical == fDetector->fWorld_l)	{
-    	G4AnalysisManager::Instance()->FillH1(7,ekin);
+    	FillH1(7,ekin);
     }
     
     // Gammas entering liquid argon
     if(postLogical == fDetector->fPool_l)	{
-    	G4AnalysisManager::Instance()->FillH1(8,ekin);
+    	FillH1(8,ekin);
     }
     
     // Gammas exiting cryostat
     if(preLogical == fDetector->fSteelPlate_l && postLogical == fDetector->fWorld_l)	{
-    	G4AnalysisManager::Instance()->FillH1(9,ekin);
-    	G4AnalysisManager::Instance()->FillNtupleDColumn(2, 0, x/1000); // ID, column, value
-    	G4AnalysisManager::Instance()->FillNtupleDColumn(2, 1, y/1000); // ID, column, value
-    	G4AnalysisManager::Instance()->FillNtupleDColumn(2, 2, z/1000); // ID, column, value
-    	G4AnalysisManager::Instance()->FillNtupleIColumn(2, 3, 0); //ID, column, tag
-      G4AnalysisManager::Instance()->AddNtupleRow(2); 	
+    	FillH1(9,ekin);
+    	if (HistoManager::IsNtupleActive(2)) {
+    		G4AnalysisManager::Instance()->FillNtupleDColumn(2, 0, x/1000); // ID, column, value
+    		G4AnalysisManager::Instance()->FillNtupleDColumn(2, 1, y/1000); // ID, column, value
+    		G4AnalysisManager::Instance()->FillNtupleDColumn(2, 2, z/1000); // ID, column, value
+    		G4AnalysisManager::Instance()->FillNtupleIColumn(2, 3, 0); //ID, column, tag
+    		G4AnalysisManager::Instance()->AddNtupleRow(2); 	
+    		run->CountNtupleRow(2);
+    	}
+      Records::Instance()->AddCrossing(RecordSchema::kGammaExitCryostat, position, ekin, time);
+      StreamSink::Instance()->AddCrossing(RecordSchema::kGammaExitCryostat, position, ekin, time);
     }
     
     // Gammas entering world
     if(postLogical == fDetector->fWorld_l)	{
-    	G4AnalysisManager::Instance()->FillH1(10,ekin);
+    	FillH1(10,ekin);
     }
     
     // Gamma test planes
-    if(postLogical == fDetector->fTestPlane1_l) G4AnalysisManager::Instance()->FillH2(6, x, y);
-    if(postLogical == fDetector->fTestPlane2_l) G4AnalysisManager::Instance()->FillH2(7, x, y);
-    if(postLogical == fDetector->fTestPlane3_l) G4AnalysisManager::Instance()->FillH2(8, x, y);
-    if(postLogical == fDetector->fTestPlane4_l) G4AnalysisManager::Instance()->FillH2(9, x, y);
-    if(postLogical == fDetector->fTestPlane5_l) G4AnalysisManager::Instance()->FillH2(10, x, z);
-    if(postLogical == fDetector->fTestPlane6_l) G4AnalysisManager::Instance()->FillH2(11, x, z);
+    if(postLogical == fDetector->fTestPlane1_l) HistoManager::FillH2(6, x, y);
+    if(postLogical == fDetector->fTestPlane2_l) HistoManager::FillH2(7, x, y);
+    if(postLogical == fDetector->fTestPlane3_l) HistoManager::FillH2(8, x, y);
+    if(postLogical == fDetector->fTestPlane4_l) HistoManager::FillH2(9, x, y);
+    if(postLogical == fDetector->fTestPlane5_l) HistoManager::FillH2(10, x, z);
+    if(postLogical == fDetector->fTestPlane6_l) HistoManager::FillH2(11, x, z);
     
   }
   
@@ -0,0 +1,570 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StreamSink.cc
+/// \brief Implementation of the StreamSink class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "StreamSink.hh"
+#include "StreamSinkMessenger.hh"
+#include "RandomStreams.hh"
+#include "HistoManager.hh"
+#include "Run.hh"
+
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+  // bytes waiting for a slow consumer, before batches are discarded
+  const size_t kMaxPending = 8*1024*1024;
+  
+  // batches, event and histogram entries of this thread
+  struct ThreadStream {
+    ThreadStream() : fLane(-1), fEvent(0), fRun(-1), fBatchStart(0.),
+                     fEntries(0)
+    { for (G4int i=0; i<RecordSchema::kNbTables; ++i) fChunks[i] = 0; }
+    G4int                  fLane;      // -1 not yet given, -2 none left
+    uint32_t               fEvent;
+    G4int                  fRun;
+    G4double               fBatchStart;
+    RecordChunk*           fChunks[RecordSchema::kNbTables];
+    std::atomic<uint64_t>* fEntries;
+  };
+  G4ThreadLocal ThreadStream* threadStream = 0;
+  
+  template <class T> void Put(std::vector<char>& out, T value)
+  {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+  }
+  
+  void PutName(std::vector<char>& out, const char* name)
+  {
+    Put<uint8_t>(out, std::strlen(name));
+    out.insert(out.end(), name, name + std::strlen(name));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StreamSink* StreamSink::Instance()
+{
+  static StreamSink instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StreamSink::StreamSink()
+: fPath("hadr04.stream"), fSocket(false), fEnabled(false), fPeriod(1.),
+  fBatchRows(1024), fActive(false), fRunID(0), fRunCount(0), fStart(0.),
+  fNbEntries(0), fH1Mask(0), fNbLanes(0), fNbDropped(0), fStop(false), 
+  fFd(-1), fPendingStart(0), fSequence(0), fNbSent(0), fNbDiscarded(0),
+  fMessenger(0)
+{
+  // argon entry spectrum of the neutrons
+  fH1Ids.push_back(3);
+  for (G4int i=0; i<kMaxH1; ++i) fSpectrumIndex[i] = -1;
+  fMessenger = new StreamSinkMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StreamSink::~StreamSink()
+{
+  EndOfRun();
+  if (fFd >= 0) close(fFd);
+  G4int nbLanes = std::min(fNbLanes.load(), kMaxLanes);
+  for (G4int i=0; i<nbLanes; ++i) {
+    delete [] fLanes[i].fEntries.exchange(0);
+    for (G4int t=0; t<RecordSchema::kNbTables; ++t) {
+      RecordChunk* chunk = 0;
+      while (fLanes[i].fFree[t].Pop(chunk)) delete chunk;
+    }
+  }
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::AddH1(G4int id)
+{
+  if (id < 0 || id >= kMaxH1) {
+    G4cout << "### StreamSink: H1 " << id << " out of 0-" << kMaxH1-1 
+           << G4endl;
+    return;
+  }
+  if (std::find(fH1Ids.begin(), fH1Ids.end(), id) == fH1Ids.end()) {
+    fH1Ids.push_back(id);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::BeginOfRun(G4int runID)
+{
+  fActive = false;
+  fH1Mask = 0;
+  if (!fEnabled || fSender.joinable()) return;
+  
+  // histogram entries of the previous run
+  G4int nbLanes = std::min(fNbLanes.load(), kMaxLanes);
+  for (G4int i=0; i<nbLanes; ++i) delete [] fLanes[i].fEntries.exchange(0);
+  
+  // binning of the H1s streamed, as set by /analysis/h1/set
+  G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+  fSpectra.clear();
+  fNbEntries = 0;
+  for (G4int i=0; i<kMaxH1; ++i) fSpectrumIndex[i] = -1;
+  uint64_t mask = 0;
+  for (size_t i=0; i<fH1Ids.size(); ++i) {
+    G4int id = fH1Ids[i];
+    tools::histo::h1d* h1 = analysisManager->GetH1(id, false, true);
+    if (!h1) {
+      G4cout << "### StreamSink: H1 " << id << " is not active: not streamed"
+             << G4endl;
+      continue;
+    }
+    Spectrum spectrum;
+    spectrum.fId = id;
+    spectrum.fUnit = analysisManager->GetH1Unit(id);
+    G4int nbBins = h1->axis().bins();
+    for (G4int b=0; b<nbBins; ++b) {
+      spectrum.fEdges.push_back(h1->axis().bin_lower_edge(b));
+    }
+    spectrum.fEdges.push_back(h1->axis().upper_edge());
+    spectrum.fOffset = fNbEntries;
+    fNbEntries += nbBins + 2;
+    fSpectrumIndex[id] = fSpectra.size();
+    fSpectra.push_back(spectrum);
+    mask |= (uint64_t)1 << id;
+  }
+  
+  fRunID = runID;
+  fRunCount++;
+  fStart = Run::WallClock();
+  fNbDropped = 0;
+  fNbSent = fNbDiscarded = 0;
+  fActive = true;
+  fH1Mask = mask;
+  
+  fStop = false;
+  fSender = std::thread(&StreamSink::Sender, this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::EndOfRun()
+{
+  if (!fSender.joinable()) return;
+  fH1Mask = 0;
+  {
+    std::lock_guard<std::mutex> lock(fStopMutex);
+    fStop = true;
+  }
+  fStopCondition.notify_all();
+  fSender.join();
+  fActive = false;
+  
+  G4cout << "\n Stream to " << fPath << ": " << fNbSent << " batches sent, "
+         << fNbDropped << " dropped (full queues), " << fNbDiscarded 
+         << " discarded (no consumer, or consumer behind)" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StreamSink::Lane* StreamSink::GetLane()
+{
+  if (!threadStream) threadStream = new ThreadStream;
+  if (threadStream->fLane == -1) {
+    G4int lane = fNbLanes.fetch_add(1);
+    threadStream->fLane = lane < kMaxLanes ? lane : -2;
+  }
+  return threadStream->fLane >= 0 ? &fLanes[threadStream->fLane] : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::BeginOfEvent(G4int eventID)
+{
+  if (!fActive) return;
+  if (!threadStream) threadStream = new ThreadStream;
+  RandomStreams* streams = RandomStreams::Instance();
+  threadStream->fEvent = streams->IsCounterBased() ?
+    (uint32_t)streams->GetStreamIndex(eventID) : (uint32_t)eventID;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RecordChunk* StreamSink::GetChunk(G4int table)
+{
+  RecordChunk*& chunk = threadStream->fChunks[table];
+  if (chunk && (G4int)chunk->GetCapacity() != fBatchRows) {
+    delete chunk;
+    chunk = 0;
+  }
+  if (!chunk) chunk = new RecordChunk(table, fBatchRows);
+  return chunk;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::AddCrossing(G4int code, const G4ThreeVector& position, 
+                             G4double energy, G4double time)
+{
+  if (!fActive) return;
+  RecordChunk* chunk = GetChunk(RecordSchema::kCrossing);
+  RecordSchema::AppendCrossing(*chunk, threadStream->fEvent, code, position,
+                               energy, time);
+  if (chunk->IsFull()) Hand(threadStream->fChunks[RecordSchema::kCrossing]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::AddCapture(const G4ThreeVector& position, G4double time, 
+                            G4double gammaSum)
+{
+  if (!fActive) return;
+  RecordChunk* chunk = GetChunk(RecordSchema::kCapture);
+  RecordSchema::AppendCapture(*chunk, threadStream->fEvent, position, time,
+                              gammaSum);
+  if (chunk->IsFull()) Hand(threadStream->fChunks[RecordSchema::kCapture]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::Hand(RecordChunk*& chunk)
+{
+  // never wait: a batch that does not fit in the queue is dropped
+  G4int table = chunk->GetTable();
+  size_t capacity = chunk->GetCapacity();
+  Lane* lane = GetLane();
+  if (!lane || !lane->fFull.Push(chunk)) {
+    fNbDropped++;
+    chunk->Clear();
+    return;
+  }
+  
+  // a batch sent by the sender thread, or a new one
+  RecordChunk* empty = 0;
+  while (lane->fFree[table].Pop(empty)) {
+    if (empty->GetCapacity() == capacity) { chunk = empty; return; }
+    delete empty;
+  }
+  chunk = new RecordChunk(table, capacity);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::EndOfEvent()
+{
+  // batches at most one period old
+  if (!fActive || !threadStream) return;
+  G4double now = Run::WallClock();
+  if (now - threadStream->fBatchStart < fPeriod) return;
+  threadStream->fBatchStart = now;
+  for (G4int i=0; i<RecordSchema::kNbTables; ++i) {
+    RecordChunk*& chunk = threadStream->fChunks[i];
+    if (chunk && chunk->GetNbRows() > 0) Hand(chunk);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::EndOfThreadRun()
+{
+  if (!fActive || !threadStream) return;
+  for (G4int i=0; i<RecordSchema::kNbTables; ++i) {
+    RecordChunk*& chunk = threadStream->fChunks[i];
+    if (chunk && chunk->GetNbRows() > 0) Hand(chunk);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::Count(G4int id, G4double value)
+{
+  if (!threadStream) threadStream = new ThreadStream;
+  ThreadStream& stream = *threadStream;
+  if (stream.fRun != fRunCount) {
+    stream.fRun = fRunCount;
+    stream.fEntries = 0;
+  }
+  if (!stream.fEntries) {
+    Lane* lane = GetLane();
+    if (!lane) return;
+    stream.fEntries = new std::atomic<uint64_t>[fNbEntries];
+    for (size_t i=0; i<fNbEntries; ++i) stream.fEntries[i] = 0;
+    lane->fEntries.store(stream.fEntries, std::memory_order_release);
+  }
+  
+  // bin 0 underflow, bins+1 overflow, as the analysis manager
+  const Spectrum& spectrum = fSpectra[fSpectrumIndex[id]];
+  G4double x = value/spectrum.fUnit;
+  size_t bin = std::upper_bound(spectrum.fEdges.begin(), 
+                                spectrum.fEdges.end(), x) 
+             - spectrum.fEdges.begin();
+  
+  // single writer per slot: relaxed load and store, no read-modify-write
+  std::atomic<uint64_t>& entries = stream.fEntries[spectrum.fOffset + bin];
+  entries.store(entries.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::Sender()
+{
+  // a consumer gone is seen as EPIPE, not as a signal to the process
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &signals, 0);
+  
+  fLastConnect = -1.e9;
+  if (fFd >= 0) Hello();
+  G4double lastSnapshot = Run::WallClock();
+  
+  std::unique_lock<std::mutex> lock(fStopMutex);
+  G4bool last = false;
+  while (!last) {
+    fStopCondition.wait_for(lock, std::chrono::milliseconds(20));
+    last = fStop;
+    lock.unlock();
+    Connect();
+    Drain();
+    G4double now = Run::WallClock();
+    if (last || now - lastSnapshot >= fPeriod) {
+      Snapshot(last);
+      lastSnapshot = now;
+    }
+    Send(last);
+    lock.lock();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::Connect()
+{
+  // one attempt per period while there is no consumer
+  G4double now = Run::WallClock();
+  if (fFd >= 0 || now - fLastConnect < fPeriod) return;
+  fLastConnect = now;
+  
+  G4int fd = -1;
+  if (fSocket) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, fPath.c_str(), sizeof(address.sun_path)-1);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && 
+        connect(fd, (const sockaddr*)&address, sizeof(address)) != 0) {
+      close(fd);
+      fd = -1;
+    }
+    if (fd >= 0) fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  } 
+  else {
+    // fails (ENXIO) as long as no consumer has the pipe open
+    struct stat status;
+    if (stat(fPath.c_str(), &status) != 0) mkfifo(fPath.c_str(), 0644);
+    fd = open(fPath.c_str(), O_WRONLY | O_NONBLOCK);
+  }
+  if (fd < 0) return;
+  
+  fFd = fd;
+  fPending.clear();
+  fPendingStart = 0;
+  Hello();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::Disconnect()
+{
+  if (fFd >= 0) close(fFd);
+  fFd = -1;
+  fPending.clear();
+  fPendingStart = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::Hello()
+{
+  std::vector<char> payload;
+  Put<uint32_t>(payload, fRunID);
+  Put<uint32_t>(payload, RecordSchema::kNbTables);
+  for (G4int t=0; t<RecordSchema::kNbTables; ++t) {
+    const RecordSchema::Table& table = RecordSchema::GetTable(t);
+    PutName(payload, table.fName);
+    Put<uint32_t>(payload, table.fNbColumns);
+    for (G4int i=0; i<table.fNbColumns; ++i) {
+      Put<uint8_t>(payload, table.fColumns[i].fType);
+      PutName(payload, table.fColumns[i].fName);
+    }
+  }
+  Frame(kHello, payload);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::Frame(G4int type, const std::vector<char>& payload)
+{
+  if (fFd < 0) return;
+  fPending.insert(fPending.end(), "H04S", "H04S" + 4);
+  Put<uint16_t>(fPending, type);
+  Put<uint16_t>(fPending, 1);
+  Put<uint32_t>(fPending, payload.size());
+  Put<uint32_t>(fPending, fSequence++);
+  fPending.insert(fPending.end(), payload.begin(), payload.end());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::Drain()
+{
+  std::vector<char> payload;
+  G4int nbLanes = std::min(fNbLanes.load(), kMaxLanes);
+  for (G4int i=0; i<nbLanes; ++i) {
+    Lane& lane = fLanes[i];
+    RecordChunk* chunk = 0;
+    while (lane.fFull.Pop(chunk)) {
+      if (fFd >= 0 && fPending.size() - fPendingStart < kMaxPending) {
+        const RecordSchema::Table& table = 
+          RecordSchema::GetTable(chunk->GetTable());
+        payload.clear();
+        Put<uint8_t>(payload, chunk->GetTable());
+        payload.resize(payload.size() + 3, 0);
+        Put<uint32_t>(payload, i);
+        Put<uint32_t>(payload, chunk->GetNbRows());
+        for (G4int c=0; c<table.fNbColumns; ++c) {
+          const std::vector<char>& column = chunk->GetColumn(c);
+          payload.insert(payload.end(), column.begin(), column.end());
+        }
+        Frame(kBatch, payload);
+        fNbSent++;
+      }
+      else fNbDiscarded++;
+      
+      chunk->Clear();
+      if (!lane.fFree[chunk->GetTable()].Push(chunk)) delete chunk;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::Snapshot(G4bool last)
+{
+  if (fFd < 0) return;
+  
+  G4int nbLanes = std::min(fNbLanes.load(), kMaxLanes);
+  std::vector<char> payload;
+  for (size_t s=0; s<fSpectra.size(); ++s) {
+    const Spectrum& spectrum = fSpectra[s];
+    size_t nbEntries = spectrum.fEdges.size() + 1;
+    std::vector<uint64_t> entries(nbEntries, 0);
+    for (G4int i=0; i<nbLanes; ++i) {
+      const std::atomic<uint64_t>* slot = 
+        fLanes[i].fEntries.load(std::memory_order_acquire);
+      if (!slot) continue;
+      for (size_t b=0; b<nbEntries; ++b) {
+        entries[b] += slot[spectrum.fOffset + b].load(std::memory_order_relaxed);
+      }
+    }
+    payload.clear();
+    Put<uint32_t>(payload, spectrum.fId);
+    Put<uint32_t>(payload, nbEntries - 2);
+    Put<double>(payload, Run::WallClock() - fStart);
+    for (size_t b=0; b<spectrum.fEdges.size(); ++b) {
+      Put<double>(payload, spectrum.fEdges[b]);
+    }
+    for (size_t b=0; b<nbEntries; ++b) Put<uint64_t>(payload, entries[b]);
+    Frame(kHistogram, payload);
+  }
+  
+  payload.clear();
+  Put<uint64_t>(payload, fNbSent);
+  Put<uint64_t>(payload, fNbDropped.load());
+  Put<uint64_t>(payload, fNbDiscarded);
+  Frame(kStats, payload);
+  
+  if (last) {
+    payload.clear();
+    Put<uint32_t>(payload, fRunID);
+    Frame(kEndOfRun, payload);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSink::Send(G4bool last)
+{
+  // at the end of the run, up to one second for the consumer to catch up
+  G4double deadline = Run::WallClock() + (last ? 1. : 0.);
+  while (fFd >= 0 && fPendingStart < fPending.size()) {
+    const char* data = &fPending[fPendingStart];
+    size_t size = fPending.size() - fPendingStart;
+    ssize_t n = fSocket ? send(fFd, data, size, MSG_NOSIGNAL | MSG_DONTWAIT)
+                        : write(fFd, data, size);
+    if (n > 0) {
+      fPendingStart += n;
+      continue;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+      if (Run::WallClock() >= deadline) break;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+    // the consumer is gone
+    Disconnect();
+  }
+  if (fPendingStart == fPending.size()) {
+    fPending.clear();
+    fPendingStart = 0;
+  }
+  else if (fPendingStart > fPending.size()/2) {
+    fPending.erase(fPending.begin(), fPending.begin() + fPendingStart);
+    fPendingStart = 0;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,142 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StreamSinkMessenger.cc
+/// \brief Implementation of the StreamSinkMessenger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "StreamSinkMessenger.hh"
+
+#include "StreamSink.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StreamSinkMessenger::StreamSinkMessenger(StreamSink* sink)
+:G4UImessenger(),fSink(sink),
+ fStreamDir(0), fFifoCmd(0), fSocketCmd(0), fEnableCmd(0), fPeriodCmd(0),
+ fBatchRowsCmd(0), fH1Cmd(0), fClearH1Cmd(0)
+{ 
+  G4bool broadcast = false;
+  fStreamDir = new G4UIdirectory("/testhadr/stream/",broadcast);
+  fStreamDir->SetGuidance("live stream of records and histograms");
+  
+  fFifoCmd = new G4UIcmdWithAString("/testhadr/stream/fifo",this);
+  fFifoCmd->SetGuidance("stream to a named pipe, created if needed");
+  fFifoCmd->SetParameterName("path",false);
+  fFifoCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fFifoCmd->SetToBeBroadcasted(false);
+  
+  fSocketCmd = new G4UIcmdWithAString("/testhadr/stream/socket",this);
+  fSocketCmd->SetGuidance("stream to a UNIX domain socket, the consumer listening");
+  fSocketCmd->SetParameterName("path",false);
+  fSocketCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fSocketCmd->SetToBeBroadcasted(false);
+  
+  fEnableCmd = new G4UIcmdWithABool("/testhadr/stream/enable",this);
+  fEnableCmd->SetGuidance("stream the next runs");
+  fEnableCmd->SetParameterName("flag",true);
+  fEnableCmd->SetDefaultValue(true);
+  fEnableCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fEnableCmd->SetToBeBroadcasted(false);
+  
+  fPeriodCmd = new G4UIcmdWithADouble("/testhadr/stream/period",this);
+  fPeriodCmd->SetGuidance("seconds between histogram snapshots;");
+  fPeriodCmd->SetGuidance("  also the maximal age of a batch of records");
+  fPeriodCmd->SetParameterName("seconds",false);
+  fPeriodCmd->SetRange("seconds>0.");
+  fPeriodCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fPeriodCmd->SetToBeBroadcasted(false);
+  
+  fBatchRowsCmd = new G4UIcmdWithAnInteger("/testhadr/stream/batchRows",this);
+  fBatchRowsCmd->SetGuidance("maximal records per batch");
+  fBatchRowsCmd->SetParameterName("n",false);
+  fBatchRowsCmd->SetRange("n>0");
+  fBatchRowsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fBatchRowsCmd->SetToBeBroadcasted(false);
+  
+  fH1Cmd = new G4UIcmdWithAnInteger("/testhadr/stream/h1",this);
+  fH1Cmd->SetGuidance("add an active H1 to the snapshots (default: 3)");
+  fH1Cmd->SetParameterName("id",false);
+  fH1Cmd->SetRange("id>=0");
+  fH1Cmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fH1Cmd->SetToBeBroadcasted(false);
+  
+  fClearH1Cmd = new G4UIcmdWithoutParameter("/testhadr/stream/clearH1",this);
+  fClearH1Cmd->SetGuidance("no H1 in the snapshots");
+  fClearH1Cmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fClearH1Cmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StreamSinkMessenger::~StreamSinkMessenger()
+{
+  delete fFifoCmd;
+  delete fSocketCmd;
+  delete fEnableCmd;
+  delete fPeriodCmd;
+  delete fBatchRowsCmd;
+  delete fH1Cmd;
+  delete fClearH1Cmd;
+  delete fStreamDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StreamSinkMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{   
+  if (command == fFifoCmd)
+   {fSink->SetTarget(newValue, false);}
+   
+  if (command == fSocketCmd)
+   {fSink->SetTarget(newValue, true);}
+   
+  if (command == fEnableCmd)
+   {fSink->SetEnabled(fEnableCmd->GetNewBoolValue(newValue));}
+   
+  if (command == fPeriodCmd)
+   {fSink->SetPeriod(fPeriodCmd->GetNewDoubleValue(newValue));}
+   
+  if (command == fBatchRowsCmd)
+   {fSink->SetBatchRows(fBatchRowsCmd->GetNewIntValue(newValue));}
+   
+  if (command == fH1Cmd)
+   {fSink->AddH1(fH1Cmd->GetNewIntValue(newValue));}
+   
+  if (command == fClearH1Cmd)
+   {fSink->ClearH1s();}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
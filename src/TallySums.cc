@@ -0,0 +1,185 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file TallySums.cc
+/// \brief Implementation of the TallySums class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "TallySums.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+  G4bool WriteString(std::FILE* file, const G4String& text)
+  {
+    uint32_t length = text.size();
+    return std::fwrite(&length, sizeof(length), 1, file) == 1
+        && std::fwrite(text.data(), 1, length, file) == length;
+  }
+  
+  G4bool ReadString(std::FILE* file, G4String& text)
+  {
+    uint32_t length = 0;
+    if (std::fread(&length, sizeof(length), 1, file) != 1) return false;
+    std::string buffer(length, ' ');
+    if (length > 0 && std::fread(&buffer[0], 1, length, file) != length) {
+      return false;
+    }
+    text = buffer;
+    return true;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TallySums::TallySums(const G4String& title, const G4String& columns)
+: fTitle(title), fColumns(columns), fNbEvents(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TallySums::~TallySums()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TallySums::AddEntry(const G4String& key, G4double scale, 
+                         G4double sum, G4double sum2)
+{
+  Entry entry = { key, scale, sum, sum2 };
+  fEntries.push_back(entry);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool TallySums::Add(const TallySums& other)
+{
+  if (other.fEntries.size() != fEntries.size()) return false;
+  for (size_t i=0; i<fEntries.size(); ++i) {
+    if (other.fEntries[i].fKey != fEntries[i].fKey ||
+        other.fEntries[i].fScale != fEntries[i].fScale) return false;
+  }
+  for (size_t i=0; i<fEntries.size(); ++i) {
+    fEntries[i].fSum  += other.fEntries[i].fSum;
+    fEntries[i].fSum2 += other.fEntries[i].fSum2;
+  }
+  fNbEvents += other.fNbEvents;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool TallySums::Write(const G4String& fileName) const
+{
+  std::FILE* file = std::fopen(fileName.c_str(), "wb");
+  if (!file) return false;
+  
+  uint32_t version = 1;
+  uint64_t events = fNbEvents, entries = fEntries.size();
+  G4bool ok = std::fwrite("H04S", 1, 4, file) == 4
+           && std::fwrite(&version, sizeof(version), 1, file) == 1
+           && std::fwrite(&events, sizeof(events), 1, file) == 1
+           && WriteString(file, fTitle) && WriteString(file, fColumns)
+           && std::fwrite(&entries, sizeof(entries), 1, file) == 1;
+  for (size_t i=0; i<fEntries.size() && ok; ++i) {
+    const Entry& entry = fEntries[i];
+    G4double values[3] = { entry.fScale, entry.fSum, entry.fSum2 };
+    ok = WriteString(file, entry.fKey)
+      && std::fwrite(values, sizeof(values), 1, file) == 1;
+  }
+  ok &= (std::fclose(file) == 0);
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TallySums* TallySums::Read(const G4String& fileName)
+{
+  std::FILE* file = std::fopen(fileName.c_str(), "rb");
+  if (!file) return 0;
+  
+  char magic[4];
+  uint32_t version = 0;
+  uint64_t events = 0, entries = 0;
+  G4String title, columns;
+  G4bool ok = std::fread(magic, 1, 4, file) == 4
+           && std::memcmp(magic, "H04S", 4) == 0
+           && std::fread(&version, sizeof(version), 1, file) == 1
+           && version == 1
+           && std::fread(&events, sizeof(events), 1, file) == 1
+           && ReadString(file, title) && ReadString(file, columns)
+           && std::fread(&entries, sizeof(entries), 1, file) == 1;
+  
+  TallySums* sums = new TallySums(title, columns);
+  sums->fNbEvents = (G4long)events;
+  for (uint64_t i=0; i<entries && ok; ++i) {
+    G4String key;
+    G4double values[3];
+    ok = ReadString(file, key)
+      && std::fread(values, sizeof(values), 1, file) == 1;
+    if (ok) sums->AddEntry(key, values[0], values[1], values[2]);
+  }
+  std::fclose(file);
+  if (!ok) {
+    delete sums;
+    return 0;
+  }
+  return sums;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool TallySums::WriteText(const G4String& fileName) const
+{
+  std::ofstream out(fileName.c_str());
+  if (!out) return false;
+  
+  // relative error of the mean, -1 when undefined
+  G4double n = (G4double)fNbEvents;
+  out << "# " << fTitle << ", " << fNbEvents << " events\n"
+      << "# " << fColumns << "\n" 
+      << std::setprecision(6);
+  for (size_t i=0; i<fEntries.size(); ++i) {
+    const Entry& entry = fEntries[i];
+    G4double mean = (n > 0.) ? entry.fSum/n : 0., error = -1.;
+    if (n >= 2. && entry.fSum > 0.) {
+      G4double variance = std::max(0., entry.fSum2/n - mean*mean)*n/(n-1.);
+      error = std::sqrt(variance/n)/mean;
+    }
+    out << entry.fKey << " " << entry.fScale*mean << " " << error << "\n";
+  }
+  return out.good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
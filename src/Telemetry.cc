@@ -0,0 +1,333 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Telemetry.cc
+/// \brief Implementation of the Telemetry class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "Telemetry.hh"
+#include "TelemetryMessenger.hh"
+#include "Campaign.hh"
+#include "Run.hh"
+
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Telemetry* Telemetry::Instance()
+{
+  static Telemetry instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Telemetry::Telemetry()
+: fFileName("telemetry"), fPeriod(10.), fEnabled(false), 
+  fUnmonitored(false), fRunID(0), fNbEvents(0), fStart(0.), fLastTime(0.), fStop(false),
+  fDiscard(false), fMessenger(0)
+{
+  for (G4int i=0; i<kMaxSlots; ++i) {
+    fSlots[i].fEvents = 0;
+    fSlots[i].fSteps = 0;
+    for (G4int k=0; k<Convergence::kNbTallies; ++k) fSlots[i].fTallies[k] = 0;
+    fLastEvents[i] = fLastSteps[i] = 0;
+  }
+  char host[256] = "";
+  gethostname(host, sizeof(host)-1);
+  fHost = host;
+  fMessenger = new TelemetryMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Telemetry::~Telemetry()
+{
+  // the files are finished by EndOfRun, in the master EndOfRunAction; a
+  // monitor still running here (run not ended) is stopped without writing
+  if (fMonitor.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(fStopMutex);
+      fStop = fDiscard = true;
+    }
+    fStopCondition.notify_all();
+    fMonitor.join();
+  }
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+uint64_t Telemetry::ResidentMemory()
+{
+  // second field of statm, in pages
+  unsigned long size = 0, resident = 0;
+  FILE* statm = std::fopen("/proc/self/statm", "r");
+  if (!statm) return 0;
+  if (std::fscanf(statm, "%lu %lu", &size, &resident) != 2) resident = 0;
+  std::fclose(statm);
+  return (uint64_t)resident*(uint64_t)sysconf(_SC_PAGESIZE);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Telemetry::BeginOfRun(G4int runID, G4int nbEvents)
+{
+  if (!fEnabled || fMonitor.joinable()) return;
+  
+  for (G4int i=0; i<kMaxSlots; ++i) {
+    fSlots[i].fEvents.store(0, std::memory_order_relaxed);
+    fSlots[i].fSteps.store(0, std::memory_order_relaxed);
+    for (G4int k=0; k<Convergence::kNbTallies; ++k) {
+      fSlots[i].fTallies[k].store(0, std::memory_order_relaxed);
+    }
+    fLastEvents[i] = fLastSteps[i] = 0;
+  }
+  fUnmonitored.store(false, std::memory_order_relaxed);
+  fRunID = runID;
+  fNbEvents = nbEvents;
+  fStart = fLastTime = Run::WallClock();
+  
+  Campaign* campaign = Campaign::Instance();
+  fPromName = campaign->OutputName(fFileName + ".prom", ".prom");
+  fJsonName = campaign->OutputName(fFileName + ".jsonl", ".jsonl");
+  
+  fStop = false;
+  fMonitor = std::thread(&Telemetry::Monitor, this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Telemetry::EndOfRun()
+{
+  if (!fMonitor.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(fStopMutex);
+    fStop = true;
+  }
+  fStopCondition.notify_all();
+  fMonitor.join();
+  if (fUnmonitored.load(std::memory_order_relaxed)) {
+    G4cout << "### Telemetry: threads of ID " << kMaxSlots 
+           << " and beyond were not monitored" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Telemetry::EndOfEvent(G4long nbSteps, 
+                           const G4double scores[Convergence::kNbTallies])
+{
+  if (!fEnabled) return;
+  
+  // single writer per slot: relaxed load and store, no read-modify-write;
+  // no slot to share beyond kMaxSlots threads
+  G4int id = std::max(0, G4Threading::G4GetThreadId());
+  if (id >= kMaxSlots) {
+    fUnmonitored.store(true, std::memory_order_relaxed);
+    return;
+  }
+  Slot& slot = fSlots[id];
+  slot.fEvents.store(slot.fEvents.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+  slot.fSteps.store(slot.fSteps.load(std::memory_order_relaxed) + nbSteps,
+                    std::memory_order_relaxed);
+  for (G4int k=0; k<Convergence::kNbTallies; ++k) {
+    if (scores[k] <= 0.) continue;
+    slot.fTallies[k].store(slot.fTallies[k].load(std::memory_order_relaxed)
+                           + (uint64_t)scores[k], std::memory_order_relaxed);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Telemetry::Monitor()
+{
+  std::unique_lock<std::mutex> lock(fStopMutex);
+  while (!fStop) {
+    fStopCondition.wait_for(lock, std::chrono::duration<G4double>(fPeriod));
+    G4bool last = fStop;
+    if (fDiscard) break;
+    lock.unlock();
+    Publish(last);
+    lock.lock();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Telemetry::Publish(G4bool last)
+{
+  G4double now = Run::WallClock();
+  G4double elapsed = now - fStart;
+  G4double interval = std::max(now - fLastTime, 1.e-9);
+  fLastTime = now;
+  
+  // snapshot of the slots in use
+  std::vector<G4int> threads;
+  std::vector<uint64_t> events, steps;
+  std::vector<G4double> eventRates, stepRates;
+  uint64_t tallies[Convergence::kNbTallies] = { 0 };
+  uint64_t totalEvents = 0, totalSteps = 0;
+  G4double totalEventRate = 0., totalStepRate = 0.;
+  for (G4int i=0; i<kMaxSlots; ++i) {
+    const Slot& slot = fSlots[i];
+    uint64_t nbEvents = slot.fEvents.load(std::memory_order_relaxed);
+    if (nbEvents == 0) continue;
+    uint64_t nbSteps = slot.fSteps.load(std::memory_order_relaxed);
+    threads.push_back(i);
+    events.push_back(nbEvents);
+    steps.push_back(nbSteps);
+    eventRates.push_back((nbEvents - fLastEvents[i])/interval);
+    stepRates.push_back((nbSteps - fLastSteps[i])/interval);
+    fLastEvents[i] = nbEvents;
+    fLastSteps[i] = nbSteps;
+    totalEvents += nbEvents;
+    totalSteps += nbSteps;
+    totalEventRate += eventRates.back();
+    totalStepRate += stepRates.back();
+    for (G4int k=0; k<Convergence::kNbTallies; ++k) {
+      tallies[k] += slot.fTallies[k].load(std::memory_order_relaxed);
+    }
+  }
+  uint64_t memory = ResidentMemory();
+  G4double eta = -1.;
+  if (totalEvents > 0 && fNbEvents > 0) {
+    eta = (fNbEvents - (G4double)totalEvents)*elapsed/totalEvents;
+    if (eta < 0.) eta = 0.;
+  }
+  Convergence* convergence = Convergence::Instance();
+  G4double relErrors[Convergence::kNbTallies];
+  for (G4int k=0; k<Convergence::kNbTallies; ++k) {
+    relErrors[k] = convergence->GetRelError(k);
+  }
+  
+  // Prometheus text format
+  std::ostringstream labels;
+  labels << "host=\"" << fHost << "\"";
+  if (Campaign::Instance()->IsProcess()) {
+    labels << ",process=\"" << Campaign::Instance()->GetIndex() << "\"";
+  }
+  std::ostringstream prom;
+  prom << "# HELP hadr04_run_id Current run\n# TYPE hadr04_run_id gauge\n"
+       << "hadr04_run_id{" << labels.str() << "} " << fRunID << "\n"
+       << "# HELP hadr04_run_events_requested Events of the run\n"
+       << "# TYPE hadr04_run_events_requested gauge\n"
+       << "hadr04_run_events_requested{" << labels.str() << "} " 
+       << fNbEvents << "\n"
+       << "# HELP hadr04_run_elapsed_seconds Wall time since the run start\n"
+       << "# TYPE hadr04_run_elapsed_seconds gauge\n"
+       << "hadr04_run_elapsed_seconds{" << labels.str() << "} " 
+       << elapsed << "\n"
+       << "# HELP hadr04_run_eta_seconds Estimated time to completion\n"
+       << "# TYPE hadr04_run_eta_seconds gauge\n"
+       << "hadr04_run_eta_seconds{" << labels.str() << "} " << eta << "\n"
+       << "# HELP hadr04_resident_memory_bytes Resident memory of the process\n"
+       << "# TYPE hadr04_resident_memory_bytes gauge\n"
+       << "hadr04_resident_memory_bytes{" << labels.str() << "} " 
+       << memory << "\n";
+  prom << "# HELP hadr04_events_total Events done in the run, by thread\n"
+       << "# TYPE hadr04_events_total counter\n";
+  for (size_t i=0; i<threads.size(); ++i) {
+    prom << "hadr04_events_total{" << labels.str() << ",thread=\"" 
+         << threads[i] << "\"} " << events[i] << "\n";
+  }
+  prom << "# HELP hadr04_steps_total Steps done in the run, by thread\n"
+       << "# TYPE hadr04_steps_total counter\n";
+  for (size_t i=0; i<threads.size(); ++i) {
+    prom << "hadr04_steps_total{" << labels.str() << ",thread=\"" 
+         << threads[i] << "\"} " << steps[i] << "\n";
+  }
+  prom << "# HELP hadr04_events_per_second Event rate over the last period\n"
+       << "# TYPE hadr04_events_per_second gauge\n";
+  for (size_t i=0; i<threads.size(); ++i) {
+    prom << "hadr04_events_per_second{" << labels.str() << ",thread=\"" 
+         << threads[i] << "\"} " << eventRates[i] << "\n";
+  }
+  prom << "# HELP hadr04_steps_per_second Step rate over the last period\n"
+       << "# TYPE hadr04_steps_per_second gauge\n";
+  for (size_t i=0; i<threads.size(); ++i) {
+    prom << "hadr04_steps_per_second{" << labels.str() << ",thread=\"" 
+         << threads[i] << "\"} " << stepRates[i] << "\n";
+  }
+  prom << "# HELP hadr04_tally_total Counts of the key tallies\n"
+       << "# TYPE hadr04_tally_total counter\n";
+  for (G4int k=0; k<Convergence::kNbTallies; ++k) {
+    prom << "hadr04_tally_total{" << labels.str() << ",tally=\"" 
+         << Convergence::GetTallyName(k) << "\"} " << tallies[k] << "\n";
+  }
+  prom << "# HELP hadr04_tally_relative_error Relative error from the batch"
+       << " means, -1 if not yet defined\n"
+       << "# TYPE hadr04_tally_relative_error gauge\n";
+  for (G4int k=0; k<Convergence::kNbTallies; ++k) {
+    prom << "hadr04_tally_relative_error{" << labels.str() << ",tally=\"" 
+         << Convergence::GetTallyName(k) << "\"} " << relErrors[k] << "\n";
+  }
+  
+  // written aside, then renamed for the scraper
+  G4String tmpName = fPromName + ".tmp";
+  {
+    std::ofstream out(tmpName);
+    out << prom.str();
+  }
+  std::rename(tmpName.c_str(), fPromName.c_str());
+  
+  // JSON lines
+  std::ofstream json(fJsonName, std::ios::app);
+  json << "{\"time\":" << std::fixed << now << std::defaultfloat
+       << ",\"host\":\"" << fHost << "\",\"run\":" << fRunID 
+       << ",\"final\":" << (last ? "true" : "false")
+       << ",\"elapsed_s\":" << elapsed 
+       << ",\"events\":" << totalEvents << ",\"events_requested\":" << fNbEvents
+       << ",\"events_per_s\":" << totalEventRate 
+       << ",\"steps\":" << totalSteps << ",\"steps_per_s\":" << totalStepRate
+       << ",\"rss_bytes\":" << memory << ",\"eta_s\":" << eta
+       << ",\"threads\":[";
+  for (size_t i=0; i<threads.size(); ++i) {
+    json << (i ? "," : "") << "{\"id\":" << threads[i] 
+         << ",\"events\":" << events[i] << ",\"events_per_s\":" << eventRates[i]
+         << ",\"steps_per_s\":" << stepRates[i] << "}";
+  }
+  json << "],\"tallies\":{";
+  for (G4int k=0; k<Convergence::kNbTallies; ++k) {
+    json << (k ? "," : "") << "\"" << Convergence::GetTallyName(k) 
+         << "\":{\"count\":" << tallies[k] << ",\"rel_error\":" 
+         << relErrors[k] << "}";
+  }
+  json << "}}" << std::endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,98 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file TelemetryMessenger.cc
+/// \brief Implementation of the TelemetryMessenger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "TelemetryMessenger.hh"
+
+#include "Telemetry.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADouble.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TelemetryMessenger::TelemetryMessenger(Telemetry* telemetry)
+:G4UImessenger(),fTelemetry(telemetry),
+ fTelemetryDir(0), fEnableCmd(0), fFileCmd(0), fPeriodCmd(0)
+{ 
+  G4bool broadcast = false;
+  fTelemetryDir = new G4UIdirectory("/testhadr/telemetry/",broadcast);
+  fTelemetryDir->SetGuidance("live telemetry files of the runs");
+  
+  fEnableCmd = new G4UIcmdWithABool("/testhadr/telemetry/enable",this);
+  fEnableCmd->SetGuidance("write the telemetry files during the runs");
+  fEnableCmd->SetParameterName("flag",true);
+  fEnableCmd->SetDefaultValue(true);
+  fEnableCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fEnableCmd->SetToBeBroadcasted(false);
+  
+  fFileCmd = new G4UIcmdWithAString("/testhadr/telemetry/file",this);
+  fFileCmd->SetGuidance("name of the files, without extension:");
+  fFileCmd->SetGuidance("  name.prom (Prometheus text) and name.jsonl");
+  fFileCmd->SetParameterName("name",false);
+  fFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fFileCmd->SetToBeBroadcasted(false);
+  
+  fPeriodCmd = new G4UIcmdWithADouble("/testhadr/telemetry/period",this);
+  fPeriodCmd->SetGuidance("seconds between two writes");
+  fPeriodCmd->SetParameterName("t",false);
+  fPeriodCmd->SetRange("t>0.");
+  fPeriodCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fPeriodCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TelemetryMessenger::~TelemetryMessenger()
+{
+  delete fEnableCmd;
+  delete fFileCmd;
+  delete fPeriodCmd;
+  delete fTelemetryDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TelemetryMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{   
+  if (command == fEnableCmd)
+   {fTelemetry->SetEnabled(fEnableCmd->GetNewBoolValue(newValue));}
+   
+  if (command == fFileCmd)
+   {fTelemetry->SetFileName(newValue);}
+   
+  if (command == fPeriodCmd)
+   {fTelemetry->SetPeriod(fPeriodCmd->GetNewDoubleValue(newValue));}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,119 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ThreadPolicy.cc
+/// \brief Implementation of the ThreadPolicy class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ThreadPolicy.hh"
+
+#include "G4Threading.hh"
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ThreadPolicy::GetNumberOfThreads(G4int requested)
+{
+  G4int nThreads = requested;
+  G4String origin = "command line";
+  if (nThreads <= 0) {
+    nThreads = GetEnvironmentThreads();
+    origin = "HADR04_NTHREADS";
+  }
+  if (nThreads <= 0) {
+    G4int quota = GetCgroupQuota();
+    G4int affinity = GetAffinityCount();
+    nThreads = G4Threading::G4GetNumberOfCores();
+    origin = "number of cores";
+    if (affinity > 0 && affinity < nThreads) {
+      nThreads = affinity;
+      origin = "CPU affinity";
+    }
+    if (quota > 0 && quota < nThreads) {
+      nThreads = quota;
+      origin = "cgroup CPU quota";
+    }
+  }
+  if (nThreads < 1) nThreads = 1;
+
+  G4cout << " ThreadPolicy: " << nThreads << " threads (" << origin << ")"
+         << G4endl;
+  return nThreads;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ThreadPolicy::GetEnvironmentThreads()
+{
+  const char* env = std::getenv("HADR04_NTHREADS");
+  return env ? std::atoi(env) : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ThreadPolicy::GetCgroupQuota()
+{
+  // the quota is rounded up: 2.5 CPUs give 3 threads
+  G4double quota = 0., period = 0.;
+
+  // cgroup v2: "max 100000" or "250000 100000"
+  std::ifstream v2("/sys/fs/cgroup/cpu.max");
+  std::string value;
+  if (v2 >> value >> period) {
+    if (value != "max") quota = std::atof(value.c_str());
+  } else {
+    // cgroup v1, quota -1 when unlimited
+    std::ifstream q1("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+    std::ifstream p1("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+    if (!(q1 >> quota) || !(p1 >> period)) quota = 0.;
+  }
+  if (quota <= 0. || period <= 0.) return 0;
+  return (G4int)std::ceil(quota/period);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ThreadPolicy::GetAffinityCount()
+{
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) return CPU_COUNT(&set);
+#endif
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
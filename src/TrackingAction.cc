@@ -33,6 +33,8 @@
 #include "TrackingAction.hh"
 
 #include "Run.hh"
+#include "EventAction.hh"
+#include "Watchdog.hh"
 #include "HistoManager.hh"
 
 #include "G4RunManager.hh"
@@ -41,8 +43,8 @@
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-TrackingAction::TrackingAction()
-:G4UserTrackingAction(),
+TrackingAction::TrackingAction(EventAction* event)
+:G4UserTrackingAction(), fEventAction(event), fTrackStart(0.),
  fNbStep1(0),fNbStep2(0),fTrackLen1(0.),fTrackLen2(0.),fTime1(0.),fTime2(0.)
 { }
 
@@ -53,6 +55,8 @@ void TrackingAction::PreUserTrackingAction(const G4Track*)
   fNbStep1 = fNbStep2 = 0;
   fTrackLen1 = fTrackLen2 = 0.;
   fTime1 = fTime2 = 0.;
+  fTrackStart = Run::WallClock();
+  Watchdog::Instance()->BeginOfTrack();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -72,6 +76,10 @@ void TrackingAction::UpdateTrackInfo(G4double ekin,G4double trackl,
 
 void TrackingAction::PostUserTrackingAction(const G4Track* track)
 {
+ // tracking time, by particle
+ fEventAction->AddTrackTime(track->GetDefinition(), 
+                            Run::WallClock() - fTrackStart);
+ 
  // keep only primary neutron
  //
  G4int trackID = track->GetTrackID();
@@ -0,0 +1,196 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Watchdog.cc
+/// \brief Implementation of the Watchdog class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "Watchdog.hh"
+#include "WatchdogMessenger.hh"
+#include "RandomStreams.hh"
+#include "Run.hh"
+
+#include "G4RunManager.hh"
+#include "G4Event.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4LogicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Threading.hh"
+
+#include <ctime>
+#include <sstream>
+
+namespace {
+  const char* kBreachNames[Watchdog::kNbBreaches] = 
+    { "none", "track steps", "track time", "event steps", "event time" };
+  
+  // counters of the current track and event of this thread
+  struct ThreadCounters {
+    ThreadCounters() 
+      : fTrackSteps(0), fEventSteps(0), fTrackStart(0.), fEventStart(0.),
+        fEventBreach(Watchdog::kNone), fEventLogged(false) {}
+    G4long   fTrackSteps, fEventSteps;
+    G4double fTrackStart, fEventStart;   // thread CPU time, in s
+    G4int    fEventBreach;
+    G4bool   fEventLogged;
+  };
+  G4ThreadLocal ThreadCounters* counters = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Watchdog* Watchdog::Instance()
+{
+  static Watchdog instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Watchdog::Watchdog()
+: fMaxTrackSteps(0), fMaxEventSteps(0), fMaxTrackTime(0.), fMaxEventTime(0.),
+  fMessenger(0)
+{
+  fMessenger = new WatchdogMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Watchdog::~Watchdog()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const char* Watchdog::GetBreachName(G4int breach)
+{
+  return (breach >= 0 && breach < kNbBreaches) ? kBreachNames[breach] : "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double Watchdog::ThreadCpuTime()
+{
+  timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return now.tv_sec + 1.e-9*now.tv_nsec;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Watchdog::BeginOfEvent()
+{
+  if (!IsActive()) return;
+  if (!counters) counters = new ThreadCounters;
+  counters->fEventSteps = 0;
+  counters->fEventBreach = kNone;
+  counters->fEventLogged = false;
+  if (HasTimeLimit()) counters->fEventStart = ThreadCpuTime();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Watchdog::BeginOfTrack()
+{
+  if (!IsActive() || !counters) return;
+  counters->fTrackSteps = 0;
+  if (fMaxTrackTime > 0.) counters->fTrackStart = ThreadCpuTime();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Watchdog::Check(const G4Step* step)
+{
+  if (!IsActive() || !counters) return;
+  ThreadCounters& count = *counters;
+  count.fTrackSteps++;
+  count.fEventSteps++;
+  
+  G4int breach = count.fEventBreach;
+  G4double now = 0.;
+  if (breach == kNone) {
+    if (fMaxTrackSteps > 0 && count.fTrackSteps > fMaxTrackSteps) {
+      breach = kTrackSteps;
+    }
+    else if (fMaxEventSteps > 0 && count.fEventSteps > fMaxEventSteps) {
+      breach = kEventSteps;
+    }
+    else if (HasTimeLimit() && count.fEventSteps % kTimeCheckPeriod == 0) {
+      now = ThreadCpuTime();
+      if (fMaxTrackTime > 0. && now - count.fTrackStart > fMaxTrackTime) {
+        breach = kTrackTime;
+      }
+      else if (fMaxEventTime > 0. && now - count.fEventStart > fMaxEventTime) {
+        breach = kEventTime;
+      }
+    }
+    if (breach == kNone) return;
+  }
+  
+  // the rest of an event over its budget is killed
+  G4Track* track = step->GetTrack();
+  G4bool eventBreach = (breach == kEventSteps || breach == kEventTime);
+  track->SetTrackStatus(eventBreach ? fKillTrackAndSecondaries : fStopAndKill);
+  
+  G4RunManager* runManager = G4RunManager::GetRunManager();
+  Run* run = static_cast<Run*>(runManager->GetNonConstCurrentRun());
+  run->AddKilledTrack(breach, track->GetWeight());
+  if (eventBreach) count.fEventBreach = breach;
+  if (count.fEventLogged) return;
+  count.fEventLogged = true;
+  
+  // log the breach, with what to replay
+  Run::EventCost cost;
+  cost.fEventID = runManager->GetCurrentEvent()->GetEventID();
+  cost.fThread  = G4Threading::G4GetThreadId();
+  RandomStreams* streams = RandomStreams::Instance();
+  if (streams->IsCounterBased()) {
+    cost.fStream = (G4long)streams->GetStreamIndex(cost.fEventID);
+  }
+  if (HasTimeLimit()) {
+    if (now == 0.) now = ThreadCpuTime();
+    cost.fTime = now - count.fEventStart;
+  }
+  cost.fNbSteps = count.fEventSteps;
+  std::ostringstream where;
+  where << kBreachNames[breach] << ": " 
+        << track->GetDefinition()->GetParticleName() << " (track " 
+        << track->GetTrackID() << ", " << count.fTrackSteps << " steps) in "
+        << step->GetPreStepPoint()->GetTouchableHandle()->GetVolume()
+                                  ->GetLogicalVolume()->GetName();
+  cost.fWhere = where.str();
+  run->AddWatchdogEvent(cost);
+  
+  G4cout << "### Watchdog: event " << cost.fEventID;
+  if (cost.fStream >= 0) G4cout << " (stream " << cost.fStream << ")";
+  G4cout << " over the " << cost.fWhere << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
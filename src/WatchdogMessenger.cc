@@ -0,0 +1,112 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file WatchdogMessenger.cc
+/// \brief Implementation of the WatchdogMessenger class
+//
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "WatchdogMessenger.hh"
+
+#include "Watchdog.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+WatchdogMessenger::WatchdogMessenger(Watchdog* watchdog)
+:G4UImessenger(),fWatchdog(watchdog),
+ fWatchdogDir(0), fTrackStepsCmd(0), fEventStepsCmd(0), fTrackTimeCmd(0),
+ fEventTimeCmd(0)
+{ 
+  G4bool broadcast = false;
+  fWatchdogDir = new G4UIdirectory("/testhadr/watchdog/",broadcast);
+  fWatchdogDir->SetGuidance("budgets of steps and CPU time; 0 for no limit");
+  
+  fTrackStepsCmd = 
+    new G4UIcmdWithAnInteger("/testhadr/watchdog/maxTrackSteps",this);
+  fTrackStepsCmd->SetGuidance("kill a track after n steps");
+  fTrackStepsCmd->SetParameterName("n",false);
+  fTrackStepsCmd->SetRange("n>=0");
+  fTrackStepsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fTrackStepsCmd->SetToBeBroadcasted(false);
+  
+  fEventStepsCmd = 
+    new G4UIcmdWithAnInteger("/testhadr/watchdog/maxEventSteps",this);
+  fEventStepsCmd->SetGuidance("kill the rest of an event after n steps");
+  fEventStepsCmd->SetParameterName("n",false);
+  fEventStepsCmd->SetRange("n>=0");
+  fEventStepsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fEventStepsCmd->SetToBeBroadcasted(false);
+  
+  fTrackTimeCmd = new G4UIcmdWithADouble("/testhadr/watchdog/maxTrackTime",this);
+  fTrackTimeCmd->SetGuidance("kill a track after t seconds of CPU time");
+  fTrackTimeCmd->SetParameterName("t",false);
+  fTrackTimeCmd->SetRange("t>=0.");
+  fTrackTimeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fTrackTimeCmd->SetToBeBroadcasted(false);
+  
+  fEventTimeCmd = new G4UIcmdWithADouble("/testhadr/watchdog/maxEventTime",this);
+  fEventTimeCmd->SetGuidance("kill the rest of an event after t seconds");
+  fEventTimeCmd->SetGuidance("  of CPU time");
+  fEventTimeCmd->SetParameterName("t",false);
+  fEventTimeCmd->SetRange("t>=0.");
+  fEventTimeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fEventTimeCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+WatchdogMessenger::~WatchdogMessenger()
+{
+  delete fTrackStepsCmd;
+  delete fEventStepsCmd;
+  delete fTrackTimeCmd;
+  delete fEventTimeCmd;
+  delete fWatchdogDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void WatchdogMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{   
+  if (command == fTrackStepsCmd)
+   {fWatchdog->SetMaxTrackSteps(fTrackStepsCmd->GetNewIntValue(newValue));}
+   
+  if (command == fEventStepsCmd)
+   {fWatchdog->SetMaxEventSteps(fEventStepsCmd->GetNewIntValue(newValue));}
+   
+  if (command == fTrackTimeCmd)
+   {fWatchdog->SetMaxTrackTime(fTrackTimeCmd->GetNewDoubleValue(newValue));}
+   
+  if (command == fEventTimeCmd)
+   {fWatchdog->SetMaxEventTime(fEventTimeCmd->GetNewDoubleValue(newValue));}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,32 @@
+#!/bin/sh
+#
+# Cost/accuracy tradeoff of the thermal scattering model:
+#   free   : free gas everywhere
+#   region : S(alpha,beta) in ShieldRegion only (default physics)
+#   global : S(alpha,beta) in every TS_ material
+# The CPU time of the run and the main tallies of each mode are printed;
+# histograms are kept in tsbench_<mode>.root for a detailed comparison.
+#
+# usage: ./tsbench.sh [nevents]
+#
+NEVENTS=${1:-2000}
+export NEVENTS
+
+for mode in free region global
+do
+  case $mode in
+    free)   TS_ON=false; TS_REGION=all ;;
+    region) TS_ON=true;  TS_REGION=ShieldRegion ;;
+    global) TS_ON=true;  TS_REGION=all ;;
+  esac
+  export TS_ON TS_REGION
+
+  ./Hadr04 tsbench.mac > tsbench_$mode.out 2>&1
+  [ -f tsbench.root ] && mv tsbench.root tsbench_$mode.root
+
+  echo "==== $mode"
+  grep "User=" tsbench_$mode.out | tail -1
+  grep -A1 "Process calls frequency" tsbench_$mode.out | tail -1
+  grep "nb of collisions" tsbench_$mode.out | tail -1
+  grep "time of flight" tsbench_$mode.out | tail -1
+done